@@ -99,6 +99,22 @@ else
 	SETTINGS			+= inline-spinlocks
 endif
 
+##################
+# Lock profiling #
+ifneq (,$(findstring lock-profiling,$(MAKECMDGOALS)))
+	PRECOMPILER_FLAGS	+= __BEELZEBUB_SETTINGS_LOCK_PROFILING 
+
+	SETTINGS			+= lock-profiling
+endif
+
+#####################
+# Kernel preemption #
+ifneq (,$(findstring kernel-preemption,$(MAKECMDGOALS)))
+	PRECOMPILER_FLAGS	+= __BEELZEBUB_SETTINGS_KERNEL_PREEMPTION 
+
+	SETTINGS			+= kernel-preemption
+endif
+
 #################
 # No Unit Tests #
 ifneq (,$(findstring no-unit-tests,$(MAKECMDGOALS)))
@@ -140,6 +156,16 @@ ifneq (,$(findstring test-all,$(MAKECMDGOALS)))
 	PRECOMPILER_FLAGS	+= __BEELZEBUB__TEST_RW_SPINLOCK 
 	PRECOMPILER_FLAGS	+= __BEELZEBUB__TEST_VAS 
 	PRECOMPILER_FLAGS	+= __BEELZEBUB__TEST_INTERRUPT_LATENCY 
+	PRECOMPILER_FLAGS	+= __BEELZEBUB__TEST_LOCK_SCALING 
+	PRECOMPILER_FLAGS	+= __BEELZEBUB__TEST_MUTEX 
+	PRECOMPILER_FLAGS	+= __BEELZEBUB__TEST_QUEUES 
+	PRECOMPILER_FLAGS	+= __BEELZEBUB__TEST_SEQLOCK 
+	PRECOMPILER_FLAGS	+= __BEELZEBUB__TEST_PREEMPTION 
+	PRECOMPILER_FLAGS	+= __BEELZEBUB__TEST_SCHEDULER 
+	PRECOMPILER_FLAGS	+= __BEELZEBUB__TEST_TIMERS 
+	PRECOMPILER_FLAGS	+= __BEELZEBUB__TEST_CROSS_CPU 
+	PRECOMPILER_FLAGS	+= __BEELZEBUB__TEST_DEFERRED_WORK 
+	PRECOMPILER_FLAGS	+= __BEELZEBUB__TEST_TOPOLOGY 
 
 	SETTINGS			+= test-all
 else
@@ -238,6 +264,66 @@ else
 
 		SETTINGS			+= test-interrupt-latency 
 	endif
+
+	ifneq (,$(findstring test-lock-scaling,$(MAKECMDGOALS)))
+		PRECOMPILER_FLAGS	+= __BEELZEBUB__TEST_LOCK_SCALING 
+
+		SETTINGS			+= test-lock-scaling 
+	endif
+
+	ifneq (,$(findstring test-mutex,$(MAKECMDGOALS)))
+		PRECOMPILER_FLAGS	+= __BEELZEBUB__TEST_MUTEX 
+
+		SETTINGS			+= test-mutex 
+	endif
+
+	ifneq (,$(findstring test-queues,$(MAKECMDGOALS)))
+		PRECOMPILER_FLAGS	+= __BEELZEBUB__TEST_QUEUES 
+
+		SETTINGS			+= test-queues 
+	endif
+
+	ifneq (,$(findstring test-seqlock,$(MAKECMDGOALS)))
+		PRECOMPILER_FLAGS	+= __BEELZEBUB__TEST_SEQLOCK 
+
+		SETTINGS			+= test-seqlock 
+	endif
+
+	ifneq (,$(findstring test-preemption,$(MAKECMDGOALS)))
+		PRECOMPILER_FLAGS	+= __BEELZEBUB__TEST_PREEMPTION 
+
+		SETTINGS			+= test-preemption 
+	endif
+
+	ifneq (,$(findstring test-scheduler,$(MAKECMDGOALS)))
+		PRECOMPILER_FLAGS	+= __BEELZEBUB__TEST_SCHEDULER 
+
+		SETTINGS			+= test-scheduler 
+	endif
+
+	ifneq (,$(findstring test-timers,$(MAKECMDGOALS)))
+		PRECOMPILER_FLAGS	+= __BEELZEBUB__TEST_TIMERS 
+
+		SETTINGS			+= test-timers 
+	endif
+
+	ifneq (,$(findstring test-cross-cpu,$(MAKECMDGOALS)))
+		PRECOMPILER_FLAGS	+= __BEELZEBUB__TEST_CROSS_CPU 
+
+		SETTINGS			+= test-cross-cpu 
+	endif
+
+	ifneq (,$(findstring test-deferred-work,$(MAKECMDGOALS)))
+		PRECOMPILER_FLAGS	+= __BEELZEBUB__TEST_DEFERRED_WORK 
+
+		SETTINGS			+= test-deferred-work 
+	endif
+
+	ifneq (,$(findstring test-topology,$(MAKECMDGOALS)))
+		PRECOMPILER_FLAGS	+= __BEELZEBUB__TEST_TOPOLOGY 
+
+		SETTINGS			+= test-topology 
+	endif
 endif
 
 ####################################### PRECOMPILER FLAGS ##########
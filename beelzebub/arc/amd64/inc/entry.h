@@ -88,6 +88,7 @@ __extern __startup Handle InitializeVirtualMemory();
 __extern __startup Handle InitializeAcpiTables();
 
 __extern __startup Handle InitializeApic();
+__extern __startup Handle InitializeTimers();
 
 __extern __startup Handle InitializeProcessingUnits();
 
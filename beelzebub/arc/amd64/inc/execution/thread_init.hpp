@@ -46,4 +46,5 @@ namespace Beelzebub { namespace Execution
     void InitializeThreadState(Thread * const thread);
 
     __startup Handle InitializeBootstrapThread(Thread * const bst, Process * const bsp);
+    __startup Handle InitializeSecondaryThread(Thread * const thread, Process * const proc);
 }}
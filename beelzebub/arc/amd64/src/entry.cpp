@@ -39,6 +39,7 @@
 
 #include <system/cpuid.hpp>
 #include <execution/thread_init.hpp>
+#include <execution/scheduler.hpp>
 #include <terminals/vbe.hpp>
 
 #include <memory/vmm.hpp>
@@ -48,6 +49,7 @@
 #if   defined(__BEELZEBUB_SETTINGS_SMP)
     #include <memory/object_allocator_smp.hpp>
     #include <memory/object_allocator_pools_heap.hpp>
+    #include <memory/object_allocator_registry.hpp>
 #endif
 
 #include <keyboard.hpp>
@@ -63,6 +65,7 @@
 #include <global_options.hpp>
 
 #include <synchronization/atomic.hpp>
+#include <synchronization/rcu.hpp>
 #include <math.h>
 #include <string.h>
 
@@ -479,6 +482,8 @@ Handle InitializeVirtualMemory()
 #if   defined(__BEELZEBUB_SETTINGS_SMP)
     new (&CpuDataAllocator) ObjectAllocatorSmp(sizeof(CpuData), __alignof(CpuData)
         , &AcquirePoolInKernelHeap, &EnlargePoolInKernelHeap, &ReleasePoolFromKernelHeap);
+
+    ObjectAllocatorRegistry::Register("CPU Data", CpuDataAllocator);
 #endif
 
     InitializeCpuData(true);
@@ -696,6 +701,25 @@ void InitializeCpuData(bool const bsp)
 
     data->LastExtendedStateThread = nullptr;
 
+    new (&data->Topology) CpuTopology();
+    //  Filled in once the CPU is initialized.
+
+    new (&data->SchedulerQueue) RunQueue();
+    //  The scheduler takes over this CPU once it has a thread.
+
+    new (&data->Timers) TimerWheel();
+
+    data->SoftIrqPending = 0;
+    data->SoftIrqActive = false;
+    data->Tasklets = nullptr;
+    new (&data->Work) WorkQueue();
+
+#if   defined(__BEELZEBUB_SETTINGS_SMP)
+    new (&data->CallQueue) MpscRing<CrossCpuCall *, CrossCpu::QueueCapacity>();
+#endif
+
+    Rcu::InitializeCpu();
+
     InitializeCpuStacks(bsp);
 
     //msg("-- Core #%us @ %Xp. --%n", ind, data);
@@ -759,6 +783,30 @@ void InitializeCpuStacks(bool const bsp)
     }
 
     cpuData->EmbeddedTss.Ist[1] = vaddr + PageSize + PageFaultStackSize;
+
+    //  And the NMI stack.
+
+    vaddr = Vmm::KernelHeapCursor.FetchAdd(NmiStackSize + PageSize);
+
+    for (size_t offset = PageSize; offset <= NmiStackSize; offset += PageSize)
+    {
+        paddr_t const paddr = mainAllocator.AllocatePage(desc);
+        //  Stack page.
+
+        ASSERT(paddr != nullpaddr && desc != nullptr
+            , "Unable to allocate a physical page #%us for NMI stack of CPU #%us!"
+            , offset / PageSize - 1, cpuData->Index);
+
+        res = Vmm::MapPage(&BootstrapProcess, vaddr + offset, paddr
+            , MemoryFlags::Global | MemoryFlags::Writable, desc);
+
+        ASSERT(res.IsOkayResult()
+            , "Failed to map page at %Xp (%XP) for NMI stack of CPU #%us: %H."
+            , vaddr + offset, paddr, cpuData->Index
+            , res);
+    }
+
+    cpuData->EmbeddedTss.Ist[2] = vaddr + PageSize + NmiStackSize;
 }
 
 #ifdef __BEELZEBUB__TEST_MT
@@ -876,20 +924,13 @@ void StartMultitaskingTest()
     InitializeTestThread(&tTb3, &tPb);
     //  Initialize thread series B under their own process.
 
-    withInterrupts (false)
-    {
-        // BootstrapThread.IntroduceNext(&tTb3);
-        BootstrapThread.IntroduceNext(&tTb2);
-        //  Threads B2 and B3 are at the end of the cycle.
-
-        BootstrapThread.IntroduceNext(&tTa3);
-        BootstrapThread.IntroduceNext(&tTb1);
-        //  Threads B1 and A3 are intertwined.
-
-        BootstrapThread.IntroduceNext(&tTa2);
-        BootstrapThread.IntroduceNext(&tTa1);
-        //  Threads A1 and A2 are at the start, right after the bootstrap thread.
-    }
+    Scheduler::Enqueue(&tTa1);
+    Scheduler::Enqueue(&tTa2);
+    Scheduler::Enqueue(&tTb1);
+    Scheduler::Enqueue(&tTa3);
+    Scheduler::Enqueue(&tTb2);
+    // Scheduler::Enqueue(&tTb3);
+    //  Threads of both series are intertwined, and spread over the CPUs.
 
     #ifdef __BEELZEBUB__TEST_APP
     if (CHECK_TEST(APP))
@@ -39,6 +39,7 @@
 
 #include <execution/thread_init.hpp>
 #include <system/cpu.hpp>
+#include <kernel.hpp>
 #include <math.h>
 #include <debug.hpp>
 #include <_print/isr.hpp>
@@ -102,7 +103,21 @@ Handle Beelzebub::Execution::InitializeBootstrapThread(Thread * const bst, Proce
     bst->KernelStackBottom = 0xFFFFFFFFFFFFC000U;//RoundDown((uintptr_t)&dummy, PageSize);
     bst->KernelStackTop = 0xFFFFFFFFFFFFF000U;//RoundUp((uintptr_t)&dummy, PageSize);
 
-    bst->Next = bst->Previous = bst;
+    bst->Running = true;
+
+    return HandleResult::Okay;
+}
+
+Handle Beelzebub::Execution::InitializeSecondaryThread(Thread * const thread, Process * const proc)
+{
+    new (thread) Thread(proc);
+
+    thread->KernelStackTop = RoundUp((uintptr_t)__builtin_frame_address(0), PageSize);
+    thread->KernelStackBottom = thread->KernelStackTop - CpuStackSize;
+    //  The stack of a secondary CPU is aligned to a page, and this is called
+    //  only a couple of frames away from its top.
+
+    thread->Running = true;
 
     return HandleResult::Okay;
 }
@@ -40,12 +40,14 @@
 #include <execution/thread.hpp>
 #include <system/cpu.hpp>
 #include <system/fpu.hpp>
+#include <synchronization/rcu.hpp>
 
 #include <string.h>
 #include <debug.hpp>
 
 using namespace Beelzebub;
 using namespace Beelzebub::Execution;
+using namespace Beelzebub::Synchronization;
 using namespace Beelzebub::System;
 
 /******************
@@ -88,6 +90,17 @@ Handle Thread::SwitchTo(Thread * const other, ThreadState * const dest)
     auto cpuData = Cpu::GetData();
 
     cpuData->ActiveThread = other;
+    this->Running = false;
+    other->Running = true;
+
+#ifdef __BEELZEBUB_SETTINGS_KERNEL_PREEMPTION
+    this->PreemptCount = cpuData->PreemptCount - 1;
+    cpuData->PreemptCount = other->PreemptCount + 1;
+    //  The interrupt guard of this function counts towards neither thread.
+#endif
+
+    Rcu::ReportQuiescentState();
+    //  No read-side critical section can span a thread switch.
     cpuData->ActiveProcess = otherProc;
     cpuData->EmbeddedTss.Rsp[0] = other->KernelStackTop;
     cpuData->SyscallStack = other->KernelStackTop;
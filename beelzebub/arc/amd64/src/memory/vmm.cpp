@@ -40,6 +40,7 @@
 #include <memory/vmm.hpp>
 #include <memory/vmm.arc.hpp>
 #include <memory/object_allocator_pools_heap.hpp>
+#include <memory/shrinkers.hpp>
 #include <synchronization/spinlock_uninterruptible.hpp>
 #include <system/cpu.hpp>
 #include <system/interrupts.hpp>
@@ -695,7 +696,9 @@ Handle Vmm::HandlePageFault(Execution::Process * proc
 
     vaddr_t const vaddr_algn = RoundDown(vaddr, PageSize);
     MemoryRegion * reg;
+    bool shrunk = false;
 
+retry:
     vas->Lock.AcquireAsReader();
 
 #define RETURN(HRES) do { res = HandleResult::HRES; goto end; } while (false)
@@ -743,9 +746,22 @@ Handle Vmm::HandlePageFault(Execution::Process * proc
     paddr = alloc->AllocatePage(desc);
 
     if unlikely(paddr == nullpaddr)
-        RETURN(OutOfMemory);
-    //  Okay... Out of memory... Bad.
-    //  TODO: Handle this.
+    {
+        if (shrunk)
+            RETURN(OutOfMemory);
+        //  Okay... Still out of memory... Bad.
+
+        vas->Lock.ReleaseAsReader();
+        shrunk = true;
+
+        if (Shrinkers::Shrink(1) == 0)
+            return HandleResult::OutOfMemory;
+        //  Out of memory... The shrinkers may be able to give some back, but
+        //  they unmap pages, so they must not run under the VAS lock.
+
+        goto retry;
+        //  The region may have changed meanwhile, so it is looked up again.
+    }
 
     res = Vmm::MapPage(proc, vaddr_algn, paddr, reg->Flags, desc);
 
@@ -850,27 +866,50 @@ Handle Vmm::AllocatePages(Process * proc, size_t const count
         if likely(CpuDataSetUp)
             alloc = Cpu::GetData()->DomainDescriptor->PhysicalAllocator;
 
+        if unlikely(alloc->IsUnderPressure(count))
+            Shrinkers::Shrink(count);
+        //  This must happen before the heap lock is taken, because the
+        //  shrinkers unmap pages from the heap.
+
         size_t const size = count * PageSize;
-        bool allocSucceeded = true;
+        bool allocSucceeded = true, shrunk = false;
 
-        LockGuard<Spinlock<> > heapLg {*heapLock};
-        //  Note: this ain't flexible because heapLock ain't gonna be null.
+        heapLock->Acquire();
+        //  Interrupts are already off, and the lock is dropped while shrinking.
 
-        size_t offset;
-        for (offset = 0; offset < size; offset += PageSize)
+        size_t offset = 0;
+        while (offset < size)
         {
             paddr_t const paddr = alloc->AllocatePage(desc);
 
-            if unlikely(paddr == nullpaddr) { allocSucceeded = false; break; }
+            if unlikely(paddr == nullpaddr)
+            {
+                if (shrunk) { allocSucceeded = false; break; }
+
+                heapLock->Release();
+                shrunk = true;
+
+                Shrinkers::Shrink((size - offset) / PageSize);
+                //  Same as above, the shrinkers cannot run under the heap lock.
+                //  They get one chance to cover the remaining pages.
+
+                heapLock->Acquire();
+
+                continue;
+            }
 
             res = Vmm::MapPage(proc, ret + lowerOffset + offset, paddr
                 , flags, desc, false);
 
             if unlikely(!res.IsOkayResult()) { allocSucceeded = false; break; }
+
+            offset += PageSize;
         }
 
         if likely(allocSucceeded)
         {
+            heapLock->Release();
+
             if likely(0 != (type & MemoryAllocationOptions::VirtualUser))
                 withWriteProtect (false)
                     memset(reinterpret_cast<void *>(vaddr), 0xCA, size);
@@ -879,18 +918,24 @@ Handle Vmm::AllocatePages(Process * proc, size_t const count
         }
         else
         {
-            //  So, the allocation failed. Now all the pages that were allocated
+            //  So, the allocation failed. Now all the pages that were mapped
             //  need to be unmapped.
 
-            do
+            while (offset > 0)
             {
+                offset -= PageSize;
+
                 res = Vmm::UnmapPage(proc, ret + lowerOffset + offset, false);
 
                 if unlikely(!res.IsOkayResult() && !res.IsResult(HandleResult::PageUnmapped))
+                {
+                    heapLock->Release();
+
                     return res;
+                }
+            }
 
-                offset -= PageSize;
-            } while (offset > 0);
+            heapLock->Release();
 
             return HandleResult::OutOfMemory;
         }
@@ -50,6 +50,12 @@ global IsrStubsEnd
 global IsrCommonStub
 global IsrFullStub
 
+extern SoftIrqOnInterruptReturn
+
+%ifdef __BEELZEBUB_SETTINGS_KERNEL_PREEMPTION
+extern PreemptOnInterruptReturn
+%endif
+
 ;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
 
 section .text
@@ -102,6 +108,9 @@ IsrFullStub:
     mov     rdi, rsp
     ;   Stack pointer as first parameter (IsrState *)
 
+    mov     ebx, ecx
+    ;   The vector is needed after the call, and RBX is preserved by it.
+
     mov     rax, [rsp + 0x90]
     cmp     al, byte 0x8 
     je      .skip_swap_1
@@ -125,6 +134,24 @@ IsrFullStub:
     call    rdx
     ;   Call handler. Preserves RBP by convention.
 
+    cmp     ebx, 32
+    jb      .skip_hooks
+    ;   Exceptions skip the hooks below. They may be running on an IST stack,
+    ;   which a nested exception would overwrite once bottom halves enable
+    ;   interrupts, and NMIs may even arrive before the kernel's GS is loaded.
+
+    mov     rdi, [rsp + 0x98]
+    call    SoftIrqOnInterruptReturn
+    ;   May run bottom halves with interrupts enabled, given the old RFLAGS.
+
+%ifdef __BEELZEBUB_SETTINGS_KERNEL_PREEMPTION
+    mov     rdi, rsp
+    call    PreemptOnInterruptReturn
+    ;   May switch threads by replacing the state on the stack. Only this stub
+    ;   has the whole state, and GS is still the kernel's here.
+%endif
+
+.skip_hooks:
     mov     rax, [rsp + 0x90]
     cmp     al, byte 0x8 
     je      .skip_swap_2
@@ -281,6 +308,9 @@ IsrCommonStub:
     mov     ebp, 0
     ;   The base pointer has to be 0, so the interrupt handler's stack frames do
     ;   not link to the userland frames.
+
+    push    rcx
+    ;   The vector is needed after the call. This also aligns the stack.
     
     ;   At this point, the arguments given are the following:
     ;   1. RDI = State pointer
@@ -290,6 +320,17 @@ IsrCommonStub:
     call    rdx
     ;   Call handler. Preserves RBP by convention.
 
+    pop     rcx
+
+    cmp     ecx, 32
+    jb      .skip_hooks
+    ;   Same as above, exceptions skip the hook.
+
+    mov     rdi, [rsp + 0x70]
+    call    SoftIrqOnInterruptReturn
+    ;   Same as above. It preserves the registers which were not saved.
+
+.skip_hooks:
     mov     rax, [rsp + 0x68]
     cmp     al, byte 0x8 
     je      .skip_swap_2
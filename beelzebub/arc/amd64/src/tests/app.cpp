@@ -44,6 +44,7 @@
 #include <execution/runtime64.hpp>
 #include <execution/thread.hpp>
 #include <execution/thread_init.hpp>
+#include <execution/scheduler.hpp>
 #include <execution/ring_3.hpp>
 #include <memory/vmm.hpp>
 
@@ -142,8 +143,7 @@ void TestApplication()
     InitializeThreadState(&testThread);
     //  This sets up the thread so it goes directly to the entry point when switched to.
 
-    withInterrupts (false)
-        BootstrapThread.IntroduceNext(&testThread);
+    Scheduler::Enqueue(&testThread);
 
     // DEBUG_TERM_ << "Initialized app test main thread." << Terminals::EndLine;
 
@@ -170,8 +170,7 @@ void TestApplication()
     InitializeThreadState(&testWatcher);
     //  This sets up the thread so it goes directly to the entry point when switched to.
 
-    withInterrupts (false)
-        testThread.IntroduceNext(&testWatcher);
+    Scheduler::Enqueue(&testWatcher);
 
     // DEBUG_TERM_ << "Initialized app test watcher thread." << Terminals::EndLine;
 
@@ -0,0 +1,185 @@
+/*
+    Copyright (c) 2015 Alexandru-Mihai Maftei. All rights reserved.
+
+
+    Developed by: Alexandru-Mihai Maftei
+    aka Vercas
+    http://vercas.com | https://github.com/vercas/Beelzebub
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal with the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+      * Redistributions of source code must retain the above copyright notice,
+        this list of conditions and the following disclaimers.
+      * Redistributions in binary form must reproduce the above copyright
+        notice, this list of conditions and the following disclaimers in the
+        documentation and/or other materials provided with the distribution.
+      * Neither the names of Alexandru-Mihai Maftei, Vercas, nor the names of
+        its contributors may be used to endorse or promote products derived from
+        this Software without specific prior written permission.
+
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+    WITH THE SOFTWARE.
+
+    ---
+
+    You may also find the text of this license in "LICENSE.md", along with a more
+    thorough explanation regarding other files.
+*/
+
+/**
+ *  Kernel preemption is only built in when the `kernel-preemption` setting is
+ *  enabled. The timer then never switches threads directly; it marks the CPU
+ *  as needing to reschedule, and the switch happens on the way out of the
+ *  interrupt.
+ *
+ *  Spinlocks and interrupt guards disable preemption by incrementing a
+ *  per-CPU count. While it is non-zero, the switch is deferred until the
+ *  count drops back to zero, when the outermost lock is released.
+ *
+ *  The count belongs to the thread, so it is saved and restored by thread
+ *  switches. Without the setting, all of this compiles to nothing.
+ */
+
+#pragma once
+
+#include <system/cpu_instructions.hpp>
+#include <beel/structs.kernel.hpp>
+
+#ifdef __BEELZEBUB_SETTINGS_KERNEL_PREEMPTION
+#define PREEMPTION_DISABLE() Beelzebub::Execution::Preemption::Disable()
+#define PREEMPTION_ENABLE()  Beelzebub::Execution::Preemption::Enable()
+#else
+#define PREEMPTION_DISABLE() do { } while (false)
+#define PREEMPTION_ENABLE()  do { } while (false)
+#endif
+
+namespace Beelzebub
+{
+    extern bool CpuDataSetUp;
+    //  Declared again here because <kernel.hpp> includes the spinlocks.
+}
+
+namespace Beelzebub { namespace System
+{
+    struct IsrState;
+}}
+
+namespace Beelzebub { namespace Execution
+{
+    /**
+     *  <summary>Defers thread switches out of critical sections.</summary>
+     */
+    class Preemption
+    {
+    public:
+        /*  Constructor(s)  */
+
+        Preemption() = delete;
+        Preemption(Preemption const &) = delete;
+        Preemption & operator =(Preemption const &) = delete;
+
+#ifdef __BEELZEBUB_SETTINGS_KERNEL_PREEMPTION
+        /*  Per-CPU State  */
+
+        static constexpr uintptr_t const CountOffset = offsetof(CpuDataBase, PreemptCount);
+        static constexpr uintptr_t const FlagOffset = offsetof(CpuDataBase, NeedReschedule);
+
+        /*  Operations  */
+
+        /**
+         *  <summary>Prevents the current thread from being switched out.</summary>
+         */
+        static __forceinline void Disable()
+        {
+            if likely(CpuDataSetUp)
+                System::CpuInstructions::GsIncrementSize(CountOffset);
+        }
+
+        /**
+         *  <summary>
+         *  Undoes one call to <see cref="Disable"/>, switching threads if a
+         *  reschedule was requested in the meantime.
+         *  </summary>
+         */
+        static __forceinline void Enable()
+        {
+            if likely(CpuDataSetUp)
+                if (System::CpuInstructions::GsDecrementSize(CountOffset)
+                    && unlikely(0 != System::CpuInstructions::GsGet8(FlagOffset)))
+                    Preempt();
+        }
+
+        /**
+         *  <summary>
+         *  A voluntary preemption point for long-running kernel code, which
+         *  switches threads if a reschedule was requested and preemption is
+         *  enabled.
+         *  </summary>
+         */
+        static __forceinline void Point()
+        {
+            if likely(CpuDataSetUp)
+                if unlikely(0 != System::CpuInstructions::GsGet8(FlagOffset))
+                    Preempt();
+        }
+
+        /**
+         *  <summary>Asks for the current CPU to switch threads soon.</summary>
+         */
+        static __forceinline void RequestReschedule()
+        {
+            System::CpuInstructions::GsSet8(FlagOffset, 1);
+        }
+
+        /**
+         *  <summary>Gets the preemption count of the current CPU.</summary>
+         */
+        static __forceinline size_t GetCount()
+        {
+            return System::CpuInstructions::GsGetSize(CountOffset);
+        }
+
+        /**
+         *  <summary>
+         *  Clears the preemption state of the current CPU; to be called once
+         *  by each CPU, outside of any critical section, before scheduling.
+         *  </summary>
+         */
+        static void InitializeCpu();
+
+        /**
+         *  <summary>
+         *  Switches threads if a reschedule was requested, preemption is
+         *  enabled and interrupts are enabled.
+         *  </summary>
+         */
+        static __cold __noinline void Preempt();
+#else
+        static __forceinline void Disable() { }
+        static __forceinline void Enable() { }
+        static __forceinline void Point() { }
+        static __forceinline void InitializeCpu() { }
+#endif
+    };
+}}
+
+#ifdef __BEELZEBUB_SETTINGS_KERNEL_PREEMPTION
+/**
+ *  <summary>
+ *  Called by the common interrupt stub after the handler of an IRQ, with the
+ *  state to return to, which is replaced when threads are switched.
+ *  </summary>
+ */
+__extern __hot void PreemptOnInterruptReturn(Beelzebub::System::IsrState * const state);
+#endif
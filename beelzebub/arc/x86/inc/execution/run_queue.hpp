@@ -0,0 +1,138 @@
+/*
+    Copyright (c) 2015 Alexandru-Mihai Maftei. All rights reserved.
+
+
+    Developed by: Alexandru-Mihai Maftei
+    aka Vercas
+    http://vercas.com | https://github.com/vercas/Beelzebub
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal with the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+      * Redistributions of source code must retain the above copyright notice,
+        this list of conditions and the following disclaimers.
+      * Redistributions in binary form must reproduce the above copyright
+        notice, this list of conditions and the following disclaimers in the
+        documentation and/or other materials provided with the distribution.
+      * Neither the names of Alexandru-Mihai Maftei, Vercas, nor the names of
+        its contributors may be used to endorse or promote products derived from
+        this Software without specific prior written permission.
+
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+    WITH THE SOFTWARE.
+
+    ---
+
+    You may also find the text of this license in "LICENSE.md", along with a more
+    thorough explanation regarding other files.
+*/
+
+#pragma once
+
+#include <execution/thread.hpp>
+#include <synchronization/spinlock.hpp>
+#include <synchronization/atomic.hpp>
+
+namespace Beelzebub { namespace System
+{
+    struct CpuData;
+}}
+
+namespace Beelzebub { namespace Execution
+{
+    /**
+     *  The threads which are ready to run on a CPU, one FIFO list per priority.
+     *  Every operation requires the lock to be held with interrupts disabled.
+     */
+    struct RunQueue
+    {
+    public:
+
+        /*  Constructor(s)  */
+
+        inline RunQueue()
+            : Lock()
+            , Heads()
+            , Tails()
+            , Occupied(0)
+            , Length(0)
+            , Departed(nullptr)
+            , Idle(false)
+            , Polling(false)
+            , Cpu(nullptr)
+            , LapicId(0)
+            , Next(nullptr)
+            , SwitchCount(0)
+            , StealCount(0)
+            , WakeSignal(0)
+        {
+
+        }
+
+        RunQueue(RunQueue const &) = delete;
+        RunQueue & operator =(RunQueue const &) = delete;
+
+        /*  Operations  */
+
+        /**
+         *  Appends the given thread to the list of its priority.
+         */
+        void Push(Thread * const thread);
+
+        /**
+         *  Removes the first thread of the highest priority which is at least
+         *  as high as the given one, if any.
+         */
+        Thread * Pop(ThreadPriority const lowest);
+
+        /**
+         *  Removes the first thread which may be run by another CPU, if any.
+         */
+        Thread * PopStealable();
+
+        /*  Fields  */
+
+        Synchronization::Spinlock<> Lock;
+
+        Thread * Heads[ThreadPriorityCount];
+        Thread * Tails[ThreadPriorityCount];
+        uint32_t Occupied;      //  Bit N is set when priority N has threads.
+
+        size_t volatile Length; //  Excludes idle threads. Read without the lock.
+
+        Thread * Departed;
+        //  Switched out last. Its stack is in use until the CPU returns from
+        //  the interrupt, so no other CPU may run it before the next switch.
+
+        Synchronization::Atomic<bool> Idle;     //  Running the idle thread.
+        Synchronization::Atomic<bool> Polling;  //  Waiting on `WakeSignal`.
+
+        /*  Identification  */
+
+        System::CpuData * Cpu;  //  Null until the CPU is initialized.
+        uint32_t LapicId;
+
+        RunQueue * Next;        //  All the queues form a list.
+
+        /*  Statistics  */
+
+        uint64_t SwitchCount;
+        uint64_t StealCount;    //  Threads taken from other CPUs.
+
+        /*  Wakeup  */
+
+        uint32_t volatile WakeSignal __aligned(CacheLineSize);
+        //  Monitored by the idle owner, so writing it wakes the owner up
+        //  without an IPI. It is alone on its line, so nothing else does.
+    };
+}}
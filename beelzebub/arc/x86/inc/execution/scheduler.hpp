@@ -0,0 +1,183 @@
+/*
+    Copyright (c) 2015 Alexandru-Mihai Maftei. All rights reserved.
+
+
+    Developed by: Alexandru-Mihai Maftei
+    aka Vercas
+    http://vercas.com | https://github.com/vercas/Beelzebub
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal with the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+      * Redistributions of source code must retain the above copyright notice,
+        this list of conditions and the following disclaimers.
+      * Redistributions in binary form must reproduce the above copyright
+        notice, this list of conditions and the following disclaimers in the
+        documentation and/or other materials provided with the distribution.
+      * Neither the names of Alexandru-Mihai Maftei, Vercas, nor the names of
+        its contributors may be used to endorse or promote products derived from
+        this Software without specific prior written permission.
+
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+    WITH THE SOFTWARE.
+
+    ---
+
+    You may also find the text of this license in "LICENSE.md", along with a more
+    thorough explanation regarding other files.
+*/
+
+#pragma once
+
+#include <execution/run_queue.hpp>
+#include <system/interrupts.hpp>
+
+namespace Beelzebub { namespace Execution
+{
+    /**
+     *  <summary>
+     *  Distributes threads among CPUs and decides which runs next on each.
+     *  </summary>
+     *  <remarks>
+     *  Every CPU has a run queue with one round-robin list per priority, and
+     *  a pinned idle thread which only runs when the queue holds nothing else.
+     *  Idle threads take work from the longest queue of another CPU.
+     *  Threads are only switched in interrupt handlers: the LAPIC timer,
+     *  yields, and the IPIs which announce work to idle CPUs. The timer only
+     *  runs while a CPU is busy.
+     *  </remarks>
+     */
+    class Scheduler
+    {
+    public:
+        /*  Statics  */
+
+        static uint8_t const Vector = 0xDB;
+        //  Just below the stop-machine vector.
+
+        static uint64_t const SliceLength = 1000;
+        //  In microseconds.
+
+        /*  Interrupt Handler  */
+
+        static void Handler(INTERRUPT_HANDLER_ARGS_FULL);
+
+        /*  Constructor(s)  */
+
+    protected:
+        Scheduler() = default;
+
+    public:
+        Scheduler(Scheduler const &) = delete;
+        Scheduler & operator =(Scheduler const &) = delete;
+
+        /*  Initialization  */
+
+        /**
+         *  <summary>
+         *  Makes the scheduler manage the current CPU, starting with the given
+         *  thread, which is pinned to it.
+         *  </summary>
+         */
+        static __startup void InitializeCpu(Thread * const initial);
+
+        /*  Operations  */
+
+        /**
+         *  <summary>
+         *  Switches the current CPU to the best thread in its run queue, if
+         *  that takes precedence over the current thread or the latter is
+         *  blocked. Must be called by the handler of a full interrupt.
+         *  </summary>
+         *  <remarks>
+         *  Also arms the LAPIC timer for the end of the time slice, or disarms
+         *  it if the CPU goes idle.
+         *  </remarks>
+         */
+        static __hot void Schedule(System::IsrState * const state);
+
+        /**
+         *  <summary>
+         *  Lets the current CPU pick another thread because its time slice has
+         *  expired.
+         *  </summary>
+         */
+        static __hot void Tick(System::IsrState * const state);
+
+        /**
+         *  <summary>Makes a thread which is neither running nor queued runnable.</summary>
+         *  <remarks>
+         *  Pinned threads are given to the current CPU, and the rest to the one
+         *  with the shortest run queue.
+         *  </remarks>
+         */
+        static Handle Enqueue(Thread * const thread);
+
+        /**
+         *  <summary>
+         *  Gives up the CPU until the current thread is woken up. Its
+         *  <see cref="Thread::Blocked"/> flag must be set already.
+         *  </summary>
+         */
+        static void Block();
+
+        /**
+         *  <summary>
+         *  Blocks the current thread for at least the given number of
+         *  nanoseconds.
+         *  </summary>
+         *  <remarks>
+         *  Relies on the timer thread of the CPU, so timer functions cannot
+         *  sleep.
+         *  </remarks>
+         */
+        static void Sleep(uint64_t const nanoseconds);
+
+        /**
+         *  <summary>Makes a blocked thread runnable again.</summary>
+         *  <returns>True if the thread was blocked; otherwise false.</returns>
+         *  <remarks>
+         *  A thread which has not given up its CPU yet simply carries on.
+         *  </remarks>
+         */
+        static __hot bool Wake(Thread * const thread);
+
+        /*  Idling  */
+
+        /**
+         *  <summary>
+         *  Turns the current thread into the idle thread of its CPU, which is
+         *  only run when nothing else can be.
+         *  </summary>
+         */
+        static void BecomeIdle();
+
+        /**
+         *  <summary>
+         *  Runs work found in the current CPU's queue or taken from another
+         *  CPU, or else halts until an interrupt arrives. Meant to be called in
+         *  a loop by idle threads.
+         *  With MONITOR/MWAIT, it also returns when another CPU writes the wake
+         *  line of the queue, which is how other CPUs wake it up.
+         *  </summary>
+         */
+        static void Idle();
+
+        /*  Properties  */
+
+        /**
+         *  <summary>Determines whether the current CPU is managed by the scheduler.</summary>
+         */
+        static __hot bool IsActive();
+    };
+}}
@@ -0,0 +1,195 @@
+/*
+    Copyright (c) 2015 Alexandru-Mihai Maftei. All rights reserved.
+
+
+    Developed by: Alexandru-Mihai Maftei
+    aka Vercas
+    http://vercas.com | https://github.com/vercas/Beelzebub
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal with the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+      * Redistributions of source code must retain the above copyright notice,
+        this list of conditions and the following disclaimers.
+      * Redistributions in binary form must reproduce the above copyright
+        notice, this list of conditions and the following disclaimers in the
+        documentation and/or other materials provided with the distribution.
+      * Neither the names of Alexandru-Mihai Maftei, Vercas, nor the names of
+        its contributors may be used to endorse or promote products derived from
+        this Software without specific prior written permission.
+
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+    WITH THE SOFTWARE.
+
+    ---
+
+    You may also find the text of this license in "LICENSE.md", along with a more
+    thorough explanation regarding other files.
+*/
+
+#pragma once
+
+#include <beel/handles.h>
+
+namespace Beelzebub { namespace Execution
+{
+    typedef void (* SoftIrqHandler)();
+
+    /**
+     *  <summary>Known soft interrupt vectors, in order of precedence.</summary>
+     */
+    enum class SoftIrqVector : uint8_t
+    {
+        //  Runs the tasklets scheduled on the CPU.
+        Tasklet = 0,
+        //  Invokes RCU callbacks whose grace periods have ended.
+        Rcu = 1,
+    };
+
+    /**
+     *  <summary>Per-CPU bottom halves of interrupt handlers.</summary>
+     *  <remarks>
+     *  Hardware interrupt handlers raise soft interrupts for the work they do
+     *  not need to do with interrupts disabled. The raised handlers run on the
+     *  way out of the outermost interrupt, with interrupts enabled, on the CPU
+     *  which raised them. Handlers raised while they are running are run too,
+     *  a few times over; the rest is left to the work queue thread of the CPU.
+     *
+     *  Handlers must not block, and locks they share with threads must be
+     *  taken with interrupts disabled.
+     *  </remarks>
+     */
+    class SoftIrq
+    {
+    public:
+        /*  Statics  */
+
+        static size_t const Count = 32;
+        //  As many as there are bits in the pending mask.
+
+        static size_t const RestartLimit = 8;
+
+        /*  Constructor(s)  */
+
+        SoftIrq() = delete;
+        SoftIrq(SoftIrq const &) = delete;
+        SoftIrq & operator =(SoftIrq const &) = delete;
+
+        /*  Handlers  */
+
+        /**
+         *  <summary>Sets the handler of a soft interrupt vector.</summary>
+         */
+        static Handle Register(SoftIrqVector const vec, SoftIrqHandler const handler);
+
+        /*  Operations  */
+
+        /**
+         *  <summary>Makes the given soft interrupt pending on the current CPU.</summary>
+         *  <remarks>
+         *  Outside of interrupt handlers, the work queue thread is woken up to
+         *  run it.
+         *  </remarks>
+         */
+        static __hot void Raise(SoftIrqVector const vec);
+
+        /**
+         *  <summary>
+         *  Runs the pending soft interrupts of the current CPU, with interrupts
+         *  enabled.
+         *  </summary>
+         *  <remarks>
+         *  Interrupts must be disabled, and they are disabled again on return.
+         *  </remarks>
+         */
+        static __hot void Process();
+
+        /*  Properties  */
+
+        static bool IsPending();
+        static bool IsActive();
+
+    private:
+
+        /*  Tasklets  */
+
+        static void RunTasklets();
+
+        /*  Fields  */
+
+        static SoftIrqHandler Handlers[Count];
+    };
+
+    struct Tasklet;
+
+    typedef void (* TaskletFunction)(Tasklet * const tasklet);
+
+    /**
+     *  <summary>A function which runs once in a soft interrupt, per scheduling.</summary>
+     *  <remarks>
+     *  A tasklet runs on the CPU which scheduled it, so it never runs
+     *  concurrently with itself. Scheduling it again before it runs has no
+     *  effect; scheduling it while it runs makes it run once more.
+     *  </remarks>
+     */
+    struct Tasklet
+    {
+    public:
+
+        /*  Constructor(s)  */
+
+        inline constexpr Tasklet(TaskletFunction const func = nullptr, void * const cookie = nullptr)
+            : Function(func)
+            , Cookie(cookie)
+            , Next(nullptr)
+            , Scheduled(false)
+        {
+
+        }
+
+        Tasklet(Tasklet const &) = delete;
+        Tasklet & operator =(Tasklet const &) = delete;
+
+        /*  Operations  */
+
+        /**
+         *  <summary>Makes the function run soon on the current CPU.</summary>
+         *  <returns>False if the tasklet was already scheduled; otherwise true.</returns>
+         */
+        __hot bool Schedule();
+
+        /*  Properties  */
+
+        __forceinline bool IsScheduled() const { return this->Scheduled; }
+
+        /*  Fields  */
+
+        TaskletFunction Function;
+        void * Cookie;
+
+    private:
+
+        Tasklet * Next;
+        bool volatile Scheduled;
+
+        friend class SoftIrq;
+    };
+}}
+
+/**
+ *  <summary>
+ *  Called by the interrupt stubs after the handler of an IRQ (never an
+ *  exception), with the flags of the interrupted code.
+ *  </summary>
+ */
+__extern __hot void SoftIrqOnInterruptReturn(uint64_t const rflags);
@@ -0,0 +1,175 @@
+/*
+    Copyright (c) 2015 Alexandru-Mihai Maftei. All rights reserved.
+
+
+    Developed by: Alexandru-Mihai Maftei
+    aka Vercas
+    http://vercas.com | https://github.com/vercas/Beelzebub
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal with the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+      * Redistributions of source code must retain the above copyright notice,
+        this list of conditions and the following disclaimers.
+      * Redistributions in binary form must reproduce the above copyright
+        notice, this list of conditions and the following disclaimers in the
+        documentation and/or other materials provided with the distribution.
+      * Neither the names of Alexandru-Mihai Maftei, Vercas, nor the names of
+        its contributors may be used to endorse or promote products derived from
+        this Software without specific prior written permission.
+
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+    WITH THE SOFTWARE.
+
+    ---
+
+    You may also find the text of this license in "LICENSE.md", along with a more
+    thorough explanation regarding other files.
+*/
+
+#pragma once
+
+#include <synchronization/spinlock.hpp>
+
+namespace Beelzebub { namespace Execution
+{
+    class Thread;
+
+    struct WorkItem;
+    struct WorkQueue;
+
+    typedef void (* WorkFunction)(WorkItem * const item);
+
+    /**
+     *  <summary>A function which runs once in a kernel worker thread, per queuing.</summary>
+     *  <remarks>
+     *  Work functions run with interrupts enabled, so they may take locks,
+     *  block and wake threads up.
+     *  </remarks>
+     */
+    struct WorkItem
+    {
+    public:
+
+        /*  Constructor(s)  */
+
+        inline constexpr WorkItem(WorkFunction const func = nullptr, void * const cookie = nullptr)
+            : Function(func)
+            , Cookie(cookie)
+            , Next(nullptr)
+            , Queue(nullptr)
+        {
+
+        }
+
+        WorkItem(WorkItem const &) = delete;
+        WorkItem & operator =(WorkItem const &) = delete;
+
+        /*  Properties  */
+
+        __forceinline bool IsQueued() const { return this->Queue != nullptr; }
+
+        /*  Fields  */
+
+        WorkFunction Function;
+        void * Cookie;
+
+    private:
+
+        WorkItem * Next;
+        WorkQueue * volatile Queue;
+        //  Null when not queued.
+
+        friend struct WorkQueue;
+    };
+
+    /**
+     *  <summary>Work items of a CPU, run in order by its worker thread.</summary>
+     *  <remarks>
+     *  The worker thread also runs the soft interrupts which could not run on
+     *  the way out of interrupts.
+     *  </remarks>
+     */
+    struct WorkQueue
+    {
+    public:
+
+        /*  Statics  */
+
+        static size_t const WorkerStackPages = 4;
+
+        /*  Constructor(s)  */
+
+        inline WorkQueue()
+            : Lock()
+            , First(nullptr)
+            , Last(nullptr)
+            , Worker(nullptr)
+        {
+
+        }
+
+        WorkQueue(WorkQueue const &) = delete;
+        WorkQueue & operator =(WorkQueue const &) = delete;
+
+        /*  Initialization  */
+
+        /**
+         *  <summary>
+         *  Starts the worker thread of the current CPU, which uses the given
+         *  storage. Requires the scheduler to manage this CPU.
+         *  </summary>
+         */
+        static __startup void InitializeCpu(Thread * const worker);
+
+        /*  Operations  */
+
+        /**
+         *  <summary>Queues the item on the current CPU.</summary>
+         *  <returns>False if the item was already queued; otherwise true.</returns>
+         */
+        static __hot bool QueueLocal(WorkItem * const item);
+
+        /**
+         *  <summary>Queues the item on this queue, which may be another CPU's.</summary>
+         *  <returns>False if the item was already queued; otherwise true.</returns>
+         */
+        __hot bool Queue(WorkItem * const item);
+
+        /**
+         *  <summary>Wakes the worker thread up, if it exists.</summary>
+         */
+        void Kick();
+
+        /*  Properties  */
+
+        __forceinline Thread * GetWorker() const { return this->Worker; }
+
+    private:
+
+        /*  Worker Thread  */
+
+        WorkItem * Pop();
+
+        static void * WorkerEntryPoint(void * const arg);
+
+        /*  Fields  */
+
+        Synchronization::Spinlock<> Lock;
+
+        WorkItem * First;
+        WorkItem * Last;
+
+        Thread * Worker;
+    };
+}}
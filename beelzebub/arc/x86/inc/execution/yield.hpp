@@ -0,0 +1,92 @@
+/*
+    Copyright (c) 2015 Alexandru-Mihai Maftei. All rights reserved.
+
+
+    Developed by: Alexandru-Mihai Maftei
+    aka Vercas
+    http://vercas.com | https://github.com/vercas/Beelzebub
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal with the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+      * Redistributions of source code must retain the above copyright notice,
+        this list of conditions and the following disclaimers.
+      * Redistributions in binary form must reproduce the above copyright
+        notice, this list of conditions and the following disclaimers in the
+        documentation and/or other materials provided with the distribution.
+      * Neither the names of Alexandru-Mihai Maftei, Vercas, nor the names of
+        its contributors may be used to endorse or promote products derived from
+        this Software without specific prior written permission.
+
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+    WITH THE SOFTWARE.
+
+    ---
+
+    You may also find the text of this license in "LICENSE.md", along with a more
+    thorough explanation regarding other files.
+*/
+
+#pragma once
+
+#include <execution/thread.hpp>
+#include <system/interrupts.hpp>
+
+namespace Beelzebub { namespace Execution
+{
+    /**
+     *  <summary>Lets a thread give up its CPU voluntarily.</summary>
+     */
+    class Yield
+    {
+    public:
+        /*  Statics  */
+
+        static uint8_t const Vector = 0xDD;
+        //  Just below the vectors used by the interrupt latency test.
+
+        /*  Interrupt Handler  */
+
+        static void Handler(INTERRUPT_HANDLER_ARGS_FULL);
+
+        /*  Constructor(s)  */
+
+    protected:
+        Yield() = default;
+
+    public:
+        Yield(Yield const &) = delete;
+        Yield & operator =(Yield const &) = delete;
+
+        /*  Operations  */
+
+        /**
+         *  <summary>
+         *  Switches to the next runnable thread, if any. The current thread
+         *  resumes from here when it is switched to again.
+         *  </summary>
+         */
+        static __forceinline void Now()
+        {
+            System::Interrupts::Trigger<Vector>();
+        }
+
+        /**
+         *  <summary>
+         *  Determines whether the current thread can give up its CPU, which
+         *  requires the scheduler to manage the CPU.
+         *  </summary>
+         */
+        static __hot bool IsPossible();
+    };
+}}
@@ -0,0 +1,337 @@
+/*
+    Copyright (c) 2015 Alexandru-Mihai Maftei. All rights reserved.
+
+
+    Developed by: Alexandru-Mihai Maftei
+    aka Vercas
+    http://vercas.com | https://github.com/vercas/Beelzebub
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal with the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+      * Redistributions of source code must retain the above copyright notice,
+        this list of conditions and the following disclaimers.
+      * Redistributions in binary form must reproduce the above copyright
+        notice, this list of conditions and the following disclaimers in the
+        documentation and/or other materials provided with the distribution.
+      * Neither the names of Alexandru-Mihai Maftei, Vercas, nor the names of
+        its contributors may be used to endorse or promote products derived from
+        this Software without specific prior written permission.
+
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+    WITH THE SOFTWARE.
+
+    ---
+
+    You may also find the text of this license in "LICENSE.md", along with a more
+    thorough explanation regarding other files.
+*/
+
+#pragma once
+
+#include <synchronization/rw_spinlock.hpp>
+
+namespace Beelzebub { namespace Synchronization
+{
+#ifdef __BEELZEBUB_SETTINGS_SMP
+
+    /**
+     *  <summary>
+     *  Reader/writer lock meant for data which is read far more often than
+     *  it is written.
+     *  </summary>
+     *  <remarks>
+     *  Readers only touch the counter of their CPU's slot, so they do not
+     *  contend with each other. Writers pay for this by having to wait for
+     *  the counters of all slots to drain.
+     *  A reader may release the lock on another CPU than the one it acquired
+     *  it on; only the sum of the counters is meaningful.
+     *  </remarks>
+     */
+    struct BigReaderRwSpinlock
+    {
+        /*  Constants  */
+
+        static size_t const SlotCount = 16;
+
+        /*  Constructor(s)  */
+
+        BigReaderRwSpinlock() = default;
+
+        BigReaderRwSpinlock(BigReaderRwSpinlock const &) = delete;
+        BigReaderRwSpinlock & operator =(BigReaderRwSpinlock const &) = delete;
+        BigReaderRwSpinlock(BigReaderRwSpinlock &&) = delete;
+        BigReaderRwSpinlock & operator =(BigReaderRwSpinlock &&) = delete;
+
+        /*  Acquisition Operations  */
+
+        /**
+         *  <summary>Attempts to acquire the lock as a reader.</summary>
+         *  <return>True if the acquisition succeeded; false otherwise.</return>
+         */
+        inline __must_check bool TryAcquireAsReader() volatile
+        {
+            PREEMPTION_DISABLE();
+            COMPILER_MEMORY_BARRIER();
+
+        op_start:
+            Atomic<size_t> volatile & readers = this->Slots[GetSlotIndex()].Readers;
+
+            ++readers;
+            //  Attempt registration as reader. The locked instruction also
+            //  orders the following load after it.
+
+            if (this->Writer.Load())
+            {
+                --readers;
+                //  Take a step back.
+                PREEMPTION_ENABLE();
+
+                return false;
+            }
+        op_end:
+
+            COMPILER_MEMORY_BARRIER();
+            ANNOTATE_LOCK_OPERATION_ACQ;
+
+            return true;
+        }
+
+        /**
+         *  <summary>Acquires the lock as a reader.</summary>
+         */
+        inline void AcquireAsReader() volatile
+        {
+            PREEMPTION_DISABLE();
+            COMPILER_MEMORY_BARRIER();
+
+        op_start:
+            Atomic<size_t> volatile & readers = this->Slots[GetSlotIndex()].Readers;
+
+            while (true)
+            {
+                while (this->Writer.Load())
+                    asm volatile ( "pause \n\t" : : : "memory" );
+                //  Wait if a writer exists.
+
+                ++readers;
+
+                if (!this->Writer.Load())
+                    break;
+                //  Registered as a reader before any writer showed up.
+
+                --readers;
+                //  Whoops, failed. Undo damage.
+            }
+        op_end:
+
+            COMPILER_MEMORY_BARRIER();
+            ANNOTATE_LOCK_OPERATION_ACQ;
+        }
+
+        /**
+         *  <summary>Attempts to acquire the lock as a writer.</summary>
+         *  <return>True if the acquisition succeeded; false otherwise.</return>
+         */
+        inline __must_check bool TryAcquireAsWriter() volatile
+        {
+            PREEMPTION_DISABLE();
+            COMPILER_MEMORY_BARRIER();
+
+        op_start:
+            if (this->Writer.TestSet())
+            {
+                PREEMPTION_ENABLE();
+
+                return false;
+            }
+
+            if (this->GetReaderCount() != 0)
+            {
+                this->Writer.Clear();
+                PREEMPTION_ENABLE();
+
+                return false;
+            }
+        op_end:
+
+            COMPILER_MEMORY_BARRIER();
+            ANNOTATE_LOCK_OPERATION_ACQ;
+
+            return true;
+        }
+
+        /**
+         *  <summary>Acquires the lock as the writer.</summary>
+         */
+        inline void AcquireAsWriter() volatile
+        {
+            PREEMPTION_DISABLE();
+            COMPILER_MEMORY_BARRIER();
+
+        op_start:
+            while (this->Writer.TestSet())
+                asm volatile ( "pause \n\t" : : : "memory" );
+            //  New readers are turned away from here on.
+
+            while (this->GetReaderCount() != 0)
+                asm volatile ( "pause \n\t" : : : "memory" );
+            //  Wait for the current readers to leave.
+        op_end:
+
+            COMPILER_MEMORY_BARRIER();
+            ANNOTATE_LOCK_OPERATION_ACQ;
+        }
+
+        /**
+         *  <summary>Attempts to upgrade a reader to the writer.</summary>
+         *  <return>True if the upgrade succeeded; false otherwise.</return>
+         */
+        inline __must_check bool UpgradeToWriter() volatile
+        {
+            COMPILER_MEMORY_BARRIER();
+
+        op_start:
+            if (this->Writer.TestSet())
+                return false;
+            //  Fail if another writer is awaiting on this lock.
+
+            --this->Slots[GetSlotIndex()].Readers;
+            //  Don't count this as a reader anymore.
+
+            while (this->GetReaderCount() != 0)
+                asm volatile ( "pause \n\t" : : : "memory" );
+            //  Wait for readers to clear.
+        op_end:
+
+            COMPILER_MEMORY_BARRIER();
+            ANNOTATE_LOCK_OPERATION_ACQ;
+
+            return true;
+        }
+
+        /*  Release Operations  */
+
+        /**
+         *  <summary>Releases the lock as a reader.</summary>
+         */
+        inline void ReleaseAsReader() volatile
+        {
+            COMPILER_MEMORY_BARRIER();
+
+        op_start:
+            --this->Slots[GetSlotIndex()].Readers;
+        op_end:
+
+            COMPILER_MEMORY_BARRIER();
+            ANNOTATE_LOCK_OPERATION_REL;
+            PREEMPTION_ENABLE();
+        }
+
+        /**
+         *  <summary>Releases the lock as the writer.</summary>
+         */
+        inline void ReleaseAsWriter() volatile
+        {
+            COMPILER_MEMORY_BARRIER();
+
+        op_start:
+            this->Writer.Clear();
+        op_end:
+
+            COMPILER_MEMORY_BARRIER();
+            ANNOTATE_LOCK_OPERATION_REL;
+            PREEMPTION_ENABLE();
+        }
+
+        /**
+         *  <summary>Downgrades the writer to a reader.</summary>
+         */
+        inline void DowngradeToReader() volatile
+        {
+            COMPILER_MEMORY_BARRIER();
+
+        op_start:
+            ++this->Slots[GetSlotIndex()].Readers;
+            //  Count this as a reader first.
+
+            this->Writer.Clear();
+            //  De-register as writer.
+        op_end:
+
+            COMPILER_MEMORY_BARRIER();
+            ANNOTATE_LOCK_OPERATION_REL;
+        }
+
+        /**
+         *  <summary>Resets the lock.</summary>
+         */
+        inline void Reset() volatile
+        {
+            for (size_t i = 0; i < SlotCount; ++i)
+                this->Slots[i].Readers.Store(0);
+
+            this->Writer.Clear();
+        }
+
+        /*  Properties  */
+
+        /**
+         *  <summary>Determines whether there is an active writer or an awaiting writer..</summary>
+         *  <return>True if there is an active/awaiting writer; otherwise false.</return>
+         */
+        __forceinline __must_check bool HasWriter() const volatile
+        {
+            return this->Writer.Load();
+        }
+
+        /**
+         *  <summary>Gets the number of active readers.</summary>
+         *  <return>The number of active readers.</return>
+         */
+        inline __must_check size_t GetReaderCount() const volatile
+        {
+            size_t sum = 0;
+
+            for (size_t i = 0; i < SlotCount; ++i)
+                sum += this->Slots[i].Readers.Load();
+
+            return sum;
+            //  Individual counters may wrap around when readers migrate
+            //  between CPUs, but their sum cannot.
+        }
+
+    private:
+        /*  Slots  */
+
+        /// <summary>Gets the slot of the current CPU.</summary>
+        static __hot size_t GetSlotIndex();
+
+        struct Slot
+        {
+            Atomic<size_t> Readers;
+        } __aligned(CacheLineSize);
+
+        /*  Fields  */
+
+        Slot Slots[SlotCount];
+        Atomic<bool> Writer;
+    };
+
+#else
+
+    typedef RwSpinlock BigReaderRwSpinlock;
+    //  With a single CPU, there is nothing to distribute.
+
+#endif
+}}
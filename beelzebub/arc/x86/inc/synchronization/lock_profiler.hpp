@@ -0,0 +1,177 @@
+/*
+    Copyright (c) 2015 Alexandru-Mihai Maftei. All rights reserved.
+
+
+    Developed by: Alexandru-Mihai Maftei
+    aka Vercas
+    http://vercas.com | https://github.com/vercas/Beelzebub
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal with the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+      * Redistributions of source code must retain the above copyright notice,
+        this list of conditions and the following disclaimers.
+      * Redistributions in binary form must reproduce the above copyright
+        notice, this list of conditions and the following disclaimers in the
+        documentation and/or other materials provided with the distribution.
+      * Neither the names of Alexandru-Mihai Maftei, Vercas, nor the names of
+        its contributors may be used to endorse or promote products derived from
+        this Software without specific prior written permission.
+
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+    WITH THE SOFTWARE.
+
+    ---
+
+    You may also find the text of this license in "LICENSE.md", along with a more
+    thorough explanation regarding other files.
+*/
+
+/**
+ *  The lock profiler is only built in when the `lock-profiling` setting is
+ *  enabled. Spinlocks then report every acquisition and release, and the
+ *  profiler attributes the time spent waiting for and holding them to the
+ *  code location of the acquisition.
+ *
+ *  Counters live in per-CPU buckets, so profiling does not add contention of
+ *  its own. Every CPU allocates its bucket as it is initialized, and buckets
+ *  are merged when dumped.
+ */
+
+#pragma once
+
+#include <system/cpu_instructions.hpp>
+
+#ifdef __BEELZEBUB_SETTINGS_LOCK_PROFILING
+
+//  The address of the instruction following this, which is inlined into
+//  the acquiring function along with the spinlock operation.
+#define LOCK_PROFILING_SITE ({                              \
+    void const * __lock_profiling_site;                     \
+    asm volatile ( "mov $1f, %0 \n\t 1: \n\t"               \
+                 : "=r"(__lock_profiling_site) );           \
+    __lock_profiling_site; })
+
+#define LOCK_PROFILING_BEGIN                                \
+    uint64_t const __lock_profiling_start = Beelzebub::System::CpuInstructions::Rdtsc(); \
+    bool __lock_profiling_contended = false
+
+#define LOCK_PROFILING_CONTENDED                            \
+    __lock_profiling_contended = true
+
+//  A try-acquisition which fails records nothing.
+#define LOCK_PROFILING_CANCELLED                            \
+    ((void)__lock_profiling_start, (void)__lock_profiling_contended)
+
+#define LOCK_PROFILING_ACQUIRED_AT(lock, site)              \
+    Beelzebub::Synchronization::LockProfiler::Acquired(lock, site, __lock_profiling_start, __lock_profiling_contended)
+
+#define LOCK_PROFILING_ACQUIRED(lock) LOCK_PROFILING_ACQUIRED_AT(lock, LOCK_PROFILING_SITE)
+
+#define LOCK_PROFILING_RELEASED(lock)                       \
+    Beelzebub::Synchronization::LockProfiler::Released(lock)
+
+namespace Beelzebub { namespace Terminals
+{
+    class TerminalBase;
+}}
+
+namespace Beelzebub { namespace Synchronization
+{
+    /**
+     *  Counters of the acquisitions of locks at one code location.
+     */
+    struct LockProfilingEntry
+    {
+        void const * Site;
+
+        uint64_t Acquisitions;
+        uint64_t ContendedAcquisitions;
+        uint64_t WaitCycles;
+        uint64_t MaxWaitCycles;
+        uint64_t HoldCycles;
+        uint64_t MaxHoldCycles;
+    };
+
+    /**
+     *  Collects lock contention statistics by acquisition site.
+     */
+    class LockProfiler
+    {
+    public:
+
+        /*  Constants  */
+
+        static size_t const SiteLimit = 128;
+        static size_t const HeldLimit = 16;
+        static size_t const DumpLimit = 16;
+
+        /*  Constructor(s)  */
+
+        LockProfiler() = delete;
+        LockProfiler(LockProfiler const &) = delete;
+        LockProfiler & operator =(LockProfiler const &) = delete;
+
+        /*  Initialization  */
+
+        /**
+         *  Allocates the counters of the current CPU, which is not profiled
+         *  before this.
+         */
+        static __cold void InitializeCpu();
+
+        /*  Hooks  */
+
+        /**
+         *  Records an acquisition of the given lock, which started waiting at
+         *  the given timestamp.
+         */
+        static __noinline void Acquired(void const volatile * lock, void const * site
+            , uint64_t start, bool contended);
+
+        /**
+         *  Records the release of the given lock, if the current CPU was
+         *  recorded acquiring it.
+         */
+        static __noinline void Released(void const volatile * lock);
+
+        /*  Statistics  */
+
+        /**
+         *  Merges the entries of all CPUs, sorted by total wait time, and
+         *  returns how many were written to the given array.
+         */
+        static size_t Collect(LockProfilingEntry * entries, size_t capacity);
+
+        /**
+         *  Writes the sites with the most time spent waiting as a table.
+         */
+        static __cold void Dump(Terminals::TerminalBase * const term);
+
+        /**
+         *  Clears all counters. Locks currently held are forgotten.
+         */
+        static __cold void Reset();
+    };
+}}
+
+#else
+
+#define LOCK_PROFILING_BEGIN                    do { } while (false)
+#define LOCK_PROFILING_CONTENDED                do { } while (false)
+#define LOCK_PROFILING_CANCELLED                do { } while (false)
+#define LOCK_PROFILING_ACQUIRED_AT(lock, site)  do { } while (false)
+#define LOCK_PROFILING_ACQUIRED(lock)           do { } while (false)
+#define LOCK_PROFILING_RELEASED(lock)           do { } while (false)
+
+#endif
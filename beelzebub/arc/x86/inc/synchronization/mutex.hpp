@@ -0,0 +1,119 @@
+/*
+    Copyright (c) 2015 Alexandru-Mihai Maftei. All rights reserved.
+
+
+    Developed by: Alexandru-Mihai Maftei
+    aka Vercas
+    http://vercas.com | https://github.com/vercas/Beelzebub
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal with the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+      * Redistributions of source code must retain the above copyright notice,
+        this list of conditions and the following disclaimers.
+      * Redistributions in binary form must reproduce the above copyright
+        notice, this list of conditions and the following disclaimers in the
+        documentation and/or other materials provided with the distribution.
+      * Neither the names of Alexandru-Mihai Maftei, Vercas, nor the names of
+        its contributors may be used to endorse or promote products derived from
+        this Software without specific prior written permission.
+
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+    WITH THE SOFTWARE.
+
+    ---
+
+    You may also find the text of this license in "LICENSE.md", along with a more
+    thorough explanation regarding other files.
+*/
+
+#pragma once
+
+#include <synchronization/wait_queue.hpp>
+#include <synchronization/atomic.hpp>
+
+namespace Beelzebub { namespace Synchronization
+{
+    /**
+     *  Non-re-entrant mutual exclusion primitive which blocks its waiters.
+     *  Contenders spin while the owner is running on another CPU, and block
+     *  otherwise. Blocked contenders are given the mutex in FIFO order.
+     *  When blocking is impossible (e.g. before scheduling starts), it spins.
+     */
+    class Mutex
+    {
+    public:
+
+        typedef void Cookie;
+
+        /*  Constructor(s)  */
+
+        inline Mutex()
+            : Locked(false)
+            , Owner(nullptr)
+            , Guard()
+            , Waiters()
+        {
+
+        }
+
+        Mutex(Mutex const &) = delete;
+        Mutex & operator =(Mutex const &) = delete;
+        Mutex(Mutex &&) = delete;
+        Mutex & operator =(Mutex &&) = delete;
+
+        /*  Operations  */
+
+        /**
+         *  Acquire the mutex, if possible.
+         */
+        __hot __must_check bool TryAcquire();
+
+        /**
+         *  Acquire the mutex, waiting if necessary.
+         */
+        __hot void Acquire();
+
+        /**
+         *  Release the mutex, handing it over to the first waiter, if any.
+         */
+        __hot void Release();
+
+        /*  Properties  */
+
+        /**
+         *  Checks whether the mutex is free or not.
+         */
+        __forceinline __must_check bool Check() const
+        {
+            return !this->Locked.Load();
+        }
+
+        __forceinline Execution::Thread * GetOwner() const
+        {
+            return this->Owner;
+        }
+
+    private:
+
+        __noinline void AcquireContended();
+
+        /*  Fields  */
+
+        Atomic<bool> Locked;
+        Execution::Thread * volatile Owner;
+
+        Spinlock<> Guard;
+        WaitQueue Waiters;
+    };
+}}
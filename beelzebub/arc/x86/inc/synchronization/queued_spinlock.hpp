@@ -0,0 +1,430 @@
+/*
+    Copyright (c) 2015 Alexandru-Mihai Maftei. All rights reserved.
+
+
+    Developed by: Alexandru-Mihai Maftei
+    aka Vercas
+    http://vercas.com | https://github.com/vercas/Beelzebub
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal with the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+      * Redistributions of source code must retain the above copyright notice,
+        this list of conditions and the following disclaimers.
+      * Redistributions in binary form must reproduce the above copyright
+        notice, this list of conditions and the following disclaimers in the
+        documentation and/or other materials provided with the distribution.
+      * Neither the names of Alexandru-Mihai Maftei, Vercas, nor the names of
+        its contributors may be used to endorse or promote products derived from
+        this Software without specific prior written permission.
+
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+    WITH THE SOFTWARE.
+
+    ---
+
+    You may also find the text of this license in "LICENSE.md", along with a more
+    thorough explanation regarding other files.
+*/
+
+/**
+ *  The `__must_check` attributes are there to make sure that the
+ *  QueuedSpinlockUninterruptible is not used in place of a normal spinlock
+ *  accidentally.
+ */
+
+#pragma once
+
+#include <synchronization/spinlock.hpp>
+#include <synchronization/spinlock_uninterruptible.hpp>
+
+namespace Beelzebub { namespace Synchronization
+{
+    /**
+     *  A waiter's place in the queue of a queued spinlock.
+     *  It lives on the waiter's stack, only for as long as it waits.
+     */
+    struct QueuedSpinlockNode
+    {
+        QueuedSpinlockNode * volatile Next;
+        bool volatile Head;
+    } __aligned(CacheLineSize);
+
+    /**
+     *  Busy-waiting synchronization primitive which queues its waiters, so each
+     *  of them spins on its own cache line instead of the lock's.
+     */
+    template<bool SMP = true>
+    struct QueuedSpinlock
+    {
+    public:
+
+        typedef void Cookie;
+
+        /*  Constructor(s)  */
+
+        QueuedSpinlock() = default;
+
+        QueuedSpinlock(QueuedSpinlock const &) = delete;
+        QueuedSpinlock & operator =(QueuedSpinlock const &) = delete;
+        QueuedSpinlock(QueuedSpinlock &&) = delete;
+        QueuedSpinlock & operator =(QueuedSpinlock &&) = delete;
+
+        /*  Destructor  */
+
+#ifdef __BEELZEBUB__DEBUG
+        ~QueuedSpinlock();
+#endif
+
+        /*  Operations  */
+
+        /**
+         *  Acquire the spinlock, if possible.
+         */
+        __forceinline __must_check bool TryAcquire() volatile
+        {
+            PREEMPTION_DISABLE();
+            LOCK_PROFILING_BEGIN;
+            COMPILER_MEMORY_BARRIER();
+
+        op_start:
+            if (!this->TryTakeOwnership())
+            {
+                LOCK_PROFILING_CANCELLED;
+                PREEMPTION_ENABLE();
+
+                return false;
+            }
+        op_end:
+
+            COMPILER_MEMORY_BARRIER();
+            ANNOTATE_LOCK_OPERATION_ACQ;
+            LOCK_PROFILING_ACQUIRED(this);
+
+            return true;
+        }
+
+        /**
+         *  Awaits for the spinlock to be freed.
+         *  Does not acquire the lock.
+         */
+        __forceinline void Spin() const volatile
+        {
+            COMPILER_MEMORY_BARRIER();
+
+        op_start:
+            do
+            {
+                asm volatile ( "pause \n\t" : : : "memory" );
+            } while (this->Locked || this->Tail != nullptr);
+        op_end:
+
+            COMPILER_MEMORY_BARRIER();
+            ANNOTATE_LOCK_OPERATION_CHK;
+        }
+
+        /**
+         *  Checks if the spinlock is free. If not, it awaits.
+         *  Does not acquire the lock.
+         */
+        __forceinline void Await() const volatile
+        {
+            COMPILER_MEMORY_BARRIER();
+
+        op_start:
+            while (this->Locked || this->Tail != nullptr)
+                asm volatile ( "pause \n\t" : : : "memory" );
+        op_end:
+
+            COMPILER_MEMORY_BARRIER();
+            ANNOTATE_LOCK_OPERATION_CHK;
+        }
+
+        /**
+         *  Acquire the spinlock, waiting if necessary.
+         */
+        __forceinline void Acquire() volatile
+        {
+            PREEMPTION_DISABLE();
+            LOCK_PROFILING_BEGIN;
+            COMPILER_MEMORY_BARRIER();
+
+        op_start:
+            if unlikely(!this->TryTakeOwnership())
+            {
+                LOCK_PROFILING_CONTENDED;
+                this->AcquireQueued();
+            }
+        op_end:
+
+            COMPILER_MEMORY_BARRIER();
+            ANNOTATE_LOCK_OPERATION_ACQ;
+            LOCK_PROFILING_ACQUIRED(this);
+        }
+
+        /**
+         *  Release the spinlock.
+         */
+        __forceinline void Release() volatile
+        {
+            COMPILER_MEMORY_BARRIER();
+
+        op_start:
+            __atomic_store_n(&this->Locked, false, __ATOMIC_RELEASE);
+            //  The head of the queue, if any, is spinning on this.
+        op_end:
+
+            COMPILER_MEMORY_BARRIER();
+            ANNOTATE_LOCK_OPERATION_REL;
+            LOCK_PROFILING_RELEASED(this);
+            PREEMPTION_ENABLE();
+        }
+
+        /**
+         *  Checks whether the spinlock is free or not.
+         */
+        __forceinline __must_check bool Check() const volatile
+        {
+            COMPILER_MEMORY_BARRIER();
+
+        op_start:
+            if (this->Locked || this->Tail != nullptr)
+                return false;
+        op_end:
+
+            COMPILER_MEMORY_BARRIER();
+            ANNOTATE_LOCK_OPERATION_CHK;
+
+            return true;
+        }
+
+        /**
+         *  Acquire the spinlock, waiting if necessary.
+         */
+        __forceinline void SimplyAcquire() volatile { this->Acquire(); }
+
+        /**
+         *  Release the spinlock.
+         */
+        __forceinline void SimplyRelease() volatile { this->Release(); }
+
+        /**
+         *  Reset the spinlock.
+         */
+        __forceinline void Reset() volatile
+        {
+            this->Tail = nullptr;
+            this->Locked = false;
+        }
+
+    private:
+
+        /**
+         *  Takes the lock if it is free and nobody is queued for it.
+         */
+        __forceinline bool TryTakeOwnership() volatile
+        {
+            bool expected = false;
+
+            return this->Tail == nullptr
+                && __atomic_compare_exchange_n(&this->Locked, &expected, true
+                    , false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+        }
+
+        /**
+         *  Joins the queue of waiters and takes the lock when first in line.
+         */
+        __noinline void AcquireQueued() volatile;
+
+        /*  Fields  */
+
+        QueuedSpinlockNode * volatile Tail;
+        bool volatile Locked;
+    };
+
+#if   defined(__BEELZEBUB_SETTINGS_NO_SMP)
+    /**
+     *  Busy-waiting synchronization primitive which queues its waiters, so each
+     *  of them spins on its own cache line instead of the lock's.
+     */
+    template<>
+    struct QueuedSpinlock<true>
+    {
+    public:
+
+        typedef void Cookie;
+
+        /*  Constructor(s)  */
+
+        QueuedSpinlock() = default;
+
+        QueuedSpinlock(QueuedSpinlock const &) = delete;
+        QueuedSpinlock & operator =(QueuedSpinlock const &) = delete;
+        QueuedSpinlock(QueuedSpinlock &&) = delete;
+        QueuedSpinlock & operator =(QueuedSpinlock &&) = delete;
+
+        /*  Operations  */
+
+#ifdef __BEELZEBUB_SETTINGS_KERNEL_PREEMPTION
+        //  Without other CPUs, there is nobody to queue, and only the current
+        //  thread needs to be kept from being switched out.
+
+        __forceinline __must_check bool TryAcquire() const volatile
+        { PREEMPTION_DISABLE(); return true; }
+
+        __forceinline void Acquire() const volatile { PREEMPTION_DISABLE(); }
+        __forceinline void SimplyAcquire() const volatile { PREEMPTION_DISABLE(); }
+
+        __forceinline void Release() const volatile { PREEMPTION_ENABLE(); }
+        __forceinline void SimplyRelease() const volatile { PREEMPTION_ENABLE(); }
+#else
+        __forceinline __must_check constexpr bool TryAcquire() const volatile
+        { return true; }
+
+        __forceinline void Acquire() const volatile { }
+        __forceinline void SimplyAcquire() const volatile { }
+
+        __forceinline void Release() const volatile { }
+        __forceinline void SimplyRelease() const volatile { }
+#endif
+
+        __forceinline void Spin() const volatile { }
+        __forceinline void Await() const volatile { }
+
+        __forceinline __must_check constexpr bool Check() const volatile
+        { return true; }
+
+        __forceinline void Reset() const volatile { }
+    };
+#endif
+
+    /**
+     *  Busy-waiting synchronization primitive which queues its waiters and
+     *  prevents CPU interrupts on the locking CPU.
+     */
+    template<bool SMP = true>
+    struct QueuedSpinlockUninterruptible
+    {
+    public:
+
+        typedef System::int_cookie_t Cookie;
+        static constexpr Cookie const InvalidCookie = __int_cookie_invalid;
+
+        /*  Constructor(s)  */
+
+        QueuedSpinlockUninterruptible() = default;
+
+        QueuedSpinlockUninterruptible(QueuedSpinlockUninterruptible const &) = delete;
+        QueuedSpinlockUninterruptible & operator =(QueuedSpinlockUninterruptible const &) = delete;
+        QueuedSpinlockUninterruptible(QueuedSpinlockUninterruptible &&) = delete;
+        QueuedSpinlockUninterruptible & operator =(QueuedSpinlockUninterruptible &&) = delete;
+
+        /*  Operations  */
+
+        /**
+         *  Acquire the spinlock, if possible.
+         */
+        __forceinline __must_check bool TryAcquire(Cookie & cookie) volatile
+        {
+            cookie = System::Interrupts::PushDisable();
+
+            if likely(this->Inner.TryAcquire())
+                return true;
+
+            System::Interrupts::RestoreState(cookie);
+            //  If the spinlock was already locked, restore interrupt state.
+
+            return false;
+        }
+
+        /**
+         *  Awaits for the spinlock to be freed.
+         *  Does not acquire the lock.
+         */
+        __forceinline void Spin() const volatile { this->Inner.Spin(); }
+
+        /**
+         *  Checks if the spinlock is free. If not, it awaits.
+         *  Does not acquire the lock.
+         */
+        __forceinline void Await() const volatile { this->Inner.Await(); }
+
+        /**
+         *  Acquire the spinlock, waiting if necessary.
+         */
+        __forceinline __must_check Cookie Acquire() volatile
+        {
+            Cookie const cookie = System::Interrupts::PushDisable();
+
+            this->Inner.Acquire();
+
+            return cookie;
+        }
+
+        /**
+         *  Acquire the spinlock, waiting if necessary.
+         */
+        __forceinline void SimplyAcquire() volatile { this->Inner.Acquire(); }
+
+        /**
+         *  Release the spinlock.
+         */
+        __forceinline void Release(Cookie const cookie) volatile
+        {
+            this->Inner.Release();
+
+            System::Interrupts::RestoreState(cookie);
+        }
+
+        /**
+         *  Release the spinlock.
+         */
+        __forceinline void SimplyRelease() volatile { this->Inner.Release(); }
+
+        /**
+         *  Checks whether the spinlock is free or not.
+         */
+        __forceinline __must_check bool Check() const volatile
+        {
+            return this->Inner.Check();
+        }
+
+        /**
+         *  Reset the spinlock.
+         */
+        __forceinline void Reset() volatile { this->Inner.Reset(); }
+
+        /*  Fields  */
+
+    private:
+
+        QueuedSpinlock<SMP> Inner;
+    };
+
+    //  Hot locks should use these. On a single CPU there is nobody to queue,
+    //  so the smaller ticket locks are used instead.
+
+#if   defined(__BEELZEBUB_SETTINGS_NO_SMP)
+    template<bool SMP = true>
+    using HotSpinlock = Spinlock<SMP>;
+
+    template<bool SMP = true>
+    using HotSpinlockUninterruptible = SpinlockUninterruptible<SMP>;
+#else
+    template<bool SMP = true>
+    using HotSpinlock = QueuedSpinlock<SMP>;
+
+    template<bool SMP = true>
+    using HotSpinlockUninterruptible = QueuedSpinlockUninterruptible<SMP>;
+#endif
+}}
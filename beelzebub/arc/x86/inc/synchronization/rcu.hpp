@@ -0,0 +1,256 @@
+/*
+    Copyright (c) 2015 Alexandru-Mihai Maftei. All rights reserved.
+
+
+    Developed by: Alexandru-Mihai Maftei
+    aka Vercas
+    http://vercas.com | https://github.com/vercas/Beelzebub
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal with the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+      * Redistributions of source code must retain the above copyright notice,
+        this list of conditions and the following disclaimers.
+      * Redistributions in binary form must reproduce the above copyright
+        notice, this list of conditions and the following disclaimers in the
+        documentation and/or other materials provided with the distribution.
+      * Neither the names of Alexandru-Mihai Maftei, Vercas, nor the names of
+        its contributors may be used to endorse or promote products derived from
+        this Software without specific prior written permission.
+
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+    WITH THE SOFTWARE.
+
+    ---
+
+    You may also find the text of this license in "LICENSE.md", along with a more
+    thorough explanation regarding other files.
+*/
+
+/**
+ *  Read-side critical sections merely disable interrupts, so they cannot be
+ *  preempted. Consequently, a CPU which is interrupted, switches threads or
+ *  goes idle cannot be inside one, and that is a quiescent state.
+ *
+ *  Readers must not block, and they must not keep pointers to RCU-protected
+ *  objects past the end of their critical section.
+ */
+
+#pragma once
+
+#include <synchronization/spinlock.hpp>
+#include <system/cpu.hpp>
+#include <kernel.hpp>
+
+#define withRcuRead with(Beelzebub::Synchronization::RcuReadGuard MCATS(_rcu_guard_, __LINE__))
+
+namespace Beelzebub { namespace Synchronization
+{
+    struct RcuHead;
+
+    typedef void (* RcuCallback)(RcuHead * head);
+
+    /**
+     *  Embedded in objects whose freeing is deferred until their readers are
+     *  gone.
+     */
+    struct RcuHead
+    {
+        RcuHead * Next;
+        RcuCallback Callback;
+        uint64_t Period;
+    };
+
+    /**
+     *  Read-copy-update facility.
+     */
+    class Rcu
+    {
+    public:
+
+        typedef System::int_cookie_t Cookie;
+
+        /*  Constructor(s)  */
+
+    protected:
+        Rcu() = default;
+
+    public:
+        Rcu(Rcu const &) = delete;
+        Rcu & operator =(Rcu const &) = delete;
+
+        /*  Read Side  */
+
+        /**
+         *  Enters a read-side critical section. These may be nested.
+         */
+        static __forceinline __must_check Cookie ReadLock()
+        {
+            Cookie const cookie = System::Interrupts::PushDisable();
+
+#if   defined(__BEELZEBUB_SETTINGS_SMP)
+            if unlikely(CpuDataSetUp && System::Cpu::GetData()->RcuIdle.Load(MemoryOrder::Relaxed))
+                ExitIdle();
+            //  Interrupt handlers may read while the CPU is idle.
+#endif
+
+            return cookie;
+        }
+
+        /**
+         *  Leaves a read-side critical section.
+         */
+        static __forceinline void ReadUnlock(Cookie const cookie)
+        {
+            System::Interrupts::RestoreState(cookie);
+        }
+
+        /**
+         *  Reads a pointer published with <see cref="Assign"/>.
+         */
+        template<typename T>
+        static __forceinline T * Dereference(T * const & ptr)
+        {
+            T * const res = *const_cast<T * const volatile *>(&ptr);
+
+            COMPILER_MEMORY_BARRIER();
+
+            return res;
+        }
+
+        /*  Update Side  */
+
+        /**
+         *  Publishes a pointer to an object which is completely initialized.
+         */
+        template<typename T>
+        static __forceinline void Assign(T * & ptr, T * const val)
+        {
+            COMPILER_MEMORY_BARRIER();
+
+            *const_cast<T * volatile *>(&ptr) = val;
+            //  x86 does not reorder stores with older stores.
+        }
+
+#if   defined(__BEELZEBUB_SETTINGS_SMP)
+        /**
+         *  Awaits the end of every read-side critical section which is in
+         *  progress. Must not be called from within one.
+         */
+        static __cold void Synchronize();
+#else
+        static __forceinline void Synchronize() { }
+        //  Read-side critical sections cannot be preempted.
+#endif
+
+        /**
+         *  Invokes the given callback once every read-side critical section in
+         *  progress has ended. Callbacks run with interrupts disabled, on any
+         *  CPU, and must not block. This only queues the callback, so it may be
+         *  called from within a read-side critical section; the timer tick and
+         *  the idle threads invoke it later.
+         */
+        static void Call(RcuHead * const head, RcuCallback const callback);
+
+        /*  Quiescent States  */
+
+#if   defined(__BEELZEBUB_SETTINGS_SMP)
+        /**
+         *  Registers the current CPU; its data must be set up.
+         */
+        static __startup void InitializeCpu();
+
+        /**
+         *  Tells RCU that the current CPU is outside of any read-side critical
+         *  section.
+         */
+        static __forceinline void ReportQuiescentState()
+        {
+            COMPILER_MEMORY_BARRIER();
+
+            System::Cpu::GetData()->RcuQuiescentPeriod.Store(CurrentPeriod.Load(MemoryOrder::Relaxed), MemoryOrder::Relaxed);
+            //  x86 keeps this store after the loads of previous critical sections.
+        }
+
+        /**
+         *  Marks the current CPU as idle, which is an extended quiescent state
+         *  that lasts until it becomes busy again.
+         */
+        static __forceinline void EnterIdle()
+        {
+            System::Cpu::GetData()->RcuIdle.Store(true);
+        }
+
+        static __noinline void ExitIdle();
+#else
+        static __forceinline void InitializeCpu() { }
+        static __forceinline void ReportQuiescentState() { }
+        static __forceinline void EnterIdle() { }
+        static __forceinline void ExitIdle() { }
+#endif
+
+        /**
+         *  Invokes the callbacks whose grace periods have ended. Does nothing
+         *  if another CPU is already at it. Must not be called from within a
+         *  read-side critical section.
+         */
+        static void ProcessCallbacks();
+
+        static __forceinline bool HasCallbacks()
+        {
+            return FirstCallback != nullptr;
+        }
+
+    private:
+
+#if   defined(__BEELZEBUB_SETTINGS_SMP)
+        static uint64_t GetCompletedPeriod();
+#endif
+
+        /*  Fields  */
+
+#if   defined(__BEELZEBUB_SETTINGS_SMP)
+        static Atomic<uint64_t> CurrentPeriod;
+        static System::CpuData * volatile FirstCpu;
+#endif
+
+        static Spinlock<> CallbacksLock;
+        static RcuHead * volatile FirstCallback;
+        static RcuHead * LastCallback;
+    };
+
+    /// <summary>Guards a scope as an RCU read-side critical section.</summary>
+    struct RcuReadGuard
+    {
+        /*  Constructor(s)  */
+
+        __forceinline RcuReadGuard() : Cookie(Rcu::ReadLock()) { }
+
+        RcuReadGuard(RcuReadGuard const &) = delete;
+        RcuReadGuard(RcuReadGuard && other) = delete;
+        RcuReadGuard & operator =(RcuReadGuard const &) = delete;
+        RcuReadGuard & operator =(RcuReadGuard &&) = delete;
+
+        /*  Destructor  */
+
+        __forceinline ~RcuReadGuard()
+        {
+            Rcu::ReadUnlock(this->Cookie);
+        }
+
+    private:
+        /*  Field(s)  */
+
+        Rcu::Cookie const Cookie;
+    };
+}}
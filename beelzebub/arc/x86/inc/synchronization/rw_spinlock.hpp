@@ -40,6 +40,7 @@
 #pragma once
 
 #include <synchronization/atomic.hpp>
+#include <execution/preemption.hpp>
 
 namespace Beelzebub { namespace Synchronization
 {
@@ -78,6 +79,7 @@ namespace Beelzebub { namespace Synchronization
          */
         inline __must_check bool TryAcquireAsReader() volatile
         {
+            PREEMPTION_DISABLE();
             COMPILER_MEMORY_BARRIER();
 
         op_start:
@@ -90,6 +92,7 @@ namespace Beelzebub { namespace Synchronization
 
                 this->Value.FetchSub(Read);
                 //  Take a step back.
+                PREEMPTION_ENABLE();
 
                 return false;
                 //  Fail.
@@ -107,6 +110,7 @@ namespace Beelzebub { namespace Synchronization
          */
         inline void AcquireAsReader() volatile
         {
+            PREEMPTION_DISABLE();
             COMPILER_MEMORY_BARRIER();
 
         op_start:
@@ -135,13 +139,18 @@ namespace Beelzebub { namespace Synchronization
          */
         inline __must_check bool TryAcquireAsWriter() volatile
         {
+            PREEMPTION_DISABLE();
             COMPILER_MEMORY_BARRIER();
 
         op_start:
             uint32_t val = this->Value.Load();
 
             if ((val >= Write) || !this->Value.CmpXchgStrong(val, val | Write))
+            {
+                PREEMPTION_ENABLE();
+
                 return false;
+            }
         op_end:
 
             COMPILER_MEMORY_BARRIER();
@@ -155,6 +164,7 @@ namespace Beelzebub { namespace Synchronization
          */
         inline void AcquireAsWriter() volatile
         {
+            PREEMPTION_DISABLE();
             COMPILER_MEMORY_BARRIER();
 
         op_start:
@@ -231,6 +241,7 @@ namespace Beelzebub { namespace Synchronization
 
             COMPILER_MEMORY_BARRIER();
             ANNOTATE_LOCK_OPERATION_REL;
+            PREEMPTION_ENABLE();
         }
 
         /**
@@ -246,6 +257,7 @@ namespace Beelzebub { namespace Synchronization
 
             COMPILER_MEMORY_BARRIER();
             ANNOTATE_LOCK_OPERATION_REL;
+            PREEMPTION_ENABLE();
         }
 
         /**
@@ -305,15 +317,15 @@ namespace Beelzebub { namespace Synchronization
         /*  Acquisition Operations  */
 
         __forceinline __must_check bool TryAcquireAsReader() volatile
-        { this->ReaderCount = 1; return true; }
+        { PREEMPTION_DISABLE(); this->ReaderCount = 1; return true; }
 
         inline void AcquireAsReader() volatile
-        { this->ReaderCount = 1; }
+        { PREEMPTION_DISABLE(); this->ReaderCount = 1; }
 
         __forceinline __must_check bool TryAcquireAsWriter() volatile
-        { return true; }
+        { PREEMPTION_DISABLE(); return true; }
 
-        __forceinline void AcquireAsWriter() volatile { }
+        __forceinline void AcquireAsWriter() volatile { PREEMPTION_DISABLE(); }
 
         __forceinline bool UpgradeToWriter() volatile
         { this->ReaderCount = 0; return true; }
@@ -321,9 +333,9 @@ namespace Beelzebub { namespace Synchronization
         /*  Release Operations  */
 
         __forceinline void ReleaseAsReader() volatile
-        { this->ReaderCount = 0; }
+        { this->ReaderCount = 0; PREEMPTION_ENABLE(); }
 
-        __forceinline void ReleaseAsWriter() volatile { }
+        __forceinline void ReleaseAsWriter() volatile { PREEMPTION_ENABLE(); }
 
         __forceinline void DowngradeToReader() volatile
         { this->ReaderCount = 1; }
@@ -0,0 +1,118 @@
+/*
+    Copyright (c) 2015 Alexandru-Mihai Maftei. All rights reserved.
+
+
+    Developed by: Alexandru-Mihai Maftei
+    aka Vercas
+    http://vercas.com | https://github.com/vercas/Beelzebub
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal with the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+      * Redistributions of source code must retain the above copyright notice,
+        this list of conditions and the following disclaimers.
+      * Redistributions in binary form must reproduce the above copyright
+        notice, this list of conditions and the following disclaimers in the
+        documentation and/or other materials provided with the distribution.
+      * Neither the names of Alexandru-Mihai Maftei, Vercas, nor the names of
+        its contributors may be used to endorse or promote products derived from
+        this Software without specific prior written permission.
+
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+    WITH THE SOFTWARE.
+
+    ---
+
+    You may also find the text of this license in "LICENSE.md", along with a more
+    thorough explanation regarding other files.
+*/
+
+#pragma once
+
+#include <synchronization/wait_queue.hpp>
+#include <synchronization/atomic.hpp>
+
+namespace Beelzebub { namespace Synchronization
+{
+    /**
+     *  Counting semaphore which blocks its waiters. Released units are handed
+     *  to blocked waiters in FIFO order. When blocking is impossible (e.g.
+     *  before scheduling starts), it spins.
+     */
+    class Semaphore
+    {
+    public:
+
+        typedef void Cookie;
+
+        /*  Statics  */
+
+        static size_t const SpinCount = 256;
+
+        /*  Constructor(s)  */
+
+        inline Semaphore(size_t const count = 0)
+            : Count(count)
+            , Guard()
+            , Waiters()
+        {
+
+        }
+
+        Semaphore(Semaphore const &) = delete;
+        Semaphore & operator =(Semaphore const &) = delete;
+        Semaphore(Semaphore &&) = delete;
+        Semaphore & operator =(Semaphore &&) = delete;
+
+        /*  Operations  */
+
+        /**
+         *  Takes a unit, if one is available.
+         */
+        __hot __must_check bool TryAcquire();
+
+        /**
+         *  Takes a unit, waiting for one if necessary.
+         */
+        __hot void Acquire();
+
+        /**
+         *  Takes a unit, waiting for at most the given number of nanoseconds.
+         */
+        __hot __must_check bool TryAcquire(uint64_t const timeout);
+
+        /**
+         *  Gives back the given number of units, waking up as many waiters.
+         */
+        __hot void Release(size_t count = 1);
+
+        /*  Properties  */
+
+        __forceinline size_t GetCount() const
+        {
+            return this->Count.Load();
+        }
+
+    private:
+
+        __noinline bool AcquireContended(uint64_t const timeout);
+        //  The timeout is `UINT64_MAX` when there is none.
+
+        /*  Fields  */
+
+        Atomic<size_t> Count;
+
+        Spinlock<> Guard;
+        WaitQueue Waiters;
+    };
+}}
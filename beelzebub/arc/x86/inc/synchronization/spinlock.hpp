@@ -40,6 +40,8 @@
 #pragma once
 
 #include <synchronization/lock_guard.hpp>
+#include <synchronization/lock_profiler.hpp>
+#include <execution/preemption.hpp>
 
 namespace Beelzebub { namespace Synchronization
 {
@@ -146,6 +148,8 @@ namespace Beelzebub { namespace Synchronization
          */
         __forceinline __must_check bool TryAcquire() volatile
         {
+            PREEMPTION_DISABLE();
+            LOCK_PROFILING_BEGIN;
             COMPILER_MEMORY_BARRIER();
             
         op_start:
@@ -160,11 +164,17 @@ namespace Beelzebub { namespace Synchronization
                         : "cc" );
 
             if (cmp.Overall != cmpCpy.Overall)
+            {
+                LOCK_PROFILING_CANCELLED;
+                PREEMPTION_ENABLE();
+
                 return false;
+            }
         op_end:
 
             COMPILER_MEMORY_BARRIER();
             ANNOTATE_LOCK_OPERATION_ACQ;
+            LOCK_PROFILING_ACQUIRED(this);
 
             return true;
         }
@@ -220,6 +230,8 @@ namespace Beelzebub { namespace Synchronization
          */
         __forceinline void Acquire() volatile
         {
+            PREEMPTION_DISABLE();
+            LOCK_PROFILING_BEGIN;
             COMPILER_MEMORY_BARRIER();
 
         op_start:
@@ -232,11 +244,15 @@ namespace Beelzebub { namespace Synchronization
             //  It's possible to address the upper word directly.
 
             while (this->Value.Head != myTicket)
+            {
+                LOCK_PROFILING_CONTENDED;
                 asm volatile ( "pause \n\t" : : : "memory" );
+            }
         op_end:
 
             COMPILER_MEMORY_BARRIER();
             ANNOTATE_LOCK_OPERATION_ACQ;
+            LOCK_PROFILING_ACQUIRED(this);
         }
 
         /**
@@ -254,6 +270,8 @@ namespace Beelzebub { namespace Synchronization
 
             COMPILER_MEMORY_BARRIER();
             ANNOTATE_LOCK_OPERATION_REL;
+            LOCK_PROFILING_RELEASED(this);
+            PREEMPTION_ENABLE();
         }
 
         /**
@@ -322,21 +340,37 @@ namespace Beelzebub { namespace Synchronization
 
         /*  Operations  */
 
+#ifdef __BEELZEBUB_SETTINGS_KERNEL_PREEMPTION
+        //  Without other CPUs, only the current thread needs to be kept from
+        //  being switched out.
+
+        __forceinline __must_check bool TryAcquire() const volatile
+        { PREEMPTION_DISABLE(); return true; }
+
+        __forceinline void Acquire() const volatile { PREEMPTION_DISABLE(); }
+        __forceinline void SimplyAcquire() const volatile { PREEMPTION_DISABLE(); }
+
+        __forceinline void Release() const volatile { PREEMPTION_ENABLE(); }
+        __forceinline void SimplyRelease() const volatile { PREEMPTION_ENABLE(); }
+#else
         __forceinline __must_check constexpr bool TryAcquire() const volatile
         { return true; }
 
-        __forceinline void Spin() const volatile { }
-        __forceinline void Await() const volatile { }
-
         __forceinline void Acquire() const volatile { }
         __forceinline void SimplyAcquire() const volatile { }
 
         __forceinline void Release() const volatile { }
         __forceinline void SimplyRelease() const volatile { }
+#endif
+
+        __forceinline void Spin() const volatile { }
+        __forceinline void Await() const volatile { }
 
         __forceinline __must_check constexpr bool Check() const volatile
         { return true; }
 
+        __forceinline void Reset() const volatile { }
+
         /*  Properties  */
 
         __forceinline constexpr spinlock_t GetValue() const volatile
@@ -45,6 +45,7 @@
 #pragma once
 
 #include <synchronization/lock_guard.hpp>
+#include <synchronization/lock_profiler.hpp>
 #include <system/interrupts.hpp>
 
 namespace Beelzebub { namespace Synchronization
@@ -163,7 +164,9 @@ namespace Beelzebub { namespace Synchronization
          */
         __forceinline __must_check bool TryAcquire(Cookie & cookie) volatile
         {
+            LOCK_PROFILING_BEGIN;
             cookie = System::Interrupts::PushDisable();
+            PREEMPTION_DISABLE();
 
             COMPILER_MEMORY_BARRIER();
 
@@ -178,10 +181,12 @@ namespace Beelzebub { namespace Synchronization
                         : [newVal]"r"(newVal)
                         : "cc" );
 
-            if likely(cmp.Overall == cmpCpy.Overall)
+            if unlikely(cmp.Overall != cmpCpy.Overall)
             {
+                LOCK_PROFILING_CANCELLED;
                 System::Interrupts::RestoreState(cookie);
                 //  If the spinlock was already locked, restore interrupt state.
+                PREEMPTION_ENABLE();
 
                 return false;
             }
@@ -189,6 +194,7 @@ namespace Beelzebub { namespace Synchronization
 
             COMPILER_MEMORY_BARRIER();
             ANNOTATE_LOCK_OPERATION_ACQ;
+            LOCK_PROFILING_ACQUIRED(this);
 
             return true;
         }
@@ -244,7 +250,9 @@ namespace Beelzebub { namespace Synchronization
          */
         __forceinline __must_check Cookie Acquire() volatile
         {
+            LOCK_PROFILING_BEGIN;
             Cookie const cookie = System::Interrupts::PushDisable();
+            PREEMPTION_DISABLE();
 
             COMPILER_MEMORY_BARRIER();
 
@@ -258,11 +266,15 @@ namespace Beelzebub { namespace Synchronization
             //  It's possible to address the upper word directly.
 
             while (this->Value.Head != myTicket)
+            {
+                LOCK_PROFILING_CONTENDED;
                 asm volatile ( "pause \n\t" : : : "memory" );
+            }
         op_end:
 
             COMPILER_MEMORY_BARRIER();
             ANNOTATE_LOCK_OPERATION_ACQ;
+            LOCK_PROFILING_ACQUIRED(this);
 
             return cookie;
         }
@@ -272,6 +284,8 @@ namespace Beelzebub { namespace Synchronization
          */
         __forceinline void SimplyAcquire() volatile
         {
+            PREEMPTION_DISABLE();
+            LOCK_PROFILING_BEGIN;
             COMPILER_MEMORY_BARRIER();
 
         op_start:
@@ -284,11 +298,15 @@ namespace Beelzebub { namespace Synchronization
             //  It's possible to address the upper word directly.
 
             while (this->Value.Head != myTicket)
+            {
+                LOCK_PROFILING_CONTENDED;
                 asm volatile ( "pause \n\t" : : : "memory" );
+            }
         op_end:
 
             COMPILER_MEMORY_BARRIER();
             ANNOTATE_LOCK_OPERATION_ACQ;
+            LOCK_PROFILING_ACQUIRED(this);
         }
 
         /**
@@ -306,8 +324,10 @@ namespace Beelzebub { namespace Synchronization
 
             COMPILER_MEMORY_BARRIER();
             ANNOTATE_LOCK_OPERATION_REL;
+            LOCK_PROFILING_RELEASED(this);
 
             System::Interrupts::RestoreState(cookie);
+            PREEMPTION_ENABLE();
         }
 
         /**
@@ -325,6 +345,8 @@ namespace Beelzebub { namespace Synchronization
 
             COMPILER_MEMORY_BARRIER();
             ANNOTATE_LOCK_OPERATION_REL;
+            LOCK_PROFILING_RELEASED(this);
+            PREEMPTION_ENABLE();
         }
 
         /**
@@ -385,16 +407,21 @@ namespace Beelzebub { namespace Synchronization
         /*  Operations  */
 
         __forceinline __must_check bool TryAcquire(Cookie & cookie) const volatile
-        { cookie = System::Interrupts::PushDisable(); return true; }
+        { cookie = System::Interrupts::PushDisable(); PREEMPTION_DISABLE(); return true; }
         __forceinline void Spin() const volatile { }
         __forceinline void Await() const volatile { }
         __forceinline __must_check Cookie Acquire() const volatile
-        { return System::Interrupts::PushDisable(); }
-        __forceinline void SimplyAcquire() const volatile { }
+        {
+            Cookie const cookie = System::Interrupts::PushDisable();
+            PREEMPTION_DISABLE();
+
+            return cookie;
+        }
+        __forceinline void SimplyAcquire() const volatile { PREEMPTION_DISABLE(); }
 
         __forceinline void Release(Cookie const cookie) const volatile
-        { System::Interrupts::RestoreState(cookie); }
-        __forceinline void SimplyRelease() const volatile { }
+        { System::Interrupts::RestoreState(cookie); PREEMPTION_ENABLE(); }
+        __forceinline void SimplyRelease() const volatile { PREEMPTION_ENABLE(); }
         __forceinline __must_check bool Check() const volatile
         { return true; }
     };
@@ -0,0 +1,110 @@
+/*
+    Copyright (c) 2015 Alexandru-Mihai Maftei. All rights reserved.
+
+
+    Developed by: Alexandru-Mihai Maftei
+    aka Vercas
+    http://vercas.com | https://github.com/vercas/Beelzebub
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal with the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+      * Redistributions of source code must retain the above copyright notice,
+        this list of conditions and the following disclaimers.
+      * Redistributions in binary form must reproduce the above copyright
+        notice, this list of conditions and the following disclaimers in the
+        documentation and/or other materials provided with the distribution.
+      * Neither the names of Alexandru-Mihai Maftei, Vercas, nor the names of
+        its contributors may be used to endorse or promote products derived from
+        this Software without specific prior written permission.
+
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+    WITH THE SOFTWARE.
+
+    ---
+
+    You may also find the text of this license in "LICENSE.md", along with a more
+    thorough explanation regarding other files.
+*/
+
+#pragma once
+
+#include <execution/thread.hpp>
+#include <synchronization/spinlock.hpp>
+
+namespace Beelzebub { namespace Synchronization
+{
+    /**
+     *  First-in, first-out queue of threads blocked on a synchronization
+     *  primitive. It is guarded by the primitive's own spinlock, which must be
+     *  held with interrupts disabled during every operation.
+     */
+    struct WaitQueue
+    {
+    public:
+
+        /*  Constructor(s)  */
+
+        inline WaitQueue()
+            : Head(nullptr)
+            , Tail(nullptr)
+        {
+
+        }
+
+        WaitQueue(WaitQueue const &) = delete;
+        WaitQueue & operator =(WaitQueue const &) = delete;
+
+        /*  Operations  */
+
+        /**
+         *  Blocks the current thread at the end of the queue and releases the
+         *  given lock. Returns once another thread wakes it up; the lock is not
+         *  reacquired.
+         */
+        __noinline void Sleep(Spinlock<> & lock);
+
+        /**
+         *  Like the above, but gives up after the given number of nanoseconds.
+         *  Returns false if the thread timed out rather than being woken up.
+         */
+        __noinline bool Sleep(Spinlock<> & lock, uint64_t const timeout);
+
+        /**
+         *  Wakes up the thread at the front of the queue, if any, and returns it.
+         */
+        Execution::Thread * WakeOne();
+
+        /**
+         *  Wakes up every thread in the queue and returns their number.
+         */
+        size_t WakeAll();
+
+        /**
+         *  Takes the given thread out of the queue without waking it up.
+         *  Returns false if it was not in the queue.
+         */
+        bool Remove(Execution::Thread * const thread);
+
+        /*  Properties  */
+
+        __forceinline bool IsEmpty() const { return this->Head == nullptr; }
+
+    private:
+
+        /*  Fields  */
+
+        Execution::Thread * Head;
+        Execution::Thread * Tail;
+    };
+}}
@@ -101,6 +101,7 @@ namespace Beelzebub { namespace System
         static acpi_table_xsdt * XsdtPointer;
         static acpi_table_madt * MadtPointer;
         static acpi_table_srat * SratPointer;
+        static acpi_table_hpet * HpetPointer;
 
 #if   defined(__BEELZEBUB_SETTINGS_SMP)
         static size_t LapicCount;
@@ -134,6 +135,7 @@ namespace Beelzebub { namespace System
 
         static __cold Handle HandleMadt(vaddr_t const vaddr, paddr_t const paddr, SystemDescriptorTableSource const src);
         static __cold Handle HandleSrat(vaddr_t const vaddr, paddr_t const paddr, SystemDescriptorTableSource const src);
+        static __cold Handle HandleHpet(vaddr_t const vaddr, paddr_t const paddr, SystemDescriptorTableSource const src);
 
         /*  Utilities  */
 
@@ -141,5 +143,6 @@ namespace Beelzebub { namespace System
 
     public:
         static __cold Handle FindLapicPaddr(paddr_t & paddr);
+        static __cold Handle FindHpetPaddr(paddr_t & paddr);
     };
 }}
@@ -0,0 +1,115 @@
+/*
+    Copyright (c) 2015 Alexandru-Mihai Maftei. All rights reserved.
+
+
+    Developed by: Alexandru-Mihai Maftei
+    aka Vercas
+    http://vercas.com | https://github.com/vercas/Beelzebub
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal with the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+      * Redistributions of source code must retain the above copyright notice,
+        this list of conditions and the following disclaimers.
+      * Redistributions in binary form must reproduce the above copyright
+        notice, this list of conditions and the following disclaimers in the
+        documentation and/or other materials provided with the distribution.
+      * Neither the names of Alexandru-Mihai Maftei, Vercas, nor the names of
+        its contributors may be used to endorse or promote products derived from
+        this Software without specific prior written permission.
+
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+    WITH THE SOFTWARE.
+
+    ---
+
+    You may also find the text of this license in "LICENSE.md", along with a more
+    thorough explanation regarding other files.
+*/
+
+/**
+ *  Alternative instructions let code be compiled for the baseline CPU while
+ *  using a better instruction sequence when CPUID reports the feature it
+ *  needs. The replacement is copied over the original at boot, and the rest
+ *  of the original is turned into no-ops.
+ *
+ *  Replacements must be position-independent: they are executed from another
+ *  address than the one they are assembled at, so they cannot contain
+ *  relative jumps or calls, nor RIP-relative operands.
+ *
+ *  Usage:
+ *      asm volatile ( ALTERNATIVE("lfence \n\t rdtsc", "rdtscp")
+ *                   : "=a"(low), "=d"(high)
+ *                   : ALTERNATIVE_FEATURE(RDTSCP)
+ *                   : "rcx" );
+ */
+
+#pragma once
+
+#include <system/cpuid.hpp>
+#include <beel/handles.h>
+
+#define ALTERNATIVE(original, replacement)                                  \
+    "661: \n\t" original "\n"                                               \
+    "662: \n\t"                                                             \
+    ".skip -(((665f - 664f) - (662b - 661b)) > 0) * "                       \
+        "((665f - 664f) - (662b - 661b)), 0x90 \n"                          \
+    "663: \n\t"                                                             \
+    ".pushsection .alternatives, \"a\", @progbits \n\t"                     \
+    _GAS_DATA_POINTER " 661b \n\t"                                          \
+    _GAS_DATA_POINTER " 664f \n\t"                                          \
+    _GAS_DATA_POINTER " 663b - 661b \n\t"                                   \
+    _GAS_DATA_POINTER " 665f - 664f \n\t"                                   \
+    _GAS_DATA_POINTER " %c[__alternative_feature] \n\t"                     \
+    ".popsection \n\t"                                                      \
+    ".pushsection .text.alternatives, \"ax\", @progbits \n"                 \
+    "664: \n\t" replacement "\n"                                            \
+    "665: \n\t"                                                             \
+    ".popsection \n\t"
+//  The original is padded so the replacement always fits.
+
+#define ALTERNATIVE_FEATURE(feature)                                        \
+    [__alternative_feature]"i"((uint32_t)(Beelzebub::System::CpuFeature::feature))
+
+namespace Beelzebub { namespace System
+{
+    /**
+     *  <summary>Selects the alternative instructions compiled into the kernel.</summary>
+     */
+    class Alternatives
+    {
+    public:
+        /*  Constructor(s)  */
+
+        Alternatives() = delete;
+        Alternatives(Alternatives const &) = delete;
+        Alternatives & operator =(Alternatives const &) = delete;
+
+        /*  Operations  */
+
+        /**
+         *  <summary>
+         *  Applies the replacements whose features are supported by the
+         *  bootstrap processor. Meant to be called once, during boot.
+         *  </summary>
+         */
+        static __startup Handle Apply(CpuId const & cpuid);
+
+        /*  Properties  */
+
+        /**
+         *  <summary>Gets the number of replacements which were applied.</summary>
+         */
+        static size_t GetAppliedCount();
+    };
+}}
@@ -39,6 +39,8 @@
 
 #pragma once
 
+#include <metaprogramming.h>
+
 namespace Beelzebub { namespace System
 {
     //  Differs on AMD64 and IA-32.
@@ -46,4 +48,8 @@ namespace Beelzebub { namespace System
 
     //  Common to x86.
     bool TurnIntoNoOp(void * start, void * end, bool useJump = true);
+
+    //  Copies code over kernel text, which may be write-protected, and pads
+    //  the rest of the given region with no-ops. Does not stop other CPUs.
+    bool WriteCode(void * location, size_t size, void const * code, size_t codeSize);
 }}
@@ -46,9 +46,15 @@
 #include <system/msrs.hpp>
 
 #include <execution/thread.hpp>
+#include <execution/run_queue.hpp>
+#include <execution/work_queue.hpp>
+#include <system/timers/timer_wheel.hpp>
+#include <system/cross_cpu.hpp>
+#include <system/topology.hpp>
 #include <exceptions.hpp>
 
 #include <synchronization/atomic.hpp>
+#include <synchronization/mpsc_ring.hpp>
 
 #define REGFUNC1(regl, regu, type)                                   \
 static __forceinline type MCATS2(Get, regu)()                        \
@@ -100,6 +106,11 @@ static __forceinline type MCATS2(Get, regu)()                        \
     return ret;                                                      \
 }
 
+namespace Beelzebub { namespace Execution
+{
+    struct Tasklet;
+}}
+
 namespace Beelzebub { namespace System
 {
     typedef uint16_t   seg_t; //  Segment register.
@@ -123,6 +134,33 @@ namespace Beelzebub { namespace System
         bool X2ApicMode;
 
         Execution::Thread * LastExtendedStateThread;
+
+        CpuTopology Topology;
+
+        Execution::RunQueue SchedulerQueue;
+
+        uint64_t TimerDeadline;
+        //  TSC value of the pending LAPIC timer event, or 0 if none is.
+        size_t volatile TimerTicks;
+        System::Timers::TimerWheel Timers;
+
+        //  Used to defer work out of interrupt handlers.
+        uint32_t volatile SoftIrqPending;
+        bool volatile SoftIrqActive;
+        Execution::Tasklet * Tasklets;
+        Execution::WorkQueue Work;
+
+#if   defined(__BEELZEBUB_SETTINGS_SMP)
+        //  Used to run functions requested by other CPUs.
+        Synchronization::MpscRing<CrossCpuCall *, CrossCpu::QueueCapacity> CallQueue;
+        bool volatile CallRequested;
+        uint32_t LapicId;
+
+        //  Used by RCU to detect quiescent states.
+        CpuData * RcuNext;
+        Synchronization::Atomic<uint64_t> RcuQuiescentPeriod;
+        Synchronization::Atomic<bool> RcuIdle;
+#endif
     };
 
     /**
@@ -66,6 +66,28 @@ namespace Beelzebub { namespace System
             asm volatile ( "hlt \n\t" : : : "memory" );
         }
 
+        static __forceinline void EnableInterruptsAndHalt()
+        {
+            asm volatile ( "sti \n\t"
+                           "hlt \n\t" : : : "memory" );
+            //  Interrupts are only recognized after the instruction which
+            //  follows `sti`, so none can be taken before halting.
+        }
+
+        static __forceinline void Monitor(void const volatile * const addr)
+        {
+            asm volatile ( "monitor \n\t"
+                         : : "a"(addr), "c"(0), "d"(0) : "memory" );
+        }
+
+        static __forceinline void EnableInterruptsAndMwait(uint32_t const hint)
+        {
+            asm volatile ( "sti \n\t"
+                           "mwait \n\t"
+                         : : "a"(hint), "c"(0) : "memory" );
+            //  Same as above; a write to the monitored line also wakes it.
+        }
+
         static __forceinline void DoNothing()
         {
             asm volatile ( "pause \n\t" : : : "memory" );
@@ -363,6 +385,26 @@ namespace Beelzebub { namespace System
 
 #endif
 
+        static __forceinline void GsIncrementSize(uintptr_t const off)
+        {
+            asm volatile ( "add %1, %%gs:%0 \n\t"
+                         :
+                         : "m"(*(reinterpret_cast<size_t *>(off))), "r"((size_t)1)
+                         : "memory", "cc" );
+        }
+        /// <summary>Returns true if the value reached zero.</summary>
+        static __forceinline bool GsDecrementSize(uintptr_t const off)
+        {
+            bool res;
+
+            asm volatile ( "sub %2, %%gs:%1 \n\t"
+                         : "=@ccz"(res)
+                         : "m"(*(reinterpret_cast<size_t *>(off))), "r"((size_t)1)
+                         : "memory" );
+
+            return res;
+        }
+
         static __forceinline uint32_t FarGet32(uint16_t const sel
                                              , uintptr_t const off)
         {
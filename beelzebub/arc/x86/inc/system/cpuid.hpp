@@ -142,7 +142,7 @@ namespace Beelzebub { namespace System
 
         uint32_t VersionInformation, FeatureFlagsStandardB;
         uint32_t ExtendedSignature, FeatureFlagsExtendedB, FeatureFlagsExtendedC;
-        uint32_t FeatureIntegers[3];
+        uint32_t FeatureIntegers[4];
 
         /*  Info extraction  */
 
@@ -0,0 +1,195 @@
+/*
+    Copyright (c) 2015 Alexandru-Mihai Maftei. All rights reserved.
+
+
+    Developed by: Alexandru-Mihai Maftei
+    aka Vercas
+    http://vercas.com | https://github.com/vercas/Beelzebub
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal with the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+      * Redistributions of source code must retain the above copyright notice,
+        this list of conditions and the following disclaimers.
+      * Redistributions in binary form must reproduce the above copyright
+        notice, this list of conditions and the following disclaimers in the
+        documentation and/or other materials provided with the distribution.
+      * Neither the names of Alexandru-Mihai Maftei, Vercas, nor the names of
+        its contributors may be used to endorse or promote products derived from
+        this Software without specific prior written permission.
+
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+    WITH THE SOFTWARE.
+
+    ---
+
+    You may also find the text of this license in "LICENSE.md", along with a more
+    thorough explanation regarding other files.
+*/
+
+#pragma once
+
+#include <system/interrupts.hpp>
+#include <beel/handles.h>
+
+namespace Beelzebub { namespace System
+{
+    struct CrossCpuCall;
+
+    typedef void (* CrossCpuFunction)(void * cookie);
+
+    /**
+     *  <summary>Set of CPUs, by index.</summary>
+     */
+    struct CpuMask
+    {
+        /*  Statics  */
+
+        static size_t const Capacity = 256;
+        static size_t const WordCount = Capacity / 64;
+
+        /*  Constructor(s)  */
+
+        inline CpuMask() : Words() { }
+
+        /*  Operations  */
+
+        __forceinline CpuMask & Set(size_t const cpu)
+        {
+            this->Words[cpu / 64] |= (uint64_t)1 << (cpu % 64);
+
+            return *this;
+        }
+
+        __forceinline CpuMask & Clear(size_t const cpu)
+        {
+            this->Words[cpu / 64] &= ~((uint64_t)1 << (cpu % 64));
+
+            return *this;
+        }
+
+        __forceinline bool Get(size_t const cpu) const
+        {
+            return 0 != (this->Words[cpu / 64] & ((uint64_t)1 << (cpu % 64)));
+        }
+
+        /**
+         *  <summary>
+         *  Obtains the first CPU in the set whose index is no lower than the
+         *  given one, or <see cref="Capacity"/> if there is none.
+         *  </summary>
+         */
+        inline size_t FindNext(size_t const start) const
+        {
+            for (size_t i = start / 64; i < WordCount; ++i)
+            {
+                uint64_t word = this->Words[i];
+
+                if (i == start / 64)
+                    word &= ~(uint64_t)0 << (start % 64);
+
+                if (word != 0)
+                    return i * 64 + (size_t)__builtin_ctzll(word);
+            }
+
+            return Capacity;
+        }
+
+        inline size_t GetCount() const
+        {
+            size_t count = 0;
+
+            for (size_t i = 0; i < WordCount; ++i)
+                count += (size_t)__builtin_popcountll(this->Words[i]);
+
+            return count;
+        }
+
+        /*  Fields  */
+
+        uint64_t Words[WordCount];
+    };
+
+    /**
+     *  <summary>Runs functions on other CPUs.</summary>
+     *  <remarks>
+     *  Every CPU has a lock-free queue of incoming calls. A single IPI is sent
+     *  to a CPU until it starts draining its queue, so calls made in quick
+     *  succession share it. The functions run in the interrupt handler, with
+     *  interrupts disabled, and must not block.
+     *  Calls which are not awaited are limited in number; making one when
+     *  none are left waits for an earlier one to finish.
+     *  </remarks>
+     */
+    class CrossCpu
+    {
+    public:
+        /*  Statics  */
+
+        static uint8_t const Vector = 0xD9;
+        //  Just below the LAPIC timer vector.
+
+        static size_t const QueueCapacity = 64;
+        static size_t const AsyncCallCount = 64;
+
+        /*  Interrupt Handler  */
+
+        static void Handler(INTERRUPT_HANDLER_ARGS);
+
+        /*  Constructor(s)  */
+
+    protected:
+        CrossCpu() = default;
+
+    public:
+        CrossCpu(CrossCpu const &) = delete;
+        CrossCpu & operator =(CrossCpu const &) = delete;
+
+        /*  Initialization  */
+
+        /**
+         *  <summary>
+         *  Makes the current CPU reachable by calls. Its LAPIC must be
+         *  initialized.
+         *  </summary>
+         */
+        static __startup void InitializeCpu();
+
+        /*  Operations  */
+
+        /**
+         *  <summary>
+         *  Runs the given function on the CPU with the given index, waiting
+         *  for it to return unless told otherwise.
+         *  </summary>
+         */
+        static Handle CallOnCpu(size_t const cpu, CrossCpuFunction const func
+            , void * const cookie, bool const wait = true);
+
+        /**
+         *  <summary>Runs the given function on every CPU in the mask.</summary>
+         *  <remarks>
+         *  The current CPU runs it too if it is in the mask, with interrupts
+         *  disabled, before waiting for the others.
+         *  </remarks>
+         */
+        static Handle CallOnMask(CpuMask const & mask, CrossCpuFunction const func
+            , void * const cookie, bool const wait = true);
+
+        /**
+         *  <summary>Runs the given function on every CPU, including this one.</summary>
+         */
+        static Handle CallOnAll(CrossCpuFunction const func, void * const cookie
+            , bool const wait = true);
+    };
+}}
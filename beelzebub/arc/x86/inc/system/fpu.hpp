@@ -112,7 +112,8 @@ namespace Beelzebub { namespace System
 
     /**
      *  Represents the XSAVE header added to the end of the legacy area by the
-     *  XSAVE instruction.
+     *  XSAVE instruction. The second bitmap is XCOMP_BV, whose top bit is set
+     *  for areas in the compacted format.
      */
     struct XsaveHeader
     {
@@ -174,6 +175,24 @@ namespace Beelzebub { namespace System
         };
     };
 
+    /**
+     *  The instructions used to save the extended state of threads, from the
+     *  least to the most efficient.
+     */
+    enum class FpuSaveMode : uint8_t
+    {
+        Fxsave = 0,
+        Xsave = 1,
+        //  Skips components in their initial state and, since the last XRSTOR
+        //  from the same area, unmodified ones.
+        Xsaveopt = 2,
+        //  Compacted format, which only has room for the enabled components.
+        //  Skips components in their initial state.
+        Xsavec = 3,
+        //  Compacted format with both optimizations above; requires XRSTORS.
+        Xsaves = 4,
+    };
+
     /**
      *  Contains functions for interacting with the x87 FPU.
      */
@@ -190,9 +209,11 @@ namespace Beelzebub { namespace System
 
         /*  Statics  */
 
-        static bool Available, Sse, Avx, Xsave;
+        static bool Available, Sse, Avx, Avx512, Xsave;
         static size_t StateSize, StateAlignment;
 
+        static FpuSaveMode SaveMode;
+
         static XsaveRfbm Xcr0;
 
         /*  Initialization  */
@@ -99,5 +99,6 @@ namespace Beelzebub { namespace System { namespace InterruptControllers
         static void SendIpi(LapicIcr icr);
 
         LAPICREGFUNC1(SpuriousInterruptVector, Svr, LapicSvr)
+        LAPICREGFUNC1(Timer, LvtTimer, LapicLvtTimer)
     };
 }}}
@@ -40,6 +40,7 @@
 #pragma once
 
 #include <system/idt.hpp>
+#include <execution/preemption.hpp>
 
 namespace Beelzebub { namespace System
 {
@@ -297,7 +298,10 @@ namespace Beelzebub { namespace System
     {
         /*  Constructor(s)  */
 
-        inline InterruptGuard() : Cookie(Interrupts::PushDisable()) { }
+        inline InterruptGuard() : Cookie(Interrupts::PushDisable())
+        {
+            PREEMPTION_DISABLE();
+        }
 
         InterruptGuard(InterruptGuard const &) = delete;
         InterruptGuard(InterruptGuard && other) = delete;
@@ -309,6 +313,9 @@ namespace Beelzebub { namespace System
         inline ~InterruptGuard()
         {
             Interrupts::RestoreState(this->Cookie);
+
+            PREEMPTION_ENABLE();
+            //  After interrupts are restored, so a pending reschedule can happen.
         }
 
     private:
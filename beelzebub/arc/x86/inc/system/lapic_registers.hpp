@@ -102,6 +102,78 @@ namespace Beelzebub { namespace System
         uint32_t Value;
     };
 
+    /**
+     *  <summary>Known operating modes of the LAPIC timer.</summary>
+     */
+    enum class LapicTimerMode
+        : uint8_t
+    {
+        OneShot     = 0,
+        Periodic    = 1,
+        TscDeadline = 2,
+    };
+
+    /**
+     *  <summary>
+     *  Known values for the Divide Configuration Register of the LAPIC timer.
+     *  </summary>
+     */
+    enum class LapicTimerDivisor
+        : uint32_t
+    {
+        By2   = 0x0,
+        By4   = 0x1,
+        By8   = 0x2,
+        By16  = 0x3,
+        By32  = 0x8,
+        By64  = 0x9,
+        By128 = 0xA,
+        By1   = 0xB,
+    };
+
+    /**
+     *  <summary>
+     *  Represents the contents of the LVT Timer Register of the LAPIC.
+     *  </summary>
+     */
+    struct LapicLvtTimer
+    {
+        /*  Bit structure:
+         *       0 -   7 : Vector
+         *       8 -  11 : Reserved (must be 0)
+         *      12       : Delivery Status
+         *      13 -  15 : Reserved (must be 0)
+         *      16       : Masked
+         *      17 -  18 : Timer Mode
+         *      19 -  31 : Reserved (must be 0)
+         */
+
+        /*  Properties  */
+
+        BITFIELD_DEFAULT_1OEx(12, DeliveryStatus          , 32)
+        BITFIELD_DEFAULT_1WEx(16, Masked                  , 32)
+
+        BITFIELD_DEFAULT_2WEx( 0,  8, uint8_t       , Vector, 32)
+        BITFIELD_DEFAULT_4WEx(17,  2, LapicTimerMode, Mode  , 32)
+
+        /*  Constructor  */
+
+        /**
+         *  Creates a new LAPIC LVT timer structure from the given raw value.
+         */
+        inline explicit constexpr LapicLvtTimer(uint32_t const val)
+            : Value(val)
+        {
+            
+        }
+
+        /*  Field(s)  */
+
+    //private:
+
+        uint32_t Value;
+    };
+
     /**
      *  <summary>APIC interrupt delivery modes.</summary>
      */
@@ -74,6 +74,10 @@ namespace Beelzebub { namespace System
     {
         //  (L)APIC/x2APIC
         IA32_APIC_BASE      = 0x0000001B,
+        //  Target of the local APIC timer in TSC-deadline mode
+        IA32_TSC_DEADLINE   = 0x000006E0,
+        //  Supervisor state components managed by XSAVES/XRSTORS
+        IA32_XSS            = 0x00000DA0,
 
         //  Extended Feature Enables
         IA32_EFER           = 0xC0000080,
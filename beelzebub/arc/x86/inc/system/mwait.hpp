@@ -0,0 +1,108 @@
+/*
+    Copyright (c) 2015 Alexandru-Mihai Maftei. All rights reserved.
+
+
+    Developed by: Alexandru-Mihai Maftei
+    aka Vercas
+    http://vercas.com | https://github.com/vercas/Beelzebub
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal with the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+      * Redistributions of source code must retain the above copyright notice,
+        this list of conditions and the following disclaimers.
+      * Redistributions in binary form must reproduce the above copyright
+        notice, this list of conditions and the following disclaimers in the
+        documentation and/or other materials provided with the distribution.
+      * Neither the names of Alexandru-Mihai Maftei, Vercas, nor the names of
+        its contributors may be used to endorse or promote products derived from
+        this Software without specific prior written permission.
+
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+    WITH THE SOFTWARE.
+
+    ---
+
+    You may also find the text of this license in "LICENSE.md", along with a more
+    thorough explanation regarding other files.
+*/
+
+#pragma once
+
+#include <system/cpu_instructions.hpp>
+
+namespace Beelzebub { namespace System
+{
+    /**
+     *  <summary>Idles the CPU with MONITOR/MWAIT, when available.</summary>
+     *  <remarks>
+     *  An idle CPU waits on a cache line which other CPUs write to wake it up,
+     *  instead of sending an interrupt; see `Scheduler::Idle`. C-states deeper than C1 are only used
+     *  when the LAPIC timer keeps running in them.
+     *  </remarks>
+     */
+    class Mwait
+    {
+    public:
+        /*  Statics  */
+
+        static bool Available;
+
+        static uint32_t DeepHint;
+        //  For the deepest usable C-state.
+        static uint32_t DeepState;
+        //  Its number; 1 when only C1 is usable.
+
+        static uint32_t const ShallowHint = 0x00;
+        //  C1, which every implementation supports.
+
+        static uint64_t const ShallowThreshold = 50000;
+        //  In nanoseconds; idling until a timer event closer than this stays
+        //  in C1, because exiting deeper C-states takes longer.
+
+        /*  Constructor(s)  */
+
+    protected:
+        Mwait() = default;
+
+    public:
+        Mwait(Mwait const &) = delete;
+        Mwait & operator =(Mwait const &) = delete;
+
+        /*  Initialization  */
+
+        /**
+         *  <summary>
+         *  Checks for MONITOR/MWAIT and picks the C-state hints from CPUID leaf
+         *  5. Requires the TSC to be calibrated.
+         *  </summary>
+         */
+        static __cold bool Initialize();
+
+        /*  Idling  */
+
+        /**
+         *  <summary>Obtains the hint for idling until the given TSC deadline.</summary>
+         */
+        static __forceinline uint32_t GetHint(uint64_t const deadline)
+        {
+            if (deadline != 0 && deadline < CpuInstructions::Rdtsc() + ThresholdTicks)
+                return ShallowHint;
+
+            return DeepHint;
+        }
+
+    private:
+        static uint64_t ThresholdTicks;
+    };
+}}
@@ -0,0 +1,119 @@
+/*
+    Copyright (c) 2015 Alexandru-Mihai Maftei. All rights reserved.
+
+
+    Developed by: Alexandru-Mihai Maftei
+    aka Vercas
+    http://vercas.com | https://github.com/vercas/Beelzebub
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal with the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+      * Redistributions of source code must retain the above copyright notice,
+        this list of conditions and the following disclaimers.
+      * Redistributions in binary form must reproduce the above copyright
+        notice, this list of conditions and the following disclaimers in the
+        documentation and/or other materials provided with the distribution.
+      * Neither the names of Alexandru-Mihai Maftei, Vercas, nor the names of
+        its contributors may be used to endorse or promote products derived from
+        this Software without specific prior written permission.
+
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+    WITH THE SOFTWARE.
+
+    ---
+
+    You may also find the text of this license in "LICENSE.md", along with a more
+    thorough explanation regarding other files.
+*/
+
+/**
+ *  Static keys are flags which are read very often and changed very rarely,
+ *  such as whether tracing or expensive debug checks are on.
+ *
+ *  Every test of a key compiles to a 5-byte no-op, which falls through to the
+ *  code for the key being disabled. Changing the key rewrites each of these
+ *  into a jump to the code for the key being enabled, or back, with all CPUs
+ *  stopped. Testing a key therefore costs no memory access and no branch.
+ *
+ *  Keys must be objects with static storage, and they always start disabled.
+ */
+
+#pragma once
+
+#include <beel/handles.h>
+#include <metaprogramming.h>
+
+/**
+ *  Evaluates to true if the given static key is enabled.
+ */
+#define STATIC_KEY_ENABLED(key) ({                                          \
+    __label__ __static_key_yes, __static_key_done;                          \
+    bool __static_key_result;                                               \
+    asm goto ( "1: .byte 0x0F, 0x1F, 0x44, 0x00, 0x00 \n\t"                 \
+               ".pushsection .static_keys, \"a\", @progbits \n\t"           \
+               _GAS_DATA_POINTER " 1b \n\t"                                 \
+               _GAS_DATA_POINTER " %l1 \n\t"                                \
+               _GAS_DATA_POINTER " %c0 \n\t"                                \
+               ".popsection \n\t"                                           \
+             : : "i"(&(key)) : : __static_key_yes );                        \
+    __static_key_result = false;                                            \
+    goto __static_key_done;                                                 \
+__static_key_yes:                                                           \
+    __static_key_result = true;                                             \
+__static_key_done:                                                          \
+    __static_key_result; })
+
+namespace Beelzebub { namespace System
+{
+    /**
+     *  <summary>A flag tested by patching code instead of reading memory.</summary>
+     */
+    struct StaticKey
+    {
+        /*  Constants  */
+
+        static size_t const SiteSize = 5;
+
+        /*  Constructor(s)  */
+
+        StaticKey() = default;
+        StaticKey(StaticKey const &) = delete;
+        StaticKey & operator =(StaticKey const &) = delete;
+
+        /*  Operations  */
+
+        /**
+         *  <summary>Patches every test of this key to the given value.</summary>
+         *  <remarks>
+         *  This stops the machine, so mind the restrictions of
+         *  <see cref="StopMachine::Run"/>.
+         *  </remarks>
+         */
+        Handle Set(bool const value);
+
+        inline Handle Enable() { return this->Set(true); }
+        inline Handle Disable() { return this->Set(false); }
+
+        /*  Properties  */
+
+        /**
+         *  <summary>Reads the value of the key from memory.</summary>
+         */
+        inline bool IsEnabled() const { return this->Enabled; }
+
+        /*  Fields  */
+
+        bool volatile Enabled;
+    };
+}}
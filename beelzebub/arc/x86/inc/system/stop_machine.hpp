@@ -0,0 +1,95 @@
+/*
+    Copyright (c) 2015 Alexandru-Mihai Maftei. All rights reserved.
+
+
+    Developed by: Alexandru-Mihai Maftei
+    aka Vercas
+    http://vercas.com | https://github.com/vercas/Beelzebub
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal with the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+      * Redistributions of source code must retain the above copyright notice,
+        this list of conditions and the following disclaimers.
+      * Redistributions in binary form must reproduce the above copyright
+        notice, this list of conditions and the following disclaimers in the
+        documentation and/or other materials provided with the distribution.
+      * Neither the names of Alexandru-Mihai Maftei, Vercas, nor the names of
+        its contributors may be used to endorse or promote products derived from
+        this Software without specific prior written permission.
+
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+    WITH THE SOFTWARE.
+
+    ---
+
+    You may also find the text of this license in "LICENSE.md", along with a more
+    thorough explanation regarding other files.
+*/
+
+#pragma once
+
+#include <system/interrupts.hpp>
+#include <beel/handles.h>
+
+namespace Beelzebub { namespace System
+{
+    typedef void (* StopMachineFunction)(void * cookie);
+
+    /**
+     *  <summary>
+     *  Runs a function on one CPU while all the others wait with interrupts
+     *  disabled, so it may change state which any CPU may be executing or
+     *  reading, such as kernel code.
+     *  </summary>
+     *  <remarks>
+     *  The other CPUs are stopped with an NMI, so they arrive even while they
+     *  spin with interrupts disabled, e.g. on a lock held by a stopped CPU.
+     *  </remarks>
+     */
+    class StopMachine
+    {
+    public:
+        /*  Interrupt Handler  */
+
+        /**
+         *  <summary>
+         *  Handles NMIs, parking the CPU if the machine is being stopped and
+         *  treating the NMI as a miscellaneous interrupt otherwise.
+         *  </summary>
+         */
+        static void Handler(INTERRUPT_HANDLER_ARGS);
+
+        /*  Constructor(s)  */
+
+    protected:
+        StopMachine() = default;
+
+    public:
+        StopMachine(StopMachine const &) = delete;
+        StopMachine & operator =(StopMachine const &) = delete;
+
+        /*  Operations  */
+
+        /**
+         *  <summary>Runs the given function with every CPU stopped.</summary>
+         *  <remarks>
+         *  The function must not touch the NMI path, and must not await locks
+         *  which may be held by other CPUs, as they are stopped wherever the
+         *  NMI found them.
+         *  The other CPUs serialize their instruction stream before resuming.
+         *  </remarks>
+         */
+        static Handle Run(StopMachineFunction const func, void * const cookie);
+    };
+}}
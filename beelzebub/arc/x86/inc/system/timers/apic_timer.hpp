@@ -0,0 +1,137 @@
+/*
+    Copyright (c) 2015 Alexandru-Mihai Maftei. All rights reserved.
+
+
+    Developed by: Alexandru-Mihai Maftei
+    aka Vercas
+    http://vercas.com | https://github.com/vercas/Beelzebub
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal with the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+      * Redistributions of source code must retain the above copyright notice,
+        this list of conditions and the following disclaimers.
+      * Redistributions in binary form must reproduce the above copyright
+        notice, this list of conditions and the following disclaimers in the
+        documentation and/or other materials provided with the distribution.
+      * Neither the names of Alexandru-Mihai Maftei, Vercas, nor the names of
+        its contributors may be used to endorse or promote products derived from
+        this Software without specific prior written permission.
+
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+    WITH THE SOFTWARE.
+
+    ---
+
+    You may also find the text of this license in "LICENSE.md", along with a more
+    thorough explanation regarding other files.
+*/
+
+#pragma once
+
+#include <system/interrupts.hpp>
+#include <system/timers/tsc.hpp>
+#include <beel/handles.h>
+
+namespace Beelzebub { namespace System { namespace Timers
+{
+    /**
+     *  <summary>Drives the timer of every local APIC in one-shot mode.</summary>
+     *  <remarks>
+     *  Each CPU has at most one pending event, which is the earliest deadline
+     *  anyone asked for. Whoever needs a later one asks again after the event.
+     *  Deadlines are TSC values; TSC-deadline mode is used when available.
+     *  </remarks>
+     */
+    class ApicTimer
+    {
+    public:
+        /*  Statics  */
+
+        static uint8_t const Vector = 0xDA;
+        //  Just below the scheduler vector.
+
+        static uint64_t Frequency;
+        //  Of the divided LAPIC timer clock, in hertz. Zero when the LAPIC
+        //  timers are unusable, in which case arming does nothing.
+
+        static bool TscDeadlineMode;
+
+        /*  Interrupt Handler  */
+
+        static void Handler(INTERRUPT_HANDLER_ARGS_FULL);
+
+        /*  Constructor(s)  */
+
+    protected:
+        ApicTimer() = default;
+
+    public:
+        ApicTimer(ApicTimer const &) = delete;
+        ApicTimer & operator =(ApicTimer const &) = delete;
+
+        /*  Initialization  */
+
+        /**
+         *  <summary>
+         *  Measures the frequency of the LAPIC timer against the TSC, which
+         *  must be calibrated already.
+         *  </summary>
+         */
+        static __cold Handle Calibrate();
+
+        /**
+         *  <summary>Prepares the LAPIC timer of the current CPU.</summary>
+         */
+        static __cold void InitializeCpu();
+
+        /*  Events  */
+
+        /**
+         *  <summary>
+         *  Does the work of a timer event on the current CPU, which is either
+         *  a LAPIC timer interrupt or a tick of the fallback timer.
+         *  </summary>
+         */
+        static __hot void Tick(IsrState * const state);
+
+        /**
+         *  <summary>
+         *  Requests an interrupt on the current CPU once the TSC reaches the
+         *  given value, unless an earlier one is pending.
+         *  </summary>
+         *  <remarks>Interrupts must be disabled.</remarks>
+         */
+        static __hot void Arm(uint64_t const deadline);
+
+        /**
+         *  <summary>Cancels the pending event of the current CPU.</summary>
+         *  <remarks>Interrupts must be disabled.</remarks>
+         */
+        static __hot void Disarm();
+
+        /*  Utilities  */
+
+        /**
+         *  <summary>Obtains the TSC value which is the given time away.</summary>
+         */
+        static inline uint64_t GetDeadline(uint64_t const microseconds)
+        {
+            return CpuInstructions::Rdtsc() + Tsc::FromNanoseconds(microseconds * 1000);
+        }
+
+    private:
+        static uint64_t TscToTimer;
+        //  32.32 fixed-point ratio of the two frequencies.
+    };
+}}}
@@ -0,0 +1,154 @@
+/*
+    Copyright (c) 2015 Alexandru-Mihai Maftei. All rights reserved.
+
+
+    Developed by: Alexandru-Mihai Maftei
+    aka Vercas
+    http://vercas.com | https://github.com/vercas/Beelzebub
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal with the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+      * Redistributions of source code must retain the above copyright notice,
+        this list of conditions and the following disclaimers.
+      * Redistributions in binary form must reproduce the above copyright
+        notice, this list of conditions and the following disclaimers in the
+        documentation and/or other materials provided with the distribution.
+      * Neither the names of Alexandru-Mihai Maftei, Vercas, nor the names of
+        its contributors may be used to endorse or promote products derived from
+        this Software without specific prior written permission.
+
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+    WITH THE SOFTWARE.
+
+    ---
+
+    You may also find the text of this license in "LICENSE.md", along with a more
+    thorough explanation regarding other files.
+*/
+
+#pragma once
+
+#include <system/interrupts.hpp>
+#include <beel/handles.h>
+
+namespace Beelzebub { namespace System { namespace Timers
+{
+    /**
+     *  <summary>Drives the High Precision Event Timer described by ACPI.</summary>
+     *  <remarks>
+     *  The main counter is read through memory, which is much faster than
+     *  the port I/O of the PIT. The first comparator can also tick every CPU
+     *  periodically, when the LAPIC timers cannot.
+     *  </remarks>
+     */
+    class Hpet
+    {
+    public:
+        /*  Statics  */
+
+        static vaddr_t Address;
+        //  Of the registers; null when there is no HPET.
+
+        static uint64_t Frequency;
+        //  Of the main counter, in hertz.
+        static uint32_t Period;
+        //  Of the main counter, in femtoseconds.
+        static uint64_t CounterMask;
+        //  The main counter may only have 32 bits.
+
+        static size_t ComparatorCount;
+        static bool LegacyReplacement;
+        //  The first comparators can take the place of the PIT and RTC IRQs.
+
+        static uint8_t Irq;
+        //  Of the ticking comparator; 0xFF when it is not ticking.
+
+        /*  Interrupt Handler  */
+
+        static void IrqHandler(INTERRUPT_HANDLER_ARGS_FULL);
+
+        /*  Constructor(s)  */
+
+    protected:
+        Hpet() = default;
+
+    public:
+        Hpet(Hpet const &) = delete;
+        Hpet & operator =(Hpet const &) = delete;
+
+        /*  Initialization  */
+
+        /**
+         *  <summary>Maps the registers found by ACPI and starts the main counter.</summary>
+         */
+        static __cold Handle Initialize();
+
+        /**
+         *  <summary>
+         *  Makes the first comparator interrupt every CPU with the LAPIC timer
+         *  vector, once per the given number of nanoseconds.
+         *  </summary>
+         *  <remarks>
+         *  Meant for when the LAPIC timers are unusable. The interrupt is
+         *  delivered through the PIC to the BSP, which forwards it as an IPI.
+         *  </remarks>
+         */
+        static __cold Handle StartTicking(uint64_t const period);
+
+        /*  Counter  */
+
+        static __forceinline bool IsAvailable()
+        {
+            return Address != nullvaddr;
+        }
+
+        /**
+         *  <summary>Reads the main counter, which must be available.</summary>
+         */
+        static __forceinline uint64_t GetCounter()
+        {
+#if   defined(__BEELZEBUB__ARCH_AMD64)
+            return *((uint64_t volatile *)(Address + MainCounterOffset));
+#else
+            uint32_t volatile * const counter = (uint32_t volatile *)(Address + MainCounterOffset);
+            uint32_t high, low;
+
+            do
+            {
+                high = counter[1];
+                low = counter[0];
+            } while (high != counter[1]);
+            //  The low half may carry into the high one between the reads.
+
+            return ((uint64_t)high << 32) | low;
+#endif
+        }
+
+        /**
+         *  <summary>Converts the given number of counter ticks into nanoseconds.</summary>
+         */
+        static __forceinline uint64_t ToNanoseconds(uint64_t const ticks)
+        {
+            return (ticks / Frequency) * 1000000000ULL
+                + (ticks % Frequency) * 1000000000ULL / Frequency;
+        }
+
+    private:
+        static size_t const MainCounterOffset = 0x0F0;
+
+        static uint64_t TickLength;
+        static uint64_t NextTick;
+        //  In counter ticks.
+    };
+}}}
@@ -176,6 +176,21 @@ namespace Beelzebub { namespace System { namespace Timers
 
         static __cold void SendCommand(PitCommand const cmd);
 
+        /*  Countdown  */
+
+        /**
+         *  <summary>
+         *  Starts counting down the given number of periods on channel 2,
+         *  which raises no interrupts.
+         *  </summary>
+         */
+        static __cold void StartCountdown(uint16_t const count);
+
+        /**
+         *  <summary>Determines whether the last countdown has reached zero.</summary>
+         */
+        static __cold bool IsCountdownOver();
+
         /*  Utilities  */
 
         static inline DividerFrequency GetRealFrequency(uint32_t freq)
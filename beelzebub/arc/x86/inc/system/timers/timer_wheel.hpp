@@ -0,0 +1,250 @@
+/*
+    Copyright (c) 2015 Alexandru-Mihai Maftei. All rights reserved.
+
+
+    Developed by: Alexandru-Mihai Maftei
+    aka Vercas
+    http://vercas.com | https://github.com/vercas/Beelzebub
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal with the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+      * Redistributions of source code must retain the above copyright notice,
+        this list of conditions and the following disclaimers.
+      * Redistributions in binary form must reproduce the above copyright
+        notice, this list of conditions and the following disclaimers in the
+        documentation and/or other materials provided with the distribution.
+      * Neither the names of Alexandru-Mihai Maftei, Vercas, nor the names of
+        its contributors may be used to endorse or promote products derived from
+        this Software without specific prior written permission.
+
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+    WITH THE SOFTWARE.
+
+    ---
+
+    You may also find the text of this license in "LICENSE.md", along with a more
+    thorough explanation regarding other files.
+*/
+
+#pragma once
+
+#include <synchronization/spinlock.hpp>
+
+namespace Beelzebub { namespace Execution
+{
+    class Thread;
+}}
+
+namespace Beelzebub { namespace System { namespace Timers
+{
+    struct Timer;
+    struct TimerWheel;
+
+    typedef void (*TimerFunction)(Timer * const timer);
+
+    /**
+     *  <summary>A function which runs at a given time, once or periodically.</summary>
+     *  <remarks>
+     *  Timer functions run in the timer thread of a CPU, with interrupts
+     *  enabled, so they may take locks and wake threads up.
+     *  </remarks>
+     */
+    struct Timer
+    {
+    public:
+
+        /*  Constructor(s)  */
+
+        inline Timer(TimerFunction const func = nullptr, void * const cookie = nullptr)
+            : Function(func)
+            , Cookie(cookie)
+            , Pinned(false)
+            , Next(nullptr)
+            , Previous(nullptr)
+            , List(nullptr)
+            , Wheel(nullptr)
+            , Expiry(0)
+            , Period(0)
+            , RunningOn(nullptr)
+        {
+
+        }
+
+        Timer(Timer const &) = delete;
+        Timer & operator =(Timer const &) = delete;
+
+        /*  Operations  */
+
+        /**
+         *  <summary>
+         *  Makes the function run after the given delay, and then after every
+         *  period unless it is zero. Both are in nanoseconds.
+         *  </summary>
+         *  <remarks>
+         *  A pending timer is rescheduled. The timer is handled by the current
+         *  CPU, until the latter goes idle if the timer is not pinned.
+         *  </remarks>
+         */
+        __hot void Start(uint64_t const delay, uint64_t const period = 0);
+
+        /**
+         *  <summary>
+         *  Stops the timer, waiting for its function to return if it is running
+         *  on another thread.
+         *  </summary>
+         *  <returns>True if the timer was pending; otherwise false.</returns>
+         */
+        __hot bool Cancel();
+
+        /*  Properties  */
+
+        __forceinline bool IsPending() const { return this->List != nullptr; }
+
+        /*  Fields  */
+
+        TimerFunction Function;
+        void * Cookie;
+
+        bool Pinned;
+        //  Stays on the CPU which started it.
+
+    private:
+
+        Timer * Next;
+        Timer * Previous;
+        Timer * * List;
+        //  Head of the slot or batch holding this timer; null when not pending.
+
+        TimerWheel * volatile Wheel;
+        uint64_t Expiry;    //  In wheel ticks.
+        uint64_t Period;    //  In nanoseconds.
+
+        Execution::Thread * volatile RunningOn;
+
+        friend struct TimerWheel;
+    };
+
+    /**
+     *  <summary>Pending timers of a CPU, sorted by expiry in cascading levels.</summary>
+     *  <remarks>
+     *  Each level has as many slots as there are bits in a word, and every
+     *  slot of a level spans a whole turn of the level below. Timers only move
+     *  down when the lower level wraps around, so starting and cancelling take
+     *  constant time.
+     *  </remarks>
+     */
+    struct TimerWheel
+    {
+    public:
+
+        /*  Statics  */
+
+        static size_t const LevelBits = 6;
+        static size_t const SlotCount = (size_t)1 << LevelBits;
+        static size_t const LevelCount = 4;
+
+        static uint32_t const ResolutionShift = 20;
+        //  A tick of the wheel lasts 2^20 nanoseconds, about a millisecond.
+
+        static size_t const WorkerStackPages = 4;
+
+        /*  Constructor(s)  */
+
+        inline TimerWheel()
+            : Lock()
+            , Current(0)
+            , Count(0)
+            , Occupied()
+            , Slots()
+            , Expired(nullptr)
+            , Worker(nullptr)
+        {
+
+        }
+
+        TimerWheel(TimerWheel const &) = delete;
+        TimerWheel & operator =(TimerWheel const &) = delete;
+
+        /*  Initialization  */
+
+        /**
+         *  <summary>
+         *  Starts the timer thread of the current CPU, which uses the given
+         *  storage. Requires the scheduler to manage this CPU.
+         *  </summary>
+         */
+        static __startup void InitializeCpu(Execution::Thread * const worker);
+
+        /*  Events  */
+
+        /**
+         *  <summary>
+         *  Moves expired timers of the current CPU to its timer thread, and
+         *  arms the LAPIC timer for the next expiry. Called by the timer
+         *  interrupt handler.
+         *  </summary>
+         */
+        static __hot void Tick();
+
+        /**
+         *  <summary>Arms the LAPIC timer for the next expiry on the current CPU.</summary>
+         *  <remarks>Interrupts must be disabled.</remarks>
+         */
+        static void Rearm();
+
+        /**
+         *  <summary>Moves the unpinned timers of the current CPU to another one.</summary>
+         *  <remarks>Interrupts must be disabled.</remarks>
+         */
+        static void Migrate(TimerWheel * const target);
+
+        /*  Properties  */
+
+        __forceinline size_t GetCount() const { return this->Count; }
+
+    private:
+
+        /*  Slots  */
+
+        void Insert(Timer * const timer);
+        void Remove(Timer * const timer);
+        void Cascade(size_t const level, size_t const index);
+        void Advance(uint64_t const now);
+        uint64_t GetNextExpiry() const;
+
+        void PushExpired(Timer * const timer);
+        Timer * PopExpired();
+
+        static void * WorkerEntryPoint(void * const arg);
+
+        /*  Fields  */
+
+        Synchronization::Spinlock<> Lock;
+
+        uint64_t Current;
+        //  The next tick to process.
+        size_t Count;
+        //  Timers in slots.
+
+        uint64_t Occupied[LevelCount];
+        Timer * Slots[LevelCount][SlotCount];
+
+        Timer * Expired;
+        //  Waiting for the timer thread.
+
+        Execution::Thread * Worker;
+
+        friend struct Timer;
+    };
+}}}
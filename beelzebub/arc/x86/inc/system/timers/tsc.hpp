@@ -0,0 +1,187 @@
+/*
+    Copyright (c) 2015 Alexandru-Mihai Maftei. All rights reserved.
+
+
+    Developed by: Alexandru-Mihai Maftei
+    aka Vercas
+    http://vercas.com | https://github.com/vercas/Beelzebub
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal with the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+      * Redistributions of source code must retain the above copyright notice,
+        this list of conditions and the following disclaimers.
+      * Redistributions in binary form must reproduce the above copyright
+        notice, this list of conditions and the following disclaimers in the
+        documentation and/or other materials provided with the distribution.
+      * Neither the names of Alexandru-Mihai Maftei, Vercas, nor the names of
+        its contributors may be used to endorse or promote products derived from
+        this Software without specific prior written permission.
+
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+    WITH THE SOFTWARE.
+
+    ---
+
+    You may also find the text of this license in "LICENSE.md", along with a more
+    thorough explanation regarding other files.
+*/
+
+#pragma once
+
+#include <system/timers/hpet.hpp>
+#include <system/cpu_instructions.hpp>
+#include <beel/handles.h>
+
+namespace Beelzebub { namespace System { namespace Timers
+{
+    /**
+     *  <summary>Turns the time-stamp counter into the clock of the system.</summary>
+     *  <remarks>
+     *  Conversions between ticks and nanoseconds use precomputed 32-bit
+     *  multipliers and shifts, so reading the time costs one `rdtsc`.
+     *  A TSC which is not invariant or not synchronized is replaced by the
+     *  HPET as the clock, when possible.
+     *  </remarks>
+     */
+    class Tsc
+    {
+    public:
+        /*  Statics  */
+
+        static uint64_t Frequency;
+        //  In hertz.
+
+        static bool Invariant;
+        //  Ticks at a constant rate regardless of power states.
+        static bool Synchronized;
+        //  No CPU was seen behind another.
+        static uint64_t MaximumWarp;
+        //  In ticks; largest difference seen between CPUs.
+
+        static bool HpetClock;
+        //  The monotonic clock reads the HPET, because the TSC is unreliable.
+
+        /*  Constructor(s)  */
+
+    protected:
+        Tsc() = default;
+
+    public:
+        Tsc(Tsc const &) = delete;
+        Tsc & operator =(Tsc const &) = delete;
+
+        /*  Initialization  */
+
+        /**
+         *  <summary>
+         *  Measures the frequency of the TSC against the HPET, or against the
+         *  PIT when there is no HPET.
+         *  </summary>
+         */
+        static __cold Handle Calibrate();
+
+        /**
+         *  <summary>
+         *  Compares the TSCs of the BSP and of an AP which is being brought up.
+         *  Both must call this, right after the AP passes the bring-up barrier.
+         *  </summary>
+         */
+        static __cold void CheckWarp(bool const bsp);
+
+        /**
+         *  <summary>
+         *  Makes the monotonic clock read the HPET if the TSC is unreliable,
+         *  carrying on from the current time. Meant to be called after every
+         *  CPU went through the warp check, and before any other reads time.
+         *  </summary>
+         *  <returns>True if the HPET is the clock now; otherwise false.</returns>
+         */
+        static __cold bool SelectClock();
+
+        /*  Properties  */
+
+        /**
+         *  <summary>
+         *  Determines whether the TSC ticks at a constant rate and agrees
+         *  between CPUs, so it can serve as the clock and timer deadlines.
+         *  </summary>
+         */
+        static __forceinline bool IsReliable()
+        {
+            return Invariant && Synchronized;
+        }
+
+        /*  Time  */
+
+        /**
+         *  <summary>Obtains the time passed since calibration, in nanoseconds.</summary>
+         */
+        static __forceinline uint64_t GetMonotonicNanoseconds()
+        {
+            if unlikely(HpetClock)
+                return HpetBase + Hpet::ToNanoseconds(Hpet::GetCounter() - HpetOrigin);
+
+            return ToNanoseconds(CpuInstructions::Rdtsc() - Origin);
+        }
+
+        /**
+         *  <summary>
+         *  Obtains the value of the current CPU's TSC at the given monotonic
+         *  time.
+         *  </summary>
+         */
+        static __forceinline uint64_t GetTimestamp(uint64_t const nanoseconds)
+        {
+            if unlikely(HpetClock)
+            {
+                uint64_t const now = GetMonotonicNanoseconds();
+
+                return CpuInstructions::Rdtsc()
+                    + (nanoseconds > now ? FromNanoseconds(nanoseconds - now) : 0);
+                //  The TSC does not follow the clock, but it is good enough to
+                //  measure the short time until the deadline.
+            }
+
+            return Origin + FromNanoseconds(nanoseconds);
+        }
+
+        /*  Conversions  */
+
+        static __forceinline uint64_t ToNanoseconds(uint64_t const ticks)
+        {
+            return Scale(ticks, NanosecondMultiplier, NanosecondShift);
+        }
+
+        static __forceinline uint64_t FromNanoseconds(uint64_t const nanoseconds)
+        {
+            return Scale(nanoseconds, TickMultiplier, TickShift);
+        }
+
+    private:
+        static __forceinline uint64_t Scale(uint64_t const val, uint64_t const mul, uint32_t const shift)
+        {
+            return (((val >> 32) * mul) << (32 - shift))
+                 + (((val & 0xFFFFFFFFU) * mul) >> shift);
+            //  Same as `val * mul >> shift` without a 128-bit product, since
+            //  `mul` fits in 32 bits.
+        }
+
+        static uint64_t Origin;
+        static uint64_t HpetOrigin, HpetBase;
+        //  Main counter value when the HPET became the clock, and the time then.
+
+        static uint64_t NanosecondMultiplier, TickMultiplier;
+        static uint32_t NanosecondShift, TickShift;
+    };
+}}}
@@ -0,0 +1,148 @@
+/*
+    Copyright (c) 2015 Alexandru-Mihai Maftei. All rights reserved.
+
+
+    Developed by: Alexandru-Mihai Maftei
+    aka Vercas
+    http://vercas.com | https://github.com/vercas/Beelzebub
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal with the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+      * Redistributions of source code must retain the above copyright notice,
+        this list of conditions and the following disclaimers.
+      * Redistributions in binary form must reproduce the above copyright
+        notice, this list of conditions and the following disclaimers in the
+        documentation and/or other materials provided with the distribution.
+      * Neither the names of Alexandru-Mihai Maftei, Vercas, nor the names of
+        its contributors may be used to endorse or promote products derived from
+        this Software without specific prior written permission.
+
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+    WITH THE SOFTWARE.
+
+    ---
+
+    You may also find the text of this license in "LICENSE.md", along with a more
+    thorough explanation regarding other files.
+*/
+
+#pragma once
+
+#include <system/cross_cpu.hpp>
+#include <terminals/base.hpp>
+
+namespace Beelzebub { namespace System
+{
+    struct CpuData;
+
+    /**
+     *  <summary>Levels of the CPU topology, from the innermost.</summary>
+     */
+    enum class TopologyLevel : uint8_t
+    {
+        //  The very same logical CPU.
+        Thread = 0,
+        //  SMT siblings, which share a core.
+        Core = 1,
+        //  Share a level 2 cache.
+        L2 = 2,
+        //  Share the last-level cache.
+        Llc = 3,
+        //  Share a package.
+        Package = 4,
+        //  Only share the system.
+        System = 5,
+    };
+
+    /**
+     *  <summary>Where a logical CPU sits in the system.</summary>
+     *  <remarks>
+     *  Every identifier is the APIC ID of the CPU with the bits of the levels
+     *  below shifted out, so identifiers are unique system-wide. The masks
+     *  include the CPU itself, and each one includes those of the levels
+     *  below it.
+     *  </remarks>
+     */
+    struct CpuTopology
+    {
+    public:
+
+        /*  Constructor(s)  */
+
+        inline CpuTopology()
+            : ApicId(0)
+            , SmtShift(0)
+            , PackageShift(0)
+            , L2Shift(0)
+            , LlcShift(0)
+            , CoreMask()
+            , L2Mask()
+            , LlcMask()
+            , PackageMask()
+        {
+
+        }
+
+        CpuTopology(CpuTopology const &) = delete;
+        CpuTopology & operator =(CpuTopology const &) = delete;
+
+        /*  Initialization  */
+
+        /**
+         *  <summary>
+         *  Decodes the topology of the current CPU, and adds it to the masks
+         *  of the CPUs which were initialized before it.
+         *  </summary>
+         */
+        static __startup void InitializeCpu();
+
+        /*  Registry  */
+
+        /**
+         *  <summary>Obtains the data of the CPU with the given index, if initialized.</summary>
+         */
+        static CpuData * GetCpu(size_t const index);
+
+        /*  Queries  */
+
+        /**
+         *  <summary>Obtains the innermost level shared with the given CPU.</summary>
+         */
+        TopologyLevel GetSharedLevel(CpuTopology const & other) const;
+
+        __forceinline uint32_t GetCoreId() const { return this->ApicId >> this->SmtShift; }
+        __forceinline uint32_t GetL2Id() const { return this->ApicId >> this->L2Shift; }
+        __forceinline uint32_t GetLlcId() const { return this->ApicId >> this->LlcShift; }
+        __forceinline uint32_t GetPackageId() const { return this->ApicId >> this->PackageShift; }
+
+        /*  Debug  */
+
+        __cold Terminals::TerminalWriteResult PrintToTerminal(Terminals::TerminalBase * const term) const;
+
+        /*  Fields  */
+
+        uint32_t ApicId;
+        //  Initial (x2)APIC ID, as reported by CPUID.
+
+        uint8_t SmtShift;
+        uint8_t PackageShift;
+        uint8_t L2Shift;
+        uint8_t LlcShift;
+
+        CpuMask CoreMask;       //  SMT siblings.
+        CpuMask L2Mask;
+        CpuMask LlcMask;
+        CpuMask PackageMask;
+    };
+}}
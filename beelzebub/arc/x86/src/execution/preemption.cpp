@@ -0,0 +1,103 @@
+/*
+    Copyright (c) 2015 Alexandru-Mihai Maftei. All rights reserved.
+
+
+    Developed by: Alexandru-Mihai Maftei
+    aka Vercas
+    http://vercas.com | https://github.com/vercas/Beelzebub
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal with the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+      * Redistributions of source code must retain the above copyright notice,
+        this list of conditions and the following disclaimers.
+      * Redistributions in binary form must reproduce the above copyright
+        notice, this list of conditions and the following disclaimers in the
+        documentation and/or other materials provided with the distribution.
+      * Neither the names of Alexandru-Mihai Maftei, Vercas, nor the names of
+        its contributors may be used to endorse or promote products derived from
+        this Software without specific prior written permission.
+
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+    WITH THE SOFTWARE.
+
+    ---
+
+    You may also find the text of this license in "LICENSE.md", along with a more
+    thorough explanation regarding other files.
+*/
+
+#ifdef __BEELZEBUB_SETTINGS_KERNEL_PREEMPTION
+
+#include <execution/preemption.hpp>
+#include <execution/scheduler.hpp>
+#include <execution/yield.hpp>
+#include <system/cpu.hpp>
+#include <kernel.hpp>
+
+#include <debug.hpp>
+
+using namespace Beelzebub;
+using namespace Beelzebub::Execution;
+using namespace Beelzebub::System;
+
+/***********************
+    Preemption class
+***********************/
+
+/*  Operations  */
+
+void Preemption::InitializeCpu()
+{
+    CpuData * const data = Cpu::GetData();
+
+    data->PreemptCount = 0;
+    data->NeedReschedule = false;
+    //  Locks taken while `CpuDataSetUp` was being set may have left the count
+    //  unbalanced.
+}
+
+void Preemption::Preempt()
+{
+    if (!Scheduling || GetCount() != 0 || !Interrupts::AreEnabled())
+        return;
+    //  The request stays pending; the next interrupt or preemption point
+    //  will honour it.
+
+    Cpu::GetData()->NeedReschedule = false;
+
+    Yield::Now();
+}
+
+/*  Interrupt Return  */
+
+void PreemptOnInterruptReturn(IsrState * const state)
+{
+    if (!CpuDataSetUp || !Scheduling)
+        return;
+
+    CpuData * const data = Cpu::GetData();
+
+    if likely(!data->NeedReschedule)
+        return;
+
+    if (data->PreemptCount != 0 || 0 == (state->RFLAGS & (uint64_t)(1 << 9)))
+        return;
+    //  The interrupted code is in a critical section. It will be switched out
+    //  when it leaves it.
+
+    Scheduler::Schedule(state);
+    //  This clears the request.
+}
+
+#endif
@@ -0,0 +1,661 @@
+/*
+    Copyright (c) 2015 Alexandru-Mihai Maftei. All rights reserved.
+
+
+    Developed by: Alexandru-Mihai Maftei
+    aka Vercas
+    http://vercas.com | https://github.com/vercas/Beelzebub
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal with the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+      * Redistributions of source code must retain the above copyright notice,
+        this list of conditions and the following disclaimers.
+      * Redistributions in binary form must reproduce the above copyright
+        notice, this list of conditions and the following disclaimers in the
+        documentation and/or other materials provided with the distribution.
+      * Neither the names of Alexandru-Mihai Maftei, Vercas, nor the names of
+        its contributors may be used to endorse or promote products derived from
+        this Software without specific prior written permission.
+
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+    WITH THE SOFTWARE.
+
+    ---
+
+    You may also find the text of this license in "LICENSE.md", along with a more
+    thorough explanation regarding other files.
+*/
+
+#include <execution/scheduler.hpp>
+#include <execution/yield.hpp>
+#include <execution/preemption.hpp>
+#include <execution/soft_irq.hpp>
+#include <system/cpu.hpp>
+#include <system/mwait.hpp>
+#include <system/interrupt_controllers/lapic.hpp>
+#include <system/timers/apic_timer.hpp>
+#include <system/timers/timer_wheel.hpp>
+#include <synchronization/rcu.hpp>
+#include <kernel.hpp>
+
+#include <debug.hpp>
+
+using namespace Beelzebub;
+using namespace Beelzebub::Execution;
+using namespace Beelzebub::Synchronization;
+using namespace Beelzebub::System;
+using namespace Beelzebub::System::InterruptControllers;
+using namespace Beelzebub::System::Timers;
+
+static RunQueue * FirstQueue = nullptr;
+
+static __forceinline RunQueue * GetLocalQueue()
+{
+    return &(Cpu::GetData()->SchedulerQueue);
+}
+
+static __forceinline RunQueue * GetFirstQueue()
+{
+    return __atomic_load_n(&FirstQueue, __ATOMIC_ACQUIRE);
+}
+
+/*********************
+    RunQueue struct
+*********************/
+
+/*  Operations  */
+
+void RunQueue::Push(Thread * const thread)
+{
+    size_t const prio = (size_t)thread->Priority;
+
+    thread->RunNext = nullptr;
+
+    if (this->Tails[prio] == nullptr)
+        this->Heads[prio] = thread;
+    else
+        this->Tails[prio]->RunNext = thread;
+
+    this->Tails[prio] = thread;
+    this->Occupied |= 1U << prio;
+
+    if (thread->Priority != ThreadPriority::Idle)
+        ++this->Length;
+}
+
+Thread * RunQueue::Pop(ThreadPriority const lowest)
+{
+    uint32_t const eligible = this->Occupied & ((2U << (size_t)lowest) - 1U);
+
+    if (eligible == 0)
+        return nullptr;
+
+    size_t const prio = (size_t)__builtin_ctz(eligible);
+    Thread * const thread = this->Heads[prio];
+
+    if ((this->Heads[prio] = thread->RunNext) == nullptr)
+    {
+        this->Tails[prio] = nullptr;
+        this->Occupied &= ~(1U << prio);
+    }
+
+    thread->RunNext = nullptr;
+
+    if (thread->Priority != ThreadPriority::Idle)
+        --this->Length;
+
+    return thread;
+}
+
+Thread * RunQueue::PopStealable()
+{
+    for (size_t prio = 0; prio < (size_t)ThreadPriority::Idle; ++prio)
+    {
+        Thread * prev = nullptr, * thread = this->Heads[prio];
+
+        while (thread != nullptr && (thread->Pinned || thread == this->Departed))
+        {
+            prev = thread;
+            thread = thread->RunNext;
+        }
+
+        if (thread == nullptr)
+            continue;
+
+        if (prev == nullptr)
+            this->Heads[prio] = thread->RunNext;
+        else
+            prev->RunNext = thread->RunNext;
+
+        if (this->Tails[prio] == thread)
+            this->Tails[prio] = prev;
+
+        if (this->Heads[prio] == nullptr)
+            this->Occupied &= ~(1U << prio);
+
+        thread->RunNext = nullptr;
+        --this->Length;
+
+        return thread;
+    }
+
+    return nullptr;
+}
+
+/*  Cross-CPU  */
+
+#if   defined(__BEELZEBUB_SETTINGS_SMP)
+static void Kick(RunQueue * const rq)
+{
+    if (rq->Polling.Load(MemoryOrder::Relaxed))
+    {
+        rq->WakeSignal = 1;
+
+        return;
+    }
+    //  The owner is waiting on its wake line, so writing it is enough.
+
+    Lapic::SendIpi(LapicIcr(0)
+    .SetDeliveryMode(InterruptDeliveryModes::Fixed)
+    .SetDestinationShorthand(IcrDestinationShorthand::None)
+    .SetAssert(true)
+    .SetVector(Scheduler::Vector)
+    .SetDestination(rq->LapicId));
+}
+
+/**
+ *  Obtains how far apart the owners of two queues are in the CPU topology.
+ */
+static __forceinline size_t GetDistance(RunQueue const * const a, RunQueue const * const b)
+{
+    return (size_t)a->Cpu->Topology.GetSharedLevel(b->Cpu->Topology);
+}
+
+/**
+ *  Tells whether an SMT sibling of the owner of the given queue is running a
+ *  thread, which would compete with the owner for the core.
+ */
+static bool IsCoreBusy(RunQueue const * const rq)
+{
+    CpuMask const & siblings = rq->Cpu->Topology.CoreMask;
+
+    for (size_t i = siblings.FindNext(0); i < CpuMask::Capacity; i = siblings.FindNext(i + 1))
+    {
+        CpuData * const other = CpuTopology::GetCpu(i);
+
+        if (other != nullptr && other != rq->Cpu
+            && !other->SchedulerQueue.Idle.Load(MemoryOrder::Relaxed))
+            return true;
+    }
+
+    return false;
+}
+
+/**
+ *  Makes sure a thread just added to the given queue is noticed: an idle owner
+ *  is woken up, otherwise an idle CPU is sent to take it. Idle CPUs which
+ *  share a cache with the queue are sent first, and idle cores before the
+ *  idle siblings of busy cores.
+ */
+static void Announce(RunQueue * const rq, RunQueue * const local)
+{
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    //  Either the idle CPU sees the new thread before halting, or this sees it
+    //  idle.
+
+    if (rq->Idle.Load(MemoryOrder::Relaxed))
+    {
+        if (rq != local)
+            Kick(rq);
+        //  An interrupted idle thread checks its queue before halting again.
+
+        return;
+    }
+
+    RunQueue * best = nullptr;
+    size_t bestCost = SIZE_MAX;
+
+    for (RunQueue * other = GetFirstQueue(); other != nullptr; other = other->Next)
+        if (other != local && other != rq && other->Idle.Load(MemoryOrder::Relaxed))
+        {
+            size_t const distance = GetDistance(other, rq);
+            size_t const cost = (distance > (size_t)TopologyLevel::Llc ? 16 : 0)
+                              + (IsCoreBusy(other) ? 8 : 0)
+                              + distance;
+
+            if (cost < bestCost)
+            {
+                best = other;
+                bestCost = cost;
+            }
+        }
+
+    if (best != nullptr)
+        Kick(best);
+}
+
+/**
+ *  Moves a thread from another CPU into the given one. The closest CPUs in the
+ *  topology are robbed first, because their caches are shared; the longest
+ *  queue at the same distance goes first.
+ */
+static bool Steal(RunQueue * const rq)
+{
+    RunQueue * victim = nullptr;
+    size_t longest = 0, closest = SIZE_MAX;
+
+    for (RunQueue * other = GetFirstQueue(); other != nullptr; other = other->Next)
+    {
+        size_t const length = other->Length;
+
+        if (other == rq || length == 0)
+            continue;
+
+        size_t const distance = GetDistance(other, rq);
+
+        if (distance < closest || (distance == closest && length > longest))
+        {
+            victim = other;
+            longest = length;
+            closest = distance;
+        }
+    }
+
+    if (victim == nullptr || !victim->Lock.TryAcquire())
+        return false;
+    //  A busy lock means the victim is busy with its queue, so it is left alone.
+
+    Thread * const thread = victim->PopStealable();
+
+    victim->Lock.Release();
+
+    if (thread == nullptr)
+        return false;
+
+    Thread * expected = thread;
+
+    __atomic_compare_exchange_n(&(victim->Cpu->LastExtendedStateThread), &expected
+        , (Thread *)nullptr, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED);
+    //  Its registers may still hold the thread's extended state, which will be
+    //  stale if the thread ever returns.
+
+    thread->Queue = rq;
+
+    withLock (rq->Lock)
+        rq->Push(thread);
+
+    ++rq->StealCount;
+
+    return true;
+}
+#else
+static __forceinline void Announce(RunQueue * const, RunQueue * const) { }
+#endif
+
+/**
+ *  Ends the time slice of the current thread.
+ */
+static __forceinline void Expire(IsrState * const state)
+{
+#ifdef __BEELZEBUB_SETTINGS_KERNEL_PREEMPTION
+    (void)state;
+
+    Preemption::RequestReschedule();
+    //  The switch happens on the way out of the interrupt, or when the
+    //  interrupted thread enables preemption again.
+#else
+    Scheduler::Schedule(state);
+#endif
+}
+
+/**********************
+    Scheduler class
+**********************/
+
+/*  Interrupt Handler  */
+
+void Scheduler::Handler(INTERRUPT_HANDLER_ARGS_FULL)
+{
+    Rcu::ReportQuiescentState();
+    //  Read-side critical sections cannot be interrupted.
+
+    Expire(state);
+
+    Lapic::EndOfInterrupt();
+}
+
+/*  Initialization  */
+
+void Scheduler::InitializeCpu(Thread * const initial)
+{
+    CpuData * const data = Cpu::GetData();
+    RunQueue * const rq = &(data->SchedulerQueue);
+
+    rq->LapicId = Lapic::GetId();
+
+    initial->Pinned = true;
+    initial->Queue = rq;
+    initial->Running = true;
+
+    rq->Cpu = data;
+
+    RunQueue * first = GetFirstQueue();
+
+    do rq->Next = first;
+    while (!__atomic_compare_exchange_n(&FirstQueue, &first, rq
+        , true, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED));
+    //  `first` is refreshed by every failed exchange.
+}
+
+/*  Operations  */
+
+void Scheduler::Schedule(IsrState * const state)
+{
+    if unlikely(!Scheduling)
+        return;
+
+    if unlikely(SoftIrq::IsActive())
+    {
+        ApicTimer::Arm(ApicTimer::GetDeadline(SliceLength));
+
+        return;
+    }
+    //  Bottom halves are running on the stack of the thread which was last
+    //  switched out, or of the current one. Either must stay put until they
+    //  finish.
+
+    RunQueue * const rq = GetLocalQueue();
+    Thread * const current = Cpu::GetThread();
+
+    if unlikely(rq->Cpu == nullptr || current == nullptr)
+        return;
+
+#ifdef __BEELZEBUB_SETTINGS_KERNEL_PREEMPTION
+    Cpu::GetData()->NeedReschedule = false;
+    //  Also keeps the return path of this interrupt from scheduling again.
+#endif
+
+    Thread * next;
+
+    withLock (rq->Lock)
+    {
+        rq->Departed = nullptr;
+        //  This CPU has returned from the interrupt which did the last switch.
+
+        bool const runnable = !current->Blocked;
+
+        next = rq->Pop(runnable ? current->Priority : ThreadPriority::Idle);
+        //  Threads of the same priority take turns.
+
+        if (next != nullptr)
+        {
+            if (runnable)
+                rq->Push(current);
+
+            current->Running = false;
+            next->Running = true;
+            //  Wakers check these under the lock.
+
+            rq->Departed = current;
+            rq->Idle.Store(next->Priority == ThreadPriority::Idle, MemoryOrder::Relaxed);
+
+            ++rq->SwitchCount;
+        }
+    }
+
+    if ((next != nullptr ? next : current)->Priority == ThreadPriority::Idle)
+    {
+        ApicTimer::Disarm();
+        TimerWheel::Rearm();
+    }
+    else
+        ApicTimer::Arm(ApicTimer::GetDeadline(SliceLength));
+    //  Idle CPUs only wake up for their timers.
+
+    if (next == nullptr)
+        return;
+    //  The current thread carries on, even if blocked; it will yield again.
+
+    current->State = *state;
+
+    current->SwitchTo(next, state);
+}
+
+void Scheduler::Tick(IsrState * const state)
+{
+    Expire(state);
+}
+
+Handle Scheduler::Enqueue(Thread * const thread)
+{
+    if (thread->Queue != nullptr)
+        return HandleResult::ThreadAlreadyLinked;
+
+    RunQueue * const local = GetLocalQueue();
+
+    assert_or(local->Cpu != nullptr, "The scheduler does not manage this CPU yet!")
+    {
+        return HandleResult::UnsupportedOperation;
+    }
+
+    RunQueue * rq = local;
+
+#if   defined(__BEELZEBUB_SETTINGS_SMP)
+    if (!thread->Pinned)
+    {
+        size_t best = SIZE_MAX;
+
+        for (RunQueue * other = GetFirstQueue(); other != nullptr; other = other->Next)
+        {
+            size_t const load = other->Length + (other->Idle.Load(MemoryOrder::Relaxed) ? 0 : 1);
+            size_t const cost = load * 16
+                              + (IsCoreBusy(other) ? 8 : 0)
+                              + GetDistance(other, local);
+            //  The least loaded CPU wins. Between equals, a whole idle core
+            //  beats a thread whose sibling is busy, and then the closest to
+            //  this CPU wins, as it may share the caches of the waker.
+
+            if (cost < best)
+            {
+                rq = other;
+                best = cost;
+            }
+        }
+    }
+#endif
+
+    withInterrupts (false)
+    {
+        withLock (rq->Lock)
+        {
+            thread->Queue = rq;
+            rq->Push(thread);
+        }
+
+        Announce(rq, local);
+    }
+
+    return HandleResult::Okay;
+}
+
+void Scheduler::Block()
+{
+    Thread * const self = Cpu::GetThread();
+
+    while (self->Blocked)
+    {
+        Yield::Now();
+
+        CpuInstructions::DoNothing();
+    }
+
+    //  The yield returns immediately if this CPU has nothing else to run.
+}
+
+static void WakeSleeper(Timer * const timer)
+{
+    Scheduler::Wake((Thread *)(timer->Cookie));
+}
+
+void Scheduler::Sleep(uint64_t const nanoseconds)
+{
+    Thread * const self = Cpu::GetThread();
+
+    assert_or(IsActive(), "The scheduler does not manage this CPU yet!")
+    {
+        return;
+    }
+
+    Timer timer(&WakeSleeper, self);
+
+    withInterrupts (false)
+    {
+        self->Blocked = true;
+
+        timer.Start(nanoseconds);
+    }
+    //  Not preempted in between, or it would never be scheduled again.
+
+    Block();
+
+    timer.Cancel();
+    //  Only returns once the function is done with the timer.
+}
+
+bool Scheduler::Wake(Thread * const thread)
+{
+    RunQueue * const rq = thread->Queue;
+
+    if unlikely(rq == nullptr)
+    {
+        bool const blocked = thread->Blocked;
+
+        thread->Blocked = false;
+
+        return blocked;
+    }
+    //  Not managed by the scheduler, so it is merely waiting for the flag.
+
+    bool woke = false, queued = false;
+
+    withInterrupts (false)
+    {
+        withLock (rq->Lock)
+        {
+            if (thread->Blocked)
+            {
+                thread->Blocked = false;
+                woke = true;
+
+                if (!thread->Running)
+                {
+                    rq->Push(thread);
+                    queued = true;
+                }
+            }
+        }
+
+        if (queued)
+            Announce(rq, GetLocalQueue());
+    }
+
+    return woke;
+}
+
+/*  Idling  */
+
+void Scheduler::BecomeIdle()
+{
+    Thread * const self = Cpu::GetThread();
+
+    withInterrupts (false)
+    {
+        self->Priority = ThreadPriority::Idle;
+        self->Pinned = true;
+
+        GetLocalQueue()->Idle.Store(true);
+    }
+}
+
+void Scheduler::Idle()
+{
+    RunQueue * const rq = GetLocalQueue();
+    //  Idle threads are pinned, so this remains valid.
+
+    Interrupts::Disable();
+
+    bool work = rq->Length > 0;
+
+#if   defined(__BEELZEBUB_SETTINGS_SMP)
+    if (!work)
+        work = Steal(rq);
+#endif
+
+    if (work)
+    {
+        Interrupts::Enable();
+
+        Yield::Now();
+
+        return;
+    }
+
+#if   defined(__BEELZEBUB_SETTINGS_SMP)
+    if (Cpu::GetData()->Timers.GetCount() > 0)
+        for (RunQueue * other = GetFirstQueue(); other != nullptr; other = other->Next)
+            if (other != rq && other->Cpu != nullptr && !other->Idle.Load(MemoryOrder::Relaxed))
+            {
+                TimerWheel::Migrate(&(other->Cpu->Timers));
+
+                __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+                if (other->Idle.Load(MemoryOrder::Relaxed))
+                    Kick(other);
+                //  It went idle in the meantime, so it must arm its timer.
+
+                break;
+            }
+    //  Busy CPUs tick anyway, so they take over the timers of idle ones.
+
+    TimerWheel::Rearm();
+#endif
+
+    if (Mwait::Available)
+    {
+        rq->WakeSignal = 0;
+        rq->Polling.Store(true, MemoryOrder::Relaxed);
+
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        //  Either a waker sees this polling, or this sees its thread below.
+
+        CpuInstructions::Monitor(&(rq->WakeSignal));
+
+        if (rq->Length == 0 && rq->WakeSignal == 0)
+            CpuInstructions::EnableInterruptsAndMwait(Mwait::GetHint(Cpu::GetData()->TimerDeadline));
+        else
+            Interrupts::Enable();
+        //  A write between the check and MWAIT still wakes it up.
+
+        rq->Polling.Store(false, MemoryOrder::Relaxed);
+    }
+    else
+        CpuInstructions::EnableInterruptsAndHalt();
+}
+
+/*  Properties  */
+
+bool Scheduler::IsActive()
+{
+    return CpuDataSetUp && Scheduling && GetLocalQueue()->Cpu != nullptr;
+}
@@ -0,0 +1,250 @@
+/*
+    Copyright (c) 2015 Alexandru-Mihai Maftei. All rights reserved.
+
+
+    Developed by: Alexandru-Mihai Maftei
+    aka Vercas
+    http://vercas.com | https://github.com/vercas/Beelzebub
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal with the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+      * Redistributions of source code must retain the above copyright notice,
+        this list of conditions and the following disclaimers.
+      * Redistributions in binary form must reproduce the above copyright
+        notice, this list of conditions and the following disclaimers in the
+        documentation and/or other materials provided with the distribution.
+      * Neither the names of Alexandru-Mihai Maftei, Vercas, nor the names of
+        its contributors may be used to endorse or promote products derived from
+        this Software without specific prior written permission.
+
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+    WITH THE SOFTWARE.
+
+    ---
+
+    You may also find the text of this license in "LICENSE.md", along with a more
+    thorough explanation regarding other files.
+*/
+
+#include <execution/soft_irq.hpp>
+#include <execution/work_queue.hpp>
+#include <execution/preemption.hpp>
+#include <system/cpu.hpp>
+#include <kernel.hpp>
+
+#include <debug.hpp>
+
+using namespace Beelzebub;
+using namespace Beelzebub::Execution;
+using namespace Beelzebub::System;
+
+/**
+ *  Marks a soft interrupt pending on the given CPU, which must be the current
+ *  one. Interrupts must be disabled.
+ */
+static __forceinline void MarkPending(CpuData * const data, SoftIrqVector const vec
+    , bool const thread)
+{
+    data->SoftIrqPending |= (uint32_t)1 << (size_t)vec;
+    //  Only this CPU changes its mask, with interrupts disabled.
+
+    if (thread && !data->SoftIrqActive)
+        data->Work.Kick();
+    //  Interrupt handlers are followed by the bottom halves, but threads are
+    //  not. Running handlers restart when more are raised.
+}
+
+/**********************
+    SoftIrq class
+**********************/
+
+/*  Statics  */
+
+SoftIrqHandler SoftIrq::Handlers[Count] = { &SoftIrq::RunTasklets };
+
+/*  Handlers  */
+
+Handle SoftIrq::Register(SoftIrqVector const vec, SoftIrqHandler const handler)
+{
+    if unlikely((size_t)vec >= Count)
+        return HandleResult::ArgumentOutOfRange;
+
+    __atomic_store_n(Handlers + (size_t)vec, handler, __ATOMIC_RELEASE);
+
+    return HandleResult::Okay;
+}
+
+/*  Operations  */
+
+void SoftIrq::Raise(SoftIrqVector const vec)
+{
+    bool const thread = Interrupts::AreEnabled();
+
+    withInterrupts (false)
+        MarkPending(Cpu::GetData(), vec, thread);
+}
+
+void SoftIrq::Process()
+{
+    CpuData * const data = Cpu::GetData();
+
+    if (data->SoftIrqActive)
+        return;
+
+    data->SoftIrqActive = true;
+    PREEMPTION_DISABLE();
+    //  The scheduler leaves this thread on this CPU until the handlers finish.
+
+    for (size_t round = 0; round < RestartLimit; ++round)
+    {
+        uint32_t pending = data->SoftIrqPending;
+
+        if (pending == 0)
+            break;
+
+        data->SoftIrqPending = 0;
+
+        Interrupts::Enable();
+
+        do
+        {
+            size_t const vec = (size_t)__builtin_ctz(pending);
+            pending &= pending - 1;
+
+            SoftIrqHandler const handler = __atomic_load_n(Handlers + vec, __ATOMIC_ACQUIRE);
+
+            if likely(handler != nullptr)
+                handler();
+        } while (pending != 0);
+
+        Interrupts::Disable();
+    }
+
+    data->SoftIrqActive = false;
+    PREEMPTION_ENABLE();
+    //  Interrupts are disabled, so this does not switch threads.
+
+    if unlikely(data->SoftIrqPending != 0)
+        data->Work.Kick();
+    //  Raised too many times over; the worker thread takes the rest, so the
+    //  interrupted thread is not starved.
+}
+
+/*  Properties  */
+
+bool SoftIrq::IsPending()
+{
+    return CpuDataSetUp && Cpu::GetData()->SoftIrqPending != 0;
+}
+
+bool SoftIrq::IsActive()
+{
+    return CpuDataSetUp && Cpu::GetData()->SoftIrqActive;
+}
+
+/*  Tasklets  */
+
+void SoftIrq::RunTasklets()
+{
+    Tasklet * list = nullptr, * cur;
+
+    withInterrupts (false)
+    {
+        CpuData * const data = Cpu::GetData();
+
+        cur = data->Tasklets;
+        data->Tasklets = nullptr;
+    }
+
+    while (cur != nullptr)
+    {
+        Tasklet * const next = cur->Next;
+
+        cur->Next = list;
+        list = cur;
+        cur = next;
+    }
+    //  They were pushed in reverse order.
+
+    while (list != nullptr)
+    {
+        Tasklet * const next = list->Next;
+
+        list->Next = nullptr;
+        __atomic_store_n(&(list->Scheduled), false, __ATOMIC_RELEASE);
+        //  It may be scheduled again by its own function.
+
+        list->Function(list);
+
+        list = next;
+    }
+}
+
+/********************
+    Tasklet class
+********************/
+
+/*  Operations  */
+
+bool Tasklet::Schedule()
+{
+    if (__atomic_exchange_n(&(this->Scheduled), true, __ATOMIC_ACQUIRE))
+        return false;
+
+    bool const thread = Interrupts::AreEnabled();
+
+    withInterrupts (false)
+    {
+        CpuData * const data = Cpu::GetData();
+
+        this->Next = data->Tasklets;
+        data->Tasklets = this;
+
+        MarkPending(data, SoftIrqVector::Tasklet, thread);
+    }
+
+    return true;
+}
+
+/*  Interrupt Return  */
+
+void SoftIrqOnInterruptReturn(uint64_t const rflags)
+{
+    if (!CpuDataSetUp)
+        return;
+
+    CpuData * const data = Cpu::GetData();
+
+    if likely(data->SoftIrqPending == 0 || data->SoftIrqActive)
+        return;
+    //  Handlers which are already running pick up the new ones.
+
+    if (0 == (rflags & (uint64_t)(1 << 9)))
+        return;
+    //  Exceptions and NMIs may come with interrupts disabled, even in the
+    //  middle of interrupt handlers. The next interrupt takes care of it.
+
+#ifdef __BEELZEBUB_SETTINGS_KERNEL_PREEMPTION
+    if (data->PreemptCount != 0)
+    {
+        data->Work.Kick();
+
+        return;
+    }
+    //  The interrupted code is in a critical section, so the worker thread
+    //  runs the handlers once it leaves.
+#endif
+
+    SoftIrq::Process();
+}
@@ -0,0 +1,201 @@
+/*
+    Copyright (c) 2015 Alexandru-Mihai Maftei. All rights reserved.
+
+
+    Developed by: Alexandru-Mihai Maftei
+    aka Vercas
+    http://vercas.com | https://github.com/vercas/Beelzebub
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal with the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+      * Redistributions of source code must retain the above copyright notice,
+        this list of conditions and the following disclaimers.
+      * Redistributions in binary form must reproduce the above copyright
+        notice, this list of conditions and the following disclaimers in the
+        documentation and/or other materials provided with the distribution.
+      * Neither the names of Alexandru-Mihai Maftei, Vercas, nor the names of
+        its contributors may be used to endorse or promote products derived from
+        this Software without specific prior written permission.
+
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+    WITH THE SOFTWARE.
+
+    ---
+
+    You may also find the text of this license in "LICENSE.md", along with a more
+    thorough explanation regarding other files.
+*/
+
+#include <execution/work_queue.hpp>
+#include <execution/soft_irq.hpp>
+#include <execution/thread_init.hpp>
+#include <execution/scheduler.hpp>
+#include <memory/vmm.hpp>
+#include <system/cpu.hpp>
+#include <kernel.hpp>
+
+#include <debug.hpp>
+
+using namespace Beelzebub;
+using namespace Beelzebub::Execution;
+using namespace Beelzebub::Memory;
+using namespace Beelzebub::System;
+
+/**********************
+    WorkQueue class
+**********************/
+
+/*  Initialization  */
+
+void WorkQueue::InitializeCpu(Thread * const worker)
+{
+    new (worker) Thread(&BootstrapProcess);
+
+    uintptr_t stackVaddr = nullvaddr;
+
+    Handle res = Vmm::AllocatePages(&BootstrapProcess
+        , WorkerStackPages
+        , MemoryAllocationOptions::Commit | MemoryAllocationOptions::VirtualKernelHeap
+        , MemoryFlags::Global | MemoryFlags::Writable
+        , MemoryContent::ThreadStack
+        , stackVaddr);
+
+    ASSERT(res.IsOkayResult()
+        , "Failed to allocate stack for work queue thread: %H."
+        , res);
+
+    worker->KernelStackTop = stackVaddr + WorkerStackPages * PageSize;
+    worker->KernelStackBottom = stackVaddr;
+
+    worker->EntryPoint = &WorkerEntryPoint;
+
+    InitializeThreadState(worker);
+
+    worker->Priority = ThreadPriority::High;
+    worker->Pinned = true;
+    //  Above ordinary threads, below the timer thread.
+
+    WorkQueue * const queue = &(Cpu::GetData()->Work);
+
+    withInterrupts (false)
+    {
+        withLock (queue->Lock)
+            queue->Worker = worker;
+    }
+
+    res = Scheduler::Enqueue(worker);
+
+    ASSERT(res.IsOkayResult()
+        , "Failed to enqueue work queue thread: %H."
+        , res);
+    //  Items queued until now are run as soon as it starts.
+}
+
+/*  Operations  */
+
+bool WorkQueue::QueueLocal(WorkItem * const item)
+{
+    return Cpu::GetData()->Work.Queue(item);
+}
+
+bool WorkQueue::Queue(WorkItem * const item)
+{
+    WorkQueue * expected = nullptr;
+
+    if (!__atomic_compare_exchange_n(&(item->Queue), &expected, this
+        , false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+        return false;
+    //  Only one queue may claim the item.
+
+    withInterrupts (false)
+    {
+        withLock (this->Lock)
+        {
+            item->Next = nullptr;
+
+            if (this->Last != nullptr)
+                this->Last->Next = item;
+            else
+                this->First = item;
+
+            this->Last = item;
+        }
+
+        this->Kick();
+    }
+
+    return true;
+}
+
+void WorkQueue::Kick()
+{
+    Thread * const worker = this->Worker;
+
+    if (worker != nullptr)
+        Scheduler::Wake(worker);
+}
+
+/*  Worker Thread  */
+
+WorkItem * WorkQueue::Pop()
+{
+    WorkItem * const item = this->First;
+
+    if (item != nullptr && (this->First = item->Next) == nullptr)
+        this->Last = nullptr;
+
+    return item;
+}
+
+void * WorkQueue::WorkerEntryPoint(void * const)
+{
+    Thread * const self = Cpu::GetThread();
+    WorkQueue * const queue = &(Cpu::GetData()->Work);
+    //  The thread is pinned, so this is always its queue.
+
+    while (true)
+    {
+        WorkItem * item;
+
+        withInterrupts (false)
+        {
+            if (SoftIrq::IsPending())
+                SoftIrq::Process();
+            //  Left over by interrupts.
+
+            withLock (queue->Lock)
+            {
+                item = queue->Pop();
+
+                if (item == nullptr && !SoftIrq::IsPending())
+                    self->Blocked = true;
+            }
+        }
+
+        if (item == nullptr)
+        {
+            Scheduler::Block();
+
+            continue;
+        }
+        //  Queuing items and raising soft interrupts wake this thread up.
+
+        __atomic_store_n(&(item->Queue), nullptr, __ATOMIC_RELEASE);
+        //  It may be queued again by its own function.
+
+        item->Function(item);
+    }
+
+    return nullptr;
+}
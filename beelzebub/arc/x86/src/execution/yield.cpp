@@ -37,37 +37,31 @@
     thorough explanation regarding other files.
 */
 
-#include <execution/thread.hpp>
+#include <execution/yield.hpp>
+#include <execution/scheduler.hpp>
+#include <kernel.hpp>
 
 using namespace Beelzebub;
 using namespace Beelzebub::Execution;
+using namespace Beelzebub::System;
 
 /******************
-Thread class
-*******************/
+    Yield class
+******************/
 
-/*  Linkage  */
+/*  Interrupt Handler  */
 
-Handle Thread::IntroduceNext(Thread * const other)
+void Yield::Handler(INTERRUPT_HANDLER_ARGS_FULL)
 {
-    Thread * oldNext = this->Next;
+    if (CpuDataSetUp)
+        Scheduler::Schedule(state);
 
-    Thread * current = oldNext;
-
-    do
-    {
-        if (current == other)
-            return HandleResult::ThreadAlreadyLinked;
-
-        current = current->Next;
-    }
-    while (current != oldNext);
-
-    this->Next = other;
-    oldNext->Previous = other;
+    //  Software interrupts need no acknowledgement.
+}
 
-    other->Previous = this;
-    other->Next = oldNext;
+/*  Operations  */
 
-    return HandleResult::Okay;
+bool Yield::IsPossible()
+{
+    return Scheduler::IsActive();
 }
@@ -52,12 +52,26 @@
 #include <execution/thread_init.hpp>
 #include <execution/extended_states.hpp>
 #include <execution/runtime64.hpp>
+#include <execution/yield.hpp>
+#include <execution/scheduler.hpp>
+#include <execution/preemption.hpp>
+#include <execution/soft_irq.hpp>
+#include <execution/work_queue.hpp>
 
 #include <system/exceptions.hpp>
 #include <system/interrupt_controllers/pic.hpp>
 #include <system/interrupt_controllers/lapic.hpp>
 #include <system/interrupt_controllers/ioapic.hpp>
 #include <system/timers/pit.hpp>
+#include <system/timers/apic_timer.hpp>
+#include <system/timers/tsc.hpp>
+#include <system/timers/hpet.hpp>
+#include <system/timers/timer_wheel.hpp>
+#include <system/stop_machine.hpp>
+#include <system/cross_cpu.hpp>
+#include <system/topology.hpp>
+#include <system/mwait.hpp>
+#include <system/alternatives.hpp>
 #include <system/syscalls.hpp>
 #include <modules.hpp>
 
@@ -68,6 +82,7 @@
 #include <ap_bootstrap.hpp>
 
 #include <synchronization/spinlock.hpp>
+#include <synchronization/rcu.hpp>
 
 #include <utils/wait.hpp>
 #include <string.h>
@@ -131,10 +146,50 @@
 #include <tests/interrupt_latency.hpp>
 #endif
 
+#ifdef __BEELZEBUB__TEST_LOCK_SCALING
+#include <tests/lock_scaling.hpp>
+#endif
+
+#ifdef __BEELZEBUB__TEST_MUTEX
+#include <tests/mutex.hpp>
+#endif
+
+#ifdef __BEELZEBUB__TEST_QUEUES
+#include <tests/queues.hpp>
+#endif
+
+#ifdef __BEELZEBUB__TEST_SEQLOCK
+#include <tests/seqlock.hpp>
+#endif
+
 #ifdef __BEELZEBUB__TEST_KMOD
 #include <tests/kmod.hpp>
 #endif
 
+#ifdef __BEELZEBUB__TEST_PREEMPTION
+#include <tests/preemption.hpp>
+#endif
+
+#ifdef __BEELZEBUB__TEST_SCHEDULER
+#include <tests/scheduler.hpp>
+#endif
+
+#ifdef __BEELZEBUB__TEST_TIMERS
+#include <tests/timers.hpp>
+#endif
+
+#ifdef __BEELZEBUB__TEST_CROSS_CPU
+#include <tests/cross_cpu.hpp>
+#endif
+
+#ifdef __BEELZEBUB__TEST_DEFERRED_WORK
+#include <tests/deferred_work.hpp>
+#endif
+
+#ifdef __BEELZEBUB__TEST_TOPOLOGY
+#include <tests/topology.hpp>
+#endif
+
 using namespace Beelzebub;
 using namespace Beelzebub::Execution;
 using namespace Beelzebub::Memory;
@@ -227,6 +282,25 @@ static __startup void MainInitializeInterrupts()
     }
 }
 
+static __startup void MainApplyAlternatives()
+{
+    //  Pick the best instructions for this CPU before anything else runs.
+    //  Common on x86.
+
+    MainTerminal->Write("[....] Applying alternative instructions...");
+    Handle res = Alternatives::Apply(BootstrapCpuid);
+
+    if (res.IsOkayResult())
+        MainTerminal->WriteFormat(" %us applied.\r[OKAY]%n", Alternatives::GetAppliedCount());
+    else
+    {
+        MainTerminal->WriteFormat(" Fail..? %H\r[FAIL]%n", res);
+
+        ASSERT(false, "Failed to apply alternative instructions: %H"
+            , res);
+    }
+}
+
 static __startup void MainInitializePit()
 {
     //  Preparing the PIT for basic timing.
@@ -339,6 +413,25 @@ static __startup void MainInitializeApic()
     }
 }
 
+static __startup void MainInitializeTimers()
+{
+    //  Calibrating the TSC and the LAPIC timer, which replace the PIT.
+    //  Common on x86.
+
+    MainTerminal->Write("[....] Initializing timers...");
+    Handle res = InitializeTimers();
+
+    if (res.IsOkayResult())
+        MainTerminal->WriteLine(" Done.\r[OKAY]");
+    else
+    {
+        MainTerminal->WriteFormat(" Fail..? %H\r[FAIL]%n", res);
+
+        ASSERT(false, "Failed to initialize the timers: %H"
+            , res);
+    }
+}
+
 static __startup void MainBootstrapThread()
 {
     //  Turns the current system state into a kernel process and a main thread.
@@ -359,6 +452,8 @@ static __startup void MainBootstrapThread()
 
     Cpu::SetThread(&BootstrapThread);
     Cpu::SetProcess(&BootstrapProcess);
+
+    Scheduler::InitializeCpu(&BootstrapThread);
 }
 
 static __startup void MainInitializeExtraCpus()
@@ -388,7 +483,14 @@ static __startup void MainInitializeExtraCpus()
         Handle res = InitializeProcessingUnits();
 
         if (res.IsOkayResult())
-            MainTerminal->WriteLine(" Done.\r[OKAY]");
+        {
+            if (Tsc::Synchronized)
+                MainTerminal->WriteLine(" Done.\r[OKAY]");
+            else
+                MainTerminal->WriteFormat(" TSCs differ by up to %u8 ticks.\r[WARN]%n"
+                    , Tsc::MaximumWarp);
+            //  Timestamps taken on different CPUs cannot be compared exactly.
+        }
         else
         {
             MainTerminal->WriteFormat(" Fail..? %H\r[FAIL]%n", res);
@@ -407,6 +509,64 @@ static __startup void MainInitializeExtraCpus()
 #endif
 }
 
+static __startup void MainSelectClock()
+{
+    if (Tsc::IsReliable())
+        return;
+
+    if (ApicTimer::TscDeadlineMode)
+    {
+        ApicTimer::TscDeadlineMode = false;
+
+        withInterrupts (false)
+            ApicTimer::InitializeCpu();
+        //  The APs initialize their timers only after this.
+    }
+
+    if (Tsc::SelectClock())
+        MainTerminal->WriteLine("[WARN] The TSC is unreliable, so the clock is the HPET.");
+    else
+        MainTerminal->WriteLine("[WARN] The TSC is unreliable, but there is no 64-bit HPET to replace it.");
+}
+
+static __startup void MainResetTestBarriers()
+{
+#if   defined(__BEELZEBUB_SETTINGS_SMP)
+    //  Every core is up by now, and none of them can reach a barrier before
+    //  the initialization lock is released.
+
+#ifdef __BEELZEBUB__TEST_RW_SPINLOCK
+    if (CHECK_TEST(RW_SPINLOCK))
+        RwSpinlockTestBarrier.Reset(Cpu::Count.Load());
+#endif
+
+#ifdef __BEELZEBUB__TEST_LOCK_SCALING
+    if (CHECK_TEST(LOCK_SCALING))
+        LockScalingTestBarrier.Reset(Cpu::Count.Load());
+#endif
+
+#ifdef __BEELZEBUB__TEST_MUTEX
+    if (CHECK_TEST(MUTEX))
+        MutexTestBarrier.Reset(Cpu::Count.Load());
+#endif
+
+#ifdef __BEELZEBUB__TEST_QUEUES
+    if (CHECK_TEST(QUEUES))
+        QueuesTestBarrier.Reset(Cpu::Count.Load());
+#endif
+
+#ifdef __BEELZEBUB__TEST_SEQLOCK
+    if (CHECK_TEST(SEQLOCK))
+        SeqLockTestBarrier.Reset(Cpu::Count.Load());
+#endif
+
+#ifdef __BEELZEBUB__TEST_OBJA
+    if (CHECK_TEST(OBJA))
+        ObjectAllocatorTestBarrier.Reset(Cpu::Count.Load());
+#endif
+#endif
+}
+
 static __startup void MainElideLocks()
 {
 #ifdef __BEELZEBUB__TEST_LOCK_ELISION
@@ -511,6 +671,11 @@ static __startup void MainInitializeFpu()
 
         if (res.IsOkayResult())
         {
+            MainTerminal->WriteFormat(" %us bytes each%s%s..."
+                , Fpu::StateSize
+                , Fpu::SaveMode >= FpuSaveMode::Xsavec ? ", compacted" : ""
+                , Fpu::Avx512 ? ", AVX-512" : "");
+
             MainTerminal->Write(" Allocating template state...");
 
             void * templateState;
@@ -623,6 +788,7 @@ void Beelzebub::Main()
 
         MainParseKernelArguments();
         MainInitializeInterrupts();
+        MainApplyAlternatives();
         MainInitializePit();
         MainInitializePhysicalMemory();
         MainInitializeVirtualMemory();
@@ -633,10 +799,13 @@ void Beelzebub::Main()
 
         MainInitializeAcpiTables();
         MainInitializeApic();
+        MainInitializeTimers();
 
         MainBootstrapThread();
 
         MainInitializeExtraCpus();
+        MainSelectClock();
+        MainResetTestBarriers();
         MainElideLocks();
 
         MainInitializeBootModules();
@@ -651,25 +820,16 @@ void Beelzebub::Main()
         //  Permit other processors to initialize themselves.
         MainTerminal->WriteLine("Initialization complete! Will enable scheduling.");
         MainTerminal->WriteLine();
+    }
 
-#if     defined(__BEELZEBUB__TEST_RW_SPINLOCK) && defined(__BEELZEBUB_SETTINGS_SMP)
-        if (Cpu::Count.Load() > 1 && CHECK_TEST(RW_SPINLOCK))
-        {
-            RwSpinlockTestBarrier1.Reset();
-            RwSpinlockTestBarrier2.Reset();
-            RwSpinlockTestBarrier3.Reset();
-        }
-#endif
+    Preemption::InitializeCpu();
+    //  Outside of every critical section now.
 
-#ifdef __BEELZEBUB__TEST_OBJA
-        if (CHECK_TEST(OBJA))
-        {
-            ObjectAllocatorTestBarrier1.Reset();
-            ObjectAllocatorTestBarrier2.Reset();
-            ObjectAllocatorTestBarrier3.Reset();
-        }
-#endif
-    }
+    Thread timerThread, workerThread;
+    //  This function never returns either.
+
+    TimerWheel::InitializeCpu(&timerThread);
+    WorkQueue::InitializeCpu(&workerThread);
 
     Scheduling = true;
 
@@ -856,6 +1016,58 @@ void Beelzebub::Main()
     }
 #endif
 
+#if     defined(__BEELZEBUB__TEST_LOCK_SCALING) && defined(__BEELZEBUB_SETTINGS_SMP)
+    if (CHECK_TEST(LOCK_SCALING))
+    {
+        withLock (TerminalMessageLock)
+            MainTerminal->WriteFormat("Core %us: Benchmarking lock scalability.%n", Cpu::GetData()->Index);
+        
+        TestLockScaling(true);
+
+        withLock (TerminalMessageLock)
+            MainTerminal->WriteFormat("Core %us: Finished lock scalability benchmark.%n", Cpu::GetData()->Index);
+    }
+#endif
+
+#if     defined(__BEELZEBUB__TEST_MUTEX) && defined(__BEELZEBUB_SETTINGS_SMP)
+    if (CHECK_TEST(MUTEX))
+    {
+        withLock (TerminalMessageLock)
+            MainTerminal->WriteFormat("Core %us: Testing mutex, semaphore and condition variable.%n", Cpu::GetData()->Index);
+        
+        TestMutex(true);
+
+        withLock (TerminalMessageLock)
+            MainTerminal->WriteFormat("Core %us: Finished mutex test.%n", Cpu::GetData()->Index);
+    }
+#endif
+
+#if     defined(__BEELZEBUB__TEST_QUEUES) && defined(__BEELZEBUB_SETTINGS_SMP)
+    if (CHECK_TEST(QUEUES))
+    {
+        withLock (TerminalMessageLock)
+            MainTerminal->WriteFormat("Core %us: Benchmarking lock-free queues.%n", Cpu::GetData()->Index);
+        
+        TestQueues(true);
+
+        withLock (TerminalMessageLock)
+            MainTerminal->WriteFormat("Core %us: Finished lock-free queue benchmark.%n", Cpu::GetData()->Index);
+    }
+#endif
+
+#if     defined(__BEELZEBUB__TEST_SEQLOCK) && defined(__BEELZEBUB_SETTINGS_SMP)
+    if (CHECK_TEST(SEQLOCK))
+    {
+        withLock (TerminalMessageLock)
+            MainTerminal->WriteFormat("Core %us: Testing sequence lock.%n", Cpu::GetData()->Index);
+        
+        TestSeqLock(true);
+
+        withLock (TerminalMessageLock)
+            MainTerminal->WriteFormat("Core %us: Finished sequence lock test.%n", Cpu::GetData()->Index);
+    }
+#endif
+
 #ifdef __BEELZEBUB__TEST_OBJA
     if (CHECK_TEST(OBJA))
     {
@@ -869,10 +1081,101 @@ void Beelzebub::Main()
     }
 #endif
 
+#ifdef __BEELZEBUB__TEST_PREEMPTION
+    if (CHECK_TEST(PREEMPTION))
+    {
+        withLock (TerminalMessageLock)
+            MainTerminal->WriteFormat("Core %us: Measuring preemption latency.%n", Cpu::GetData()->Index);
+
+        TestPreemption();
+        //  Runs outside of every critical section, so the timer can preempt it.
+
+        withLock (TerminalMessageLock)
+            MainTerminal->WriteFormat("Core %us: Finished preemption latency test.%n", Cpu::GetData()->Index);
+    }
+#endif
+
+#ifdef __BEELZEBUB__TEST_SCHEDULER
+    if (CHECK_TEST(SCHEDULER))
+    {
+        withLock (TerminalMessageLock)
+            MainTerminal->WriteFormat("Core %us: Benchmarking the scheduler.%n", Cpu::GetData()->Index);
+
+        TestScheduler();
+
+        withLock (TerminalMessageLock)
+            MainTerminal->WriteFormat("Core %us: Finished scheduler benchmark.%n", Cpu::GetData()->Index);
+    }
+#endif
+
+#ifdef __BEELZEBUB__TEST_TIMERS
+    if (CHECK_TEST(TIMERS))
+    {
+        withLock (TerminalMessageLock)
+            MainTerminal->WriteFormat("Core %us: Testing timers.%n", Cpu::GetData()->Index);
+
+        TestTimers();
+
+        withLock (TerminalMessageLock)
+            MainTerminal->WriteFormat("Core %us: Finished timer test.%n", Cpu::GetData()->Index);
+    }
+#endif
+
+#ifdef __BEELZEBUB__TEST_CROSS_CPU
+    if (CHECK_TEST(CROSS_CPU))
+    {
+        withLock (TerminalMessageLock)
+            MainTerminal->WriteFormat("Core %us: Testing cross-CPU calls.%n", Cpu::GetData()->Index);
+
+        TestCrossCpu();
+
+        withLock (TerminalMessageLock)
+            MainTerminal->WriteFormat("Core %us: Finished cross-CPU call test.%n", Cpu::GetData()->Index);
+    }
+#endif
+
+#ifdef __BEELZEBUB__TEST_DEFERRED_WORK
+    if (CHECK_TEST(DEFERRED_WORK))
+    {
+        withLock (TerminalMessageLock)
+            MainTerminal->WriteFormat("Core %us: Testing deferred work.%n", Cpu::GetData()->Index);
+
+        TestDeferredWork();
+
+        withLock (TerminalMessageLock)
+            MainTerminal->WriteFormat("Core %us: Finished deferred work test.%n", Cpu::GetData()->Index);
+    }
+#endif
+
+#ifdef __BEELZEBUB__TEST_TOPOLOGY
+    if (CHECK_TEST(TOPOLOGY))
+    {
+        withLock (TerminalMessageLock)
+            MainTerminal->WriteFormat("Core %us: Testing CPU topology.%n", Cpu::GetData()->Index);
+
+        TestTopology();
+
+        withLock (TerminalMessageLock)
+            MainTerminal->WriteFormat("Core %us: Finished CPU topology test.%n", Cpu::GetData()->Index);
+    }
+#endif
+
+    Scheduler::BecomeIdle();
+    //  From now on, this thread only runs when the CPU has nothing else to do.
+
     //  Allow the CPU to rest.
     while (true)
     {
-        if (CpuInstructions::CanHalt) CpuInstructions::Halt();
+        if (Rcu::HasCallbacks())
+        {
+            Rcu::ReportQuiescentState();
+            Rcu::ProcessCallbacks();
+        }
+        //  Idle threads are never within read-side critical sections.
+
+        Rcu::EnterIdle();
+
+        Scheduler::Idle();
 
         //TerminalMessageLock.Acquire();
         //MainTerminal->WriteLine(">>-- Rehalting! --<<");
@@ -885,15 +1188,46 @@ void Beelzebub::Main()
 
 void Beelzebub::Secondary()
 {
+    Tsc::CheckWarp(false);
+    //  The BSP is waiting for this.
+
     Lapic::Initialize();
     //  Quickly get the local APIC initialized.
 
+    CrossCpu::InitializeCpu();
+    CpuTopology::InitializeCpu();
+
+#ifdef __BEELZEBUB_SETTINGS_LOCK_PROFILING
+    LockProfiler::InitializeCpu();
+#endif
+
     Syscalls::Initialize();
     //  And syscalls.
 
     InitializationLock.Spin();
     //  Wait for the system to initialize.
 
+    ApicTimer::InitializeCpu();
+    //  The calibration of the BSP applies to all. The BSP also decided by now
+    //  whether the TSC is fit for deadlines.
+
+    Preemption::InitializeCpu();
+
+    Thread initialThread;
+    //  This function never returns, so its stack can hold the thread.
+
+    InitializeSecondaryThread(&initialThread, &BootstrapProcess);
+
+    Cpu::SetThread(&initialThread);
+    Cpu::SetProcess(&BootstrapProcess);
+
+    Scheduler::InitializeCpu(&initialThread);
+
+    Thread timerThread, workerThread;
+
+    TimerWheel::InitializeCpu(&timerThread);
+    WorkQueue::InitializeCpu(&workerThread);
+
     Fpu::InitializeSecondary();
     //  Meh...
 
@@ -931,6 +1265,58 @@ void Beelzebub::Secondary()
     }
 #endif
 
+#ifdef __BEELZEBUB__TEST_LOCK_SCALING
+    if (CHECK_TEST(LOCK_SCALING))
+    {
+        withLock (TerminalMessageLock)
+            MainTerminal->WriteFormat("Core %us: Benchmarking lock scalability.%n", Cpu::GetData()->Index);
+        
+        TestLockScaling(false);
+
+        withLock (TerminalMessageLock)
+            MainTerminal->WriteFormat("Core %us: Finished lock scalability benchmark.%n", Cpu::GetData()->Index);
+    }
+#endif
+
+#ifdef __BEELZEBUB__TEST_MUTEX
+    if (CHECK_TEST(MUTEX))
+    {
+        withLock (TerminalMessageLock)
+            MainTerminal->WriteFormat("Core %us: Testing mutex, semaphore and condition variable.%n", Cpu::GetData()->Index);
+        
+        TestMutex(false);
+
+        withLock (TerminalMessageLock)
+            MainTerminal->WriteFormat("Core %us: Finished mutex test.%n", Cpu::GetData()->Index);
+    }
+#endif
+
+#ifdef __BEELZEBUB__TEST_QUEUES
+    if (CHECK_TEST(QUEUES))
+    {
+        withLock (TerminalMessageLock)
+            MainTerminal->WriteFormat("Core %us: Benchmarking lock-free queues.%n", Cpu::GetData()->Index);
+        
+        TestQueues(false);
+
+        withLock (TerminalMessageLock)
+            MainTerminal->WriteFormat("Core %us: Finished lock-free queue benchmark.%n", Cpu::GetData()->Index);
+    }
+#endif
+
+#ifdef __BEELZEBUB__TEST_SEQLOCK
+    if (CHECK_TEST(SEQLOCK))
+    {
+        withLock (TerminalMessageLock)
+            MainTerminal->WriteFormat("Core %us: Testing sequence lock.%n", Cpu::GetData()->Index);
+        
+        TestSeqLock(false);
+
+        withLock (TerminalMessageLock)
+            MainTerminal->WriteFormat("Core %us: Finished sequence lock test.%n", Cpu::GetData()->Index);
+    }
+#endif
+
 #ifdef __BEELZEBUB__TEST_OBJA
     if (CHECK_TEST(OBJA))
     {
@@ -944,8 +1330,23 @@ void Beelzebub::Secondary()
     }
 #endif
 
+    Scheduler::BecomeIdle();
+    //  From now on, this thread only runs when the CPU has nothing else to do.
+
     //  Allow the CPU to rest.
-    while (true) if (CpuInstructions::CanHalt) CpuInstructions::Halt();
+    while (true)
+    {
+        if (Rcu::HasCallbacks())
+        {
+            Rcu::ReportQuiescentState();
+            Rcu::ProcessCallbacks();
+        }
+        //  Idle threads are never within read-side critical sections.
+
+        Rcu::EnterIdle();
+
+        Scheduler::Idle();
+    }
 }
 #endif
 
@@ -1042,6 +1443,8 @@ Handle InitializeInterrupts()
 #if   defined(__BEELZEBUB__ARCH_AMD64)
     Interrupts::Get((uint8_t)KnownExceptionVectors::DoubleFault).GetGate()->SetIst(1);
     Interrupts::Get((uint8_t)KnownExceptionVectors::PageFault  ).GetGate()->SetIst(2);
+    Interrupts::Get((uint8_t)KnownExceptionVectors::NmiInterrupt).GetGate()->SetIst(3);
+    //  NMIs may arrive before the kernel stack is loaded.
 #endif
 
     Interrupts::Get((uint8_t)KnownExceptionVectors::DivideError).SetHandler(&DivideErrorHandler);
@@ -1056,6 +1459,14 @@ Handle InitializeInterrupts()
     Interrupts::Get((uint8_t)KnownExceptionVectors::StackSegmentFault).SetHandler(&StackSegmentFaultHandler);
     Interrupts::Get((uint8_t)KnownExceptionVectors::GeneralProtectionFault).SetHandler(&GeneralProtectionHandler);
     Interrupts::Get((uint8_t)KnownExceptionVectors::PageFault).SetHandler(&PageFaultHandler);
+    Interrupts::Get((uint8_t)KnownExceptionVectors::NmiInterrupt).SetHandler(&StopMachine::Handler);
+
+    Interrupts::Get(Yield::Vector).SetHandler(&Yield::Handler);
+    Interrupts::Get(Scheduler::Vector).SetHandler(&Scheduler::Handler);
+    Interrupts::Get(ApicTimer::Vector).SetHandler(&ApicTimer::Handler);
+    Interrupts::Get(CrossCpu::Vector).SetHandler(&CrossCpu::Handler);
+
+    SoftIrq::Register(SoftIrqVector::Rcu, &Rcu::ProcessCallbacks);
 
     Pic::Initialize(0xE0);  //  Just below the spurious interrupt vector.
 
@@ -1176,6 +1587,13 @@ Handle InitializeApic()
         , "Failed to initialize the LAPIC?! %H%n"
         , res);
 
+    CrossCpu::InitializeCpu();
+    CpuTopology::InitializeCpu();
+
+#ifdef __BEELZEBUB_SETTINGS_LOCK_PROFILING
+    LockProfiler::InitializeCpu();
+#endif
+
     if (Cpu::GetData()->X2ApicMode)
         MainTerminal->Write(" Local x2APIC...");
     else
@@ -1230,6 +1648,57 @@ Handle InitializeApic()
     return HandleResult::Okay;
 }
 
+/*******************
+    LAPIC TIMERS
+*******************/
+
+Handle InitializeTimers()
+{
+    Handle res = Hpet::Initialize();
+    //  Optional, but a better reference than the PIT.
+
+    if (res.IsOkayResult())
+        MainTerminal->WriteFormat(" HPET @ %u8 MHz,", Hpet::Frequency / 1000000);
+    else if (!res.IsResult(HandleResult::NotFound))
+        MainTerminal->WriteFormat(" HPET unusable: %H,", res);
+
+    res = Tsc::Calibrate();
+
+    if (!res.IsOkayResult())
+        return res;
+
+    Pic::SetMasked(0, true);
+    //  Nothing needs the PIT to tick anymore.
+
+    res = ApicTimer::Calibrate();
+
+    if (res.IsOkayResult())
+        ApicTimer::InitializeCpu();
+        //  For the BSP.
+    else if (Hpet::IsAvailable())
+    {
+        res = Hpet::StartTicking(Scheduler::SliceLength * 1000);
+
+        if (!res.IsOkayResult())
+            return res;
+
+        MainTerminal->WriteFormat(" LAPIC timer unusable, HPET ticking on IRQ%u1..."
+            , Hpet::Irq);
+    }
+    else
+        return res;
+
+    MainTerminal->WriteFormat(" %sTSC @ %u8 MHz, LAPIC timer @ %u8 MHz%s..."
+        , Tsc::Invariant ? "invariant " : "", Tsc::Frequency / 1000000
+        , ApicTimer::Frequency / 1000000
+        , ApicTimer::TscDeadlineMode ? ", TSC-deadline" : "");
+
+    if (Mwait::Initialize())
+        MainTerminal->WriteFormat(" MWAIT down to C%u4...", Mwait::DeepState);
+
+    return HandleResult::Okay;
+}
+
 /***********************
     PROCESSING UNITS
 ***********************/
@@ -1433,7 +1902,12 @@ Handle InitializeAp(uint32_t const lapicId
     //  Lower the entry barrier for the AP.
 
     if likely(Wait(3 * 1000 * 1000, &CheckApInitializationLock3))
+    {
+        Tsc::CheckWarp(true);
+        //  The AP does the same as it enters the kernel.
+
         return HandleResult::Okay;
+    }
     //  Now the AP must acknowledge passing the barrier before the BSP can
     //  proceed. The timeout here is just symbolic and this should succeed at
     //  the first or second calls of the predicate.
@@ -39,9 +39,12 @@
 
 #include <keyboard.hpp>
 
-#include <system/cpu.hpp>   //  Only used for task switching right now...
+#include <execution/scheduler.hpp>
+#include <execution/work_queue.hpp>
 #include <system/io_ports.hpp>
 #include <system/timers/pit.hpp>
+#include <memory/object_allocator_registry.hpp>
+#include <synchronization/lock_profiler.hpp>
 
 #include <kernel.hpp>
 #include <debug.hpp>
@@ -49,6 +52,7 @@
 
 using namespace Beelzebub;
 using namespace Beelzebub::Execution;
+using namespace Beelzebub::Memory;
 using namespace Beelzebub::System;
 using namespace Beelzebub::System::Timers;
 
@@ -57,6 +61,25 @@ bool keyboard_escaped = false;
 int volatile breakpointEscaped = 0;
 int volatile * volatile breakpointEscapedAux = nullptr;
 
+#ifdef __BEELZEBUB_SETTINGS_LOCK_PROFILING
+static void DumpLockProfiler(WorkItem * const)
+{
+    Beelzebub::Synchronization::LockProfiler::Dump(Debug::DebugTerminal);
+    //  Shows which locks are contended.
+}
+
+static WorkItem LockProfilerDump {&DumpLockProfiler};
+#endif
+
+static void DumpAllocators(WorkItem * const)
+{
+    ObjectAllocatorRegistry::Dump(Debug::DebugTerminal);
+    //  Shows which allocators are hot.
+}
+
+static WorkItem AllocatorDump {&DumpAllocators};
+//  Dumps take long and take locks, so they are left to worker threads.
+
 void keyboard_init(void)
 {
     while (Io::In8(0x64) & 0x1)
@@ -93,6 +116,10 @@ void keyboard_handler(INTERRUPT_HANDLER_ARGS_FULL)
         switch (code)
         {
         case KEYBOARD_CODE_LEFT:
+#ifdef __BEELZEBUB_SETTINGS_LOCK_PROFILING
+            WorkQueue::QueueLocal(&LockProfilerDump);
+#endif
+
             /*{
                 PitCommand pitCmd {};
                 pitCmd.SetAccessMode(PitAccessMode::LowHigh);
@@ -114,27 +141,14 @@ void keyboard_handler(INTERRUPT_HANDLER_ARGS_FULL)
 
             break;
 
-        case KEYBOARD_CODE_UP:
-            Thread * const activeThread = Cpu::GetThread();
-
-            if (activeThread != nullptr)
-            {
-                activeThread->State = *state;
-
-                //msg("PRE-SWITCH ");
-                //PrintToDebugTerminal(state);
-                //msg("%n");
+        case KEYBOARD_CODE_DOWN:
+            WorkQueue::QueueLocal(&AllocatorDump);
 
-                /*msg("(( AT=%Xp; N=%Xp; P=%Xp; BST=%B ))%n"
-                    , activeThread, activeThread->Next, activeThread->Previous
-                    , activeThread == &BootstrapThread);//*/
-
-                activeThread->SwitchToNext(state);
+            break;
 
-                //msg("%nPOST-SWITCH ");
-                //PrintToDebugTerminal(state);
-                //msg("%n");
-            }
+        case KEYBOARD_CODE_UP:
+            Scheduler::Schedule(state);
+            //  Lets the next thread run.
 
             break;
 
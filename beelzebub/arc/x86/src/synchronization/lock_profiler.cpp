@@ -0,0 +1,317 @@
+/*
+    Copyright (c) 2015 Alexandru-Mihai Maftei. All rights reserved.
+
+
+    Developed by: Alexandru-Mihai Maftei
+    aka Vercas
+    http://vercas.com | https://github.com/vercas/Beelzebub
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal with the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+      * Redistributions of source code must retain the above copyright notice,
+        this list of conditions and the following disclaimers.
+      * Redistributions in binary form must reproduce the above copyright
+        notice, this list of conditions and the following disclaimers in the
+        documentation and/or other materials provided with the distribution.
+      * Neither the names of Alexandru-Mihai Maftei, Vercas, nor the names of
+        its contributors may be used to endorse or promote products derived from
+        this Software without specific prior written permission.
+
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+    WITH THE SOFTWARE.
+
+    ---
+
+    You may also find the text of this license in "LICENSE.md", along with a more
+    thorough explanation regarding other files.
+*/
+
+#ifdef __BEELZEBUB_SETTINGS_LOCK_PROFILING
+
+#include <synchronization/lock_profiler.hpp>
+#include <synchronization/spinlock_uninterruptible.hpp>
+#include <synchronization/lock_guard.hpp>
+#include <system/interrupts.hpp>
+#include <system/cpu.hpp>
+#include <system/cross_cpu.hpp>
+#include <memory/vmm.hpp>
+#include <terminals/base.hpp>
+#include <string.h>
+#include <math.h>
+
+#include <kernel.hpp>
+#include <debug.hpp>
+
+using namespace Beelzebub;
+using namespace Beelzebub::Memory;
+using namespace Beelzebub::Synchronization;
+using namespace Beelzebub::System;
+using namespace Beelzebub::Terminals;
+
+static_assert((LockProfiler::SiteLimit & (LockProfiler::SiteLimit - 1)) == 0
+    , "The site limit of the lock profiler must be a power of two.");
+
+struct HeldLock
+{
+    void const volatile * Lock;
+    LockProfilingEntry * Entry;
+    uint64_t AcquiredAt;
+};
+
+struct LockProfilingBucket
+{
+    LockProfilingEntry Entries[LockProfiler::SiteLimit];
+    HeldLock Held[LockProfiler::HeldLimit];
+    size_t HeldCount;
+} __aligned(CacheLineSize);
+
+static LockProfilingBucket * volatile Buckets[CpuMask::Capacity];
+//  Every CPU allocates its own bucket once its memory can be mapped. Until
+//  then, it is not profiled.
+
+static size_t const MergedLimit = 2 * LockProfiler::SiteLimit;
+static LockProfilingEntry Merged[MergedLimit];
+static SpinlockUninterruptible<> MergeLock;
+//  Uninterruptible, because the profile may be dumped by an IRQ handler.
+
+/*  Utilities  */
+
+static LockProfilingEntry * FindEntry(LockProfilingEntry * const entries, size_t const limit
+    , void const * const site)
+{
+    size_t const mask = limit - 1;
+    size_t i = (((uintptr_t)site >> 2) * 2654435761U) & mask;
+    //  Knuth's multiplicative hash spreads out neighbouring sites.
+
+    for (size_t probes = limit; probes > 0; --probes, i = (i + 1) & mask)
+    {
+        if (entries[i].Site == site)
+            return entries + i;
+
+        if (entries[i].Site == nullptr)
+        {
+            entries[i].Site = site;
+
+            return entries + i;
+        }
+    }
+
+    return nullptr;
+}
+
+static inline LockProfilingBucket * GetBucket()
+{
+    if unlikely(!CpuDataSetUp)
+        return nullptr;
+    //  Until then, the CPU index cannot be read.
+
+    return Buckets[Cpu::GetData()->Index];
+}
+
+/**************************
+    LockProfiler class
+**************************/
+
+/*  Initialization  */
+
+void LockProfiler::InitializeCpu()
+{
+    size_t const index = Cpu::GetData()->Index;
+
+    if (Buckets[index] != nullptr)
+        return;
+
+    size_t const pageCount = RoundUp(sizeof(LockProfilingBucket), PageSize) / PageSize;
+    vaddr_t vaddr = nullvaddr;
+
+    Handle res = Vmm::AllocatePages(&BootstrapProcess
+        , pageCount
+        , MemoryAllocationOptions::Commit | MemoryAllocationOptions::VirtualKernelHeap
+        , MemoryFlags::Global | MemoryFlags::Writable
+        , MemoryContent::Generic
+        , vaddr);
+    //  The kernel heap is shared, and this CPU may not have a process yet.
+
+    if unlikely(!res.IsOkayResult())
+        return;
+    //  Not worth failing over; this CPU just goes unprofiled.
+
+    memset(reinterpret_cast<void *>(vaddr), 0, pageCount * PageSize);
+
+    Buckets[index] = reinterpret_cast<LockProfilingBucket *>(vaddr);
+}
+
+/*  Hooks  */
+
+void LockProfiler::Acquired(void const volatile * lock, void const * site
+    , uint64_t start, bool contended)
+{
+    uint64_t const now = CpuInstructions::Rdtsc();
+
+    InterruptGuard<> intGuard;
+    //  Interrupt handlers take locks too.
+
+    LockProfilingBucket * const bucket = GetBucket();
+
+    if unlikely(bucket == nullptr)
+        return;
+
+    LockProfilingEntry * const entry = FindEntry(bucket->Entries, SiteLimit, site);
+
+    if likely(entry != nullptr)
+    {
+        uint64_t const wait = now - start;
+
+        ++entry->Acquisitions;
+
+        if (contended)
+            ++entry->ContendedAcquisitions;
+
+        entry->WaitCycles += wait;
+
+        if (wait > entry->MaxWaitCycles)
+            entry->MaxWaitCycles = wait;
+    }
+
+    if likely(bucket->HeldCount < HeldLimit)
+        bucket->Held[bucket->HeldCount++] = { lock, entry, now };
+    //  Too deep nesting merely loses the hold time.
+}
+
+void LockProfiler::Released(void const volatile * lock)
+{
+    uint64_t const now = CpuInstructions::Rdtsc();
+
+    InterruptGuard<> intGuard;
+
+    LockProfilingBucket * const bucket = GetBucket();
+
+    if unlikely(bucket == nullptr)
+        return;
+
+    for (size_t i = bucket->HeldCount; i > 0; --i)
+    {
+        HeldLock const held = bucket->Held[i - 1];
+
+        if (held.Lock != lock)
+            continue;
+
+        for (size_t j = i; j < bucket->HeldCount; ++j)
+            bucket->Held[j - 1] = bucket->Held[j];
+
+        --bucket->HeldCount;
+        //  Locks are not necessarily released in reverse order.
+
+        if likely(held.Entry != nullptr)
+        {
+            uint64_t const hold = now - held.AcquiredAt;
+
+            held.Entry->HoldCycles += hold;
+
+            if (hold > held.Entry->MaxHoldCycles)
+                held.Entry->MaxHoldCycles = hold;
+        }
+
+        return;
+    }
+
+    //  Acquired on another CPU or before profiling started.
+}
+
+/*  Statistics  */
+
+size_t LockProfiler::Collect(LockProfilingEntry * entries, size_t capacity)
+{
+    size_t count = 0;
+
+    withLock (MergeLock)
+    {
+        memset(Merged, 0, sizeof(Merged));
+
+        for (size_t i = 0; i < CpuMask::Capacity; ++i)
+            for (size_t j = 0; Buckets[i] != nullptr && j < SiteLimit; ++j)
+            {
+                LockProfilingEntry const src = Buckets[i]->Entries[j];
+
+                if (src.Site == nullptr)
+                    continue;
+
+                LockProfilingEntry * const dst = FindEntry(Merged, MergedLimit, src.Site);
+
+                if unlikely(dst == nullptr)
+                    continue;
+
+                dst->Acquisitions += src.Acquisitions;
+                dst->ContendedAcquisitions += src.ContendedAcquisitions;
+                dst->WaitCycles += src.WaitCycles;
+                dst->HoldCycles += src.HoldCycles;
+
+                if (src.MaxWaitCycles > dst->MaxWaitCycles)
+                    dst->MaxWaitCycles = src.MaxWaitCycles;
+                if (src.MaxHoldCycles > dst->MaxHoldCycles)
+                    dst->MaxHoldCycles = src.MaxHoldCycles;
+            }
+        //  The counters of other CPUs are read while they may be changing,
+        //  which is fine for statistics.
+
+        for (size_t i = 0; i < MergedLimit; ++i)
+        {
+            if (Merged[i].Site == nullptr)
+                continue;
+
+            size_t j = count < capacity ? count++ : capacity;
+
+            while (j > 0 && entries[j - 1].WaitCycles < Merged[i].WaitCycles)
+            {
+                if (j < capacity)
+                    entries[j] = entries[j - 1];
+
+                --j;
+            }
+
+            if (j < capacity)
+                entries[j] = Merged[i];
+        }
+        //  Insertion sort, keeping only the sites which waited the most.
+    }
+
+    return count;
+}
+
+void LockProfiler::Dump(TerminalBase * const term)
+{
+    LockProfilingEntry entries[DumpLimit];
+
+    size_t const collected = Collect(entries, DumpLimit);
+
+    term->WriteLine("Site\t\t\tAcq.\tCont.\tWait\tMaxWait\tHold\tMaxHold");
+    //  Separated by tabs, because the terminal cannot pad formatted values.
+
+    for (size_t i = 0; i < collected; ++i)
+        term->WriteFormat("%Xp\t%u8\t%u8\t%u8\t%u8\t%u8\t%u8%n"
+            , entries[i].Site, entries[i].Acquisitions, entries[i].ContendedAcquisitions
+            , entries[i].WaitCycles, entries[i].MaxWaitCycles
+            , entries[i].HoldCycles, entries[i].MaxHoldCycles);
+}
+
+void LockProfiler::Reset()
+{
+    InterruptGuard<> intGuard;
+
+    for (size_t i = 0; i < CpuMask::Capacity; ++i)
+        if (Buckets[i] != nullptr)
+            memset(Buckets[i], 0, sizeof(LockProfilingBucket));
+}
+
+#endif
@@ -0,0 +1,148 @@
+/*
+    Copyright (c) 2015 Alexandru-Mihai Maftei. All rights reserved.
+
+
+    Developed by: Alexandru-Mihai Maftei
+    aka Vercas
+    http://vercas.com | https://github.com/vercas/Beelzebub
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal with the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+      * Redistributions of source code must retain the above copyright notice,
+        this list of conditions and the following disclaimers.
+      * Redistributions in binary form must reproduce the above copyright
+        notice, this list of conditions and the following disclaimers in the
+        documentation and/or other materials provided with the distribution.
+      * Neither the names of Alexandru-Mihai Maftei, Vercas, nor the names of
+        its contributors may be used to endorse or promote products derived from
+        this Software without specific prior written permission.
+
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+    WITH THE SOFTWARE.
+
+    ---
+
+    You may also find the text of this license in "LICENSE.md", along with a more
+    thorough explanation regarding other files.
+*/
+
+#include <synchronization/mutex.hpp>
+#include <execution/yield.hpp>
+#include <system/cpu.hpp>
+#include <kernel.hpp>
+#include <debug.hpp>
+
+using namespace Beelzebub;
+using namespace Beelzebub::Execution;
+using namespace Beelzebub::Synchronization;
+using namespace Beelzebub::System;
+
+static __forceinline Thread * GetCurrentThread()
+{
+    return CpuDataSetUp ? Cpu::GetThread() : nullptr;
+}
+
+/******************
+    Mutex class
+******************/
+
+/*  Operations  */
+
+bool Mutex::TryAcquire()
+{
+    bool expected = false;
+
+    if (!this->Locked.CmpXchgStrong(expected, true))
+        return false;
+
+    this->Owner = GetCurrentThread();
+
+    return true;
+}
+
+void Mutex::Acquire()
+{
+    if likely(this->TryAcquire())
+        return;
+
+    this->AcquireContended();
+}
+
+void Mutex::Release()
+{
+    assert(this->Locked.Load(), "Mutex %Xp is not held!", this);
+
+    InterruptGuard<> intGuard;
+    this->Guard.Acquire();
+
+    Thread * const next = this->Waiters.WakeOne();
+
+    if (next != nullptr)
+        this->Owner = next;
+    //  The mutex stays locked, and the woken thread cannot release it before
+    //  the guard is released.
+    else
+    {
+        this->Owner = nullptr;
+        this->Locked.Store(false);
+    }
+
+    this->Guard.Release();
+}
+
+void Mutex::AcquireContended()
+{
+    Thread * const self = GetCurrentThread();
+
+    assert(self == nullptr || this->Owner != self
+        , "Mutex %Xp is already held by the current thread!", this);
+
+    while (true)
+    {
+        //  An owner running on another CPU will probably release the mutex
+        //  sooner than this thread could get blocked and woken up.
+
+        Thread * owner;
+
+        while (this->Locked.Load()
+            && (owner = this->Owner) != nullptr && owner != self && owner->Running)
+            CpuInstructions::DoNothing();
+
+        if (this->TryAcquire())
+            return;
+
+        if (!Yield::IsPossible())
+        {
+            CpuInstructions::DoNothing();
+
+            continue;
+        }
+
+        InterruptGuard<> intGuard;
+        this->Guard.Acquire();
+
+        if (this->TryAcquire())
+        {
+            this->Guard.Release();
+
+            return;
+        }
+
+        this->Waiters.Sleep(this->Guard);
+
+        //  The releaser has handed the mutex over to this thread.
+
+        return;
+    }
+}
@@ -0,0 +1,117 @@
+/*
+    Copyright (c) 2015 Alexandru-Mihai Maftei. All rights reserved.
+
+
+    Developed by: Alexandru-Mihai Maftei
+    aka Vercas
+    http://vercas.com | https://github.com/vercas/Beelzebub
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal with the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+      * Redistributions of source code must retain the above copyright notice,
+        this list of conditions and the following disclaimers.
+      * Redistributions in binary form must reproduce the above copyright
+        notice, this list of conditions and the following disclaimers in the
+        documentation and/or other materials provided with the distribution.
+      * Neither the names of Alexandru-Mihai Maftei, Vercas, nor the names of
+        its contributors may be used to endorse or promote products derived from
+        this Software without specific prior written permission.
+
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+    WITH THE SOFTWARE.
+
+    ---
+
+    You may also find the text of this license in "LICENSE.md", along with a more
+    thorough explanation regarding other files.
+*/
+
+#include <synchronization/queued_spinlock.hpp>
+#include <debug.hpp>
+
+using namespace Beelzebub::Synchronization;
+
+/****************************
+    QueuedSpinlock struct
+****************************/
+
+#ifdef __BEELZEBUB__DEBUG
+    /*  Destructor  */
+
+    template<bool SMP>
+    QueuedSpinlock<SMP>::~QueuedSpinlock()
+    {
+        assert(this->Check(), "Queued spinlock @ %Xp was destructed while busy!", this);
+    }
+#endif
+
+/*  Operations  */
+
+template<bool SMP>
+void QueuedSpinlock<SMP>::AcquireQueued() volatile
+{
+    QueuedSpinlockNode node;
+    node.Next = nullptr;
+    node.Head = false;
+
+    QueuedSpinlockNode * const previous = __atomic_exchange_n(&this->Tail, &node, __ATOMIC_ACQ_REL);
+
+    if (previous != nullptr)
+    {
+        __atomic_store_n(&previous->Next, &node, __ATOMIC_RELEASE);
+
+        while (!__atomic_load_n(&node.Head, __ATOMIC_ACQUIRE))
+            asm volatile ( "pause \n\t" : : : "memory" );
+        //  Every waiter spins on its own node until its predecessor acquires
+        //  the lock.
+    }
+
+    //  Now this waiter is first in line, and only the owner stands between it
+    //  and the lock. Newcomers cannot barge in while the queue is not empty.
+
+    bool expected;
+
+    do
+    {
+        while (this->Locked)
+            asm volatile ( "pause \n\t" : : : "memory" );
+
+        expected = false;
+    } while (!__atomic_compare_exchange_n(&this->Locked, &expected, true
+        , false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED));
+
+    QueuedSpinlockNode * expectedTail = &node;
+
+    if (__atomic_compare_exchange_n(&this->Tail, &expectedTail, nullptr
+        , false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+        return;
+    //  Nobody queued behind this node, so the queue is now empty.
+
+    QueuedSpinlockNode * next;
+
+    while ((next = __atomic_load_n(&node.Next, __ATOMIC_ACQUIRE)) == nullptr)
+        asm volatile ( "pause \n\t" : : : "memory" );
+    //  A successor swapped the tail but hasn't linked itself yet.
+
+    __atomic_store_n(&next->Head, true, __ATOMIC_RELEASE);
+
+    //  The node is not referenced by anybody anymore, so it can go out of
+    //  scope.
+}
+
+namespace Beelzebub { namespace Synchronization
+{
+    template struct QueuedSpinlock<true>;
+    template struct QueuedSpinlock<false>;
+}}
@@ -0,0 +1,212 @@
+/*
+    Copyright (c) 2015 Alexandru-Mihai Maftei. All rights reserved.
+
+
+    Developed by: Alexandru-Mihai Maftei
+    aka Vercas
+    http://vercas.com | https://github.com/vercas/Beelzebub
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal with the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+      * Redistributions of source code must retain the above copyright notice,
+        this list of conditions and the following disclaimers.
+      * Redistributions in binary form must reproduce the above copyright
+        notice, this list of conditions and the following disclaimers in the
+        documentation and/or other materials provided with the distribution.
+      * Neither the names of Alexandru-Mihai Maftei, Vercas, nor the names of
+        its contributors may be used to endorse or promote products derived from
+        this Software without specific prior written permission.
+
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+    WITH THE SOFTWARE.
+
+    ---
+
+    You may also find the text of this license in "LICENSE.md", along with a more
+    thorough explanation regarding other files.
+*/
+
+#include <synchronization/rcu.hpp>
+#include <debug.hpp>
+
+using namespace Beelzebub;
+using namespace Beelzebub::Synchronization;
+using namespace Beelzebub::System;
+
+/****************
+    Rcu class
+****************/
+
+/*  Fields  */
+
+#if   defined(__BEELZEBUB_SETTINGS_SMP)
+Atomic<uint64_t> Rcu::CurrentPeriod {1};
+CpuData * volatile Rcu::FirstCpu = nullptr;
+#endif
+
+Spinlock<> Rcu::CallbacksLock {};
+RcuHead * volatile Rcu::FirstCallback = nullptr;
+RcuHead * Rcu::LastCallback = nullptr;
+
+/*  Update Side  */
+
+#if   defined(__BEELZEBUB_SETTINGS_SMP)
+void Rcu::Synchronize()
+{
+    if unlikely(!CpuDataSetUp)
+        return;
+    //  Only one CPU runs before its data is set up.
+
+    uint64_t const target = CurrentPeriod.FetchAdd(1) + 1;
+    //  Anything unpublished before this point cannot be found by read-side
+    //  critical sections which begin after the period is observed.
+
+    ReportQuiescentState();
+
+    while (GetCompletedPeriod() < target)
+    {
+        CpuInstructions::DoNothing();
+
+        ReportQuiescentState();
+    }
+}
+#endif
+
+void Rcu::Call(RcuHead * const head, RcuCallback const callback)
+{
+    head->Next = nullptr;
+    head->Callback = callback;
+
+    withInterrupts (false)
+    withLock (CallbacksLock)
+    {
+#if   defined(__BEELZEBUB_SETTINGS_SMP)
+        head->Period = CurrentPeriod.FetchAdd(1) + 1;
+        //  Every grace period a callback waits for begins after it is queued.
+#else
+        head->Period = 0;
+#endif
+
+        if (LastCallback == nullptr)
+            FirstCallback = head;
+        else
+            LastCallback->Next = head;
+
+        LastCallback = head;
+    }
+
+    //  The caller may be within a read-side critical section, so this is
+    //  not a quiescent state, and the callback cannot be invoked yet.
+}
+
+/*  Quiescent States  */
+
+#if   defined(__BEELZEBUB_SETTINGS_SMP)
+void Rcu::InitializeCpu()
+{
+    CpuData * const data = Cpu::GetData();
+
+    data->RcuQuiescentPeriod.Store(CurrentPeriod.Load());
+    data->RcuIdle.Store(false);
+
+    CpuData * first = FirstCpu;
+
+    do data->RcuNext = first;
+    while (!__atomic_compare_exchange_n(&FirstCpu, &first, data
+        , true, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED));
+    //  `first` is refreshed by every failed exchange.
+}
+
+void Rcu::ExitIdle()
+{
+    Cpu::GetData()->RcuIdle.Xchg(false);
+    //  The exchange is a full barrier, so updaters which do not see the CPU as
+    //  idle anymore will await it, and the others have already unpublished
+    //  what this CPU is about to read.
+}
+#endif
+
+void Rcu::ProcessCallbacks()
+{
+    RcuHead * ready = nullptr;
+
+    withInterrupts (false)
+    {
+        if (!CallbacksLock.TryAcquire())
+            return;
+        //  Only tried, because this runs in interrupt handlers too.
+
+#if   defined(__BEELZEBUB_SETTINGS_SMP)
+        uint64_t const completed = GetCompletedPeriod();
+#else
+        uint64_t const completed = UINT64_MAX;
+        //  The only CPU is outside of read-side critical sections, and so are
+        //  all those which queued callbacks before.
+#endif
+        RcuHead * last = nullptr;
+        RcuHead * cur = FirstCallback;
+
+        while (cur != nullptr && cur->Period <= completed)
+        {
+            last = cur;
+            cur = cur->Next;
+        }
+        //  Periods are increasing along the queue.
+
+        if (last != nullptr)
+        {
+            ready = FirstCallback;
+            last->Next = nullptr;
+
+            FirstCallback = cur;
+
+            if (cur == nullptr)
+                LastCallback = nullptr;
+        }
+
+        CallbacksLock.Release();
+    }
+
+    withInterrupts (false)
+        while (ready != nullptr)
+        {
+            RcuHead * const next = ready->Next;
+
+            ready->Callback(ready);
+
+            ready = next;
+        }
+}
+
+#if   defined(__BEELZEBUB_SETTINGS_SMP)
+uint64_t Rcu::GetCompletedPeriod()
+{
+    uint64_t completed = CurrentPeriod.Load();
+
+    for (CpuData * cpu = FirstCpu; cpu != nullptr; cpu = cpu->RcuNext)
+    {
+        if (cpu->RcuIdle.Load())
+            continue;
+        //  Idle CPUs have left their critical sections before the period
+        //  above was read.
+
+        uint64_t const period = cpu->RcuQuiescentPeriod.Load();
+
+        if (period < completed)
+            completed = period;
+    }
+
+    return completed;
+}
+#endif
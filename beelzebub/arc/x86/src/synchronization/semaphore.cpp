@@ -0,0 +1,163 @@
+/*
+    Copyright (c) 2015 Alexandru-Mihai Maftei. All rights reserved.
+
+
+    Developed by: Alexandru-Mihai Maftei
+    aka Vercas
+    http://vercas.com | https://github.com/vercas/Beelzebub
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal with the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+      * Redistributions of source code must retain the above copyright notice,
+        this list of conditions and the following disclaimers.
+      * Redistributions in binary form must reproduce the above copyright
+        notice, this list of conditions and the following disclaimers in the
+        documentation and/or other materials provided with the distribution.
+      * Neither the names of Alexandru-Mihai Maftei, Vercas, nor the names of
+        its contributors may be used to endorse or promote products derived from
+        this Software without specific prior written permission.
+
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+    WITH THE SOFTWARE.
+
+    ---
+
+    You may also find the text of this license in "LICENSE.md", along with a more
+    thorough explanation regarding other files.
+*/
+
+#include <synchronization/semaphore.hpp>
+#include <execution/yield.hpp>
+#include <system/cpu.hpp>
+#include <system/timers/tsc.hpp>
+
+using namespace Beelzebub;
+using namespace Beelzebub::Execution;
+using namespace Beelzebub::Synchronization;
+using namespace Beelzebub::System;
+using namespace Beelzebub::System::Timers;
+
+/**********************
+    Semaphore class
+**********************/
+
+/*  Operations  */
+
+bool Semaphore::TryAcquire()
+{
+    size_t count = this->Count.Load();
+
+    while (count > 0)
+        if (this->Count.CmpXchgWeak(count, count - 1))
+            return true;
+    //  `count` is refreshed by every failed exchange.
+
+    return false;
+}
+
+void Semaphore::Acquire()
+{
+    if likely(this->TryAcquire())
+        return;
+
+    this->AcquireContended(UINT64_MAX);
+}
+
+bool Semaphore::TryAcquire(uint64_t const timeout)
+{
+    if likely(this->TryAcquire())
+        return true;
+
+    if (timeout == 0)
+        return false;
+
+    return this->AcquireContended(timeout);
+}
+
+void Semaphore::Release(size_t count)
+{
+    InterruptGuard<> intGuard;
+    this->Guard.Acquire();
+
+    for (/* nothing */; count > 0; --count)
+        if (this->Waiters.WakeOne() == nullptr)
+            break;
+    //  Every woken waiter takes a unit with it.
+
+    if (count > 0)
+        this->Count += count;
+
+    this->Guard.Release();
+}
+
+bool Semaphore::AcquireContended(uint64_t const timeout)
+{
+    uint64_t const deadline = timeout == UINT64_MAX
+        ? UINT64_MAX
+        : Tsc::GetMonotonicNanoseconds() + timeout;
+
+    //  There is no owner to watch, so units released by other CPUs shortly are
+    //  awaited for a fixed amount of spins.
+
+    for (size_t i = 0; i < SpinCount; ++i)
+    {
+        CpuInstructions::DoNothing();
+
+        if (this->TryAcquire())
+            return true;
+    }
+
+    while (!Yield::IsPossible())
+    {
+        if (this->TryAcquire())
+            return true;
+
+        if (deadline != UINT64_MAX && Tsc::GetMonotonicNanoseconds() >= deadline)
+            return false;
+
+        CpuInstructions::DoNothing();
+    }
+
+    InterruptGuard<> intGuard;
+    this->Guard.Acquire();
+
+    if (this->TryAcquire())
+    {
+        this->Guard.Release();
+
+        return true;
+    }
+    //  Units are only added to the count while the guard is held and nobody
+    //  waits, so none can be missed past this point.
+
+    if (deadline == UINT64_MAX)
+    {
+        this->Waiters.Sleep(this->Guard);
+        //  The releaser has handed a unit over to this thread.
+
+        return true;
+    }
+
+    uint64_t const now = Tsc::GetMonotonicNanoseconds();
+
+    if (now >= deadline)
+    {
+        this->Guard.Release();
+
+        return false;
+    }
+
+    return this->Waiters.Sleep(this->Guard, deadline - now);
+    //  Unless it timed out, the releaser has handed a unit over to this thread.
+}
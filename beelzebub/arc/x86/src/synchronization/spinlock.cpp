@@ -72,6 +72,9 @@ using namespace Beelzebub::Synchronization;
     bool Spinlock<SMP>::TryAcquire() volatile
     #endif
     {
+        PREEMPTION_DISABLE();
+        LOCK_PROFILING_BEGIN;
+
         uint16_t const oldTail = this->Value.Tail;
         spinlock_t cmp {oldTail, oldTail};
         spinlock_t const newVal {oldTail, (uint16_t)(oldTail + 1)};
@@ -82,7 +85,17 @@ using namespace Beelzebub::Synchronization;
                     : [newVal]"r"(newVal)
                     : "cc" );
 
-        return cmp.Overall == cmpCpy.Overall;
+        if (cmp.Overall != cmpCpy.Overall)
+        {
+            LOCK_PROFILING_CANCELLED;
+            PREEMPTION_ENABLE();
+
+            return false;
+        }
+
+        LOCK_PROFILING_ACQUIRED_AT(this, __builtin_return_address(0));
+
+        return true;
     }
 
     #if   defined(__BEELZEBUB_SETTINGS_NO_SMP)
@@ -126,6 +139,9 @@ using namespace Beelzebub::Synchronization;
     void Spinlock<SMP>::Acquire() volatile
     #endif
     {
+        PREEMPTION_DISABLE();
+        LOCK_PROFILING_BEGIN;
+
         uint16_t myTicket = 1;
 
         asm volatile( "lock xaddw %[ticket], %[tail] \n\t"
@@ -135,7 +151,13 @@ using namespace Beelzebub::Synchronization;
         //  It's possible to address the upper word directly.
 
         while (this->Value.Head != myTicket)
+        {
+            LOCK_PROFILING_CONTENDED;
             asm volatile ( "pause \n\t" : : : "memory" );
+        }
+
+        LOCK_PROFILING_ACQUIRED_AT(this, __builtin_return_address(0));
+        //  The caller is the site, because this is not inlined.
     }
 
     #if   defined(__BEELZEBUB_SETTINGS_NO_SMP)
@@ -148,6 +170,9 @@ using namespace Beelzebub::Synchronization;
         asm volatile( "lock addw $1, %[head] \n\t"
                     : [head]"+m"(this->Value.Head)
                     : : "cc" );
+
+        LOCK_PROFILING_RELEASED(this);
+        PREEMPTION_ENABLE();
     }
 
     #if   defined(__BEELZEBUB_SETTINGS_NO_SMP)
@@ -72,7 +72,9 @@ using namespace Beelzebub::Synchronization;
     bool SpinlockUninterruptible<SMP>::TryAcquire(int_cookie_t & cookie) volatile
     #endif
     {
+        LOCK_PROFILING_BEGIN;
         cookie = System::Interrupts::PushDisable();
+        PREEMPTION_DISABLE();
 
         uint16_t const oldTail = this->Value.Tail;
         spinlock_t cmp {oldTail, oldTail};
@@ -85,10 +87,16 @@ using namespace Beelzebub::Synchronization;
                     : "cc" );
 
         if likely(cmp.Overall == cmpCpy.Overall)
+        {
+            LOCK_PROFILING_ACQUIRED_AT(this, __builtin_return_address(0));
+
             return true;
-        
+        }
+
+        LOCK_PROFILING_CANCELLED;
         System::Interrupts::RestoreState(cookie);
         //  If the spinlock was already locked, restore interrupt state.
+        PREEMPTION_ENABLE();
 
         return false;
     }
@@ -134,9 +142,12 @@ using namespace Beelzebub::Synchronization;
     int_cookie_t SpinlockUninterruptible<SMP>::Acquire() volatile
     #endif
     {
+        LOCK_PROFILING_BEGIN;
+
         uint16_t myTicket = 1;
 
         int_cookie_t const cookie = System::Interrupts::PushDisable();
+        PREEMPTION_DISABLE();
 
         asm volatile( "lock xaddw %[ticket], %[tail] \n\t"
                     : [tail]"+m"(this->Value.Tail)
@@ -145,7 +156,12 @@ using namespace Beelzebub::Synchronization;
         //  It's possible to address the upper word directly.
 
         while (this->Value.Head != myTicket)
+        {
+            LOCK_PROFILING_CONTENDED;
             asm volatile ( "pause \n\t" : : : "memory" );
+        }
+
+        LOCK_PROFILING_ACQUIRED_AT(this, __builtin_return_address(0));
 
         return cookie;
     }
@@ -157,6 +173,9 @@ using namespace Beelzebub::Synchronization;
     void SpinlockUninterruptible<SMP>::SimplyAcquire() volatile
     #endif
     {
+        PREEMPTION_DISABLE();
+        LOCK_PROFILING_BEGIN;
+
         uint16_t myTicket = 1;
 
         asm volatile( "lock xaddw %[ticket], %[tail] \n\t"
@@ -166,7 +185,12 @@ using namespace Beelzebub::Synchronization;
         //  It's possible to address the upper word directly.
 
         while (this->Value.Head != myTicket)
+        {
+            LOCK_PROFILING_CONTENDED;
             asm volatile ( "pause \n\t" : : : "memory" );
+        }
+
+        LOCK_PROFILING_ACQUIRED_AT(this, __builtin_return_address(0));
     }
 
     #if   defined(__BEELZEBUB_SETTINGS_NO_SMP)
@@ -180,7 +204,10 @@ using namespace Beelzebub::Synchronization;
                     : [head]"+m"(this->Value.Head)
                     : : "cc" );
 
+        LOCK_PROFILING_RELEASED(this);
+
         System::Interrupts::RestoreState(cookie);
+        PREEMPTION_ENABLE();
     }
 
     #if   defined(__BEELZEBUB_SETTINGS_NO_SMP)
@@ -193,6 +220,9 @@ using namespace Beelzebub::Synchronization;
         asm volatile( "lock addw $1, %[head] \n\t"
                     : [head]"+m"(this->Value.Head)
                     : : "cc" );
+
+        LOCK_PROFILING_RELEASED(this);
+        PREEMPTION_ENABLE();
     }
 
     #if   defined(__BEELZEBUB_SETTINGS_NO_SMP)
@@ -0,0 +1,209 @@
+/*
+    Copyright (c) 2015 Alexandru-Mihai Maftei. All rights reserved.
+
+
+    Developed by: Alexandru-Mihai Maftei
+    aka Vercas
+    http://vercas.com | https://github.com/vercas/Beelzebub
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal with the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+      * Redistributions of source code must retain the above copyright notice,
+        this list of conditions and the following disclaimers.
+      * Redistributions in binary form must reproduce the above copyright
+        notice, this list of conditions and the following disclaimers in the
+        documentation and/or other materials provided with the distribution.
+      * Neither the names of Alexandru-Mihai Maftei, Vercas, nor the names of
+        its contributors may be used to endorse or promote products derived from
+        this Software without specific prior written permission.
+
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+    WITH THE SOFTWARE.
+
+    ---
+
+    You may also find the text of this license in "LICENSE.md", along with a more
+    thorough explanation regarding other files.
+*/
+
+#include <synchronization/wait_queue.hpp>
+#include <execution/scheduler.hpp>
+#include <system/timers/timer_wheel.hpp>
+#include <system/cpu.hpp>
+#include <debug.hpp>
+
+using namespace Beelzebub;
+using namespace Beelzebub::Execution;
+using namespace Beelzebub::Synchronization;
+using namespace Beelzebub::System;
+using namespace Beelzebub::System::Timers;
+
+static void ExpireSleep(Timer * const timer);
+
+/**
+ *  State shared by a sleeper and the timer which ends its sleep.
+ */
+struct SleepTimeout
+{
+    inline SleepTimeout(WaitQueue * const queue, Spinlock<> * const lock, Thread * const sleeper)
+        : Ticker(&ExpireSleep, this)
+        , Queue(queue)
+        , Lock(lock)
+        , Sleeper(sleeper)
+        , Expired(false)
+    {
+
+    }
+
+    Timer Ticker;
+    WaitQueue * Queue;
+    Spinlock<> * Lock;
+    Thread * Sleeper;
+    bool volatile Expired;
+};
+
+static void ExpireSleep(Timer * const timer)
+{
+    SleepTimeout * const sleep = (SleepTimeout *)(timer->Cookie);
+
+    withInterrupts (false)
+    {
+        sleep->Lock->Acquire();
+
+        if (sleep->Queue->Remove(sleep->Sleeper))
+        {
+            sleep->Expired = true;
+
+            Scheduler::Wake(sleep->Sleeper);
+        }
+
+        sleep->Lock->Release();
+    }
+    //  A sleeper which is not in the queue anymore was woken up already.
+}
+
+/**********************
+    WaitQueue class
+**********************/
+
+/*  Operations  */
+
+void WaitQueue::Sleep(Spinlock<> & lock)
+{
+    Thread * const self = Cpu::GetThread();
+
+    assert(self != nullptr, "Cannot sleep without an active thread!");
+    assert(!Interrupts::AreEnabled(), "Interrupts must be disabled to sleep!");
+
+    self->WaitNext = nullptr;
+    self->Blocked = true;
+
+    if (this->Tail == nullptr)
+        this->Head = self;
+    else
+        this->Tail->WaitNext = self;
+
+    this->Tail = self;
+
+    lock.Release();
+
+    //  A waker may clear the flag at any moment after the lock is released,
+    //  even before the thread gives up its CPU.
+
+    Scheduler::Block();
+}
+
+bool WaitQueue::Sleep(Spinlock<> & lock, uint64_t const timeout)
+{
+    Thread * const self = Cpu::GetThread();
+
+    assert(self != nullptr, "Cannot sleep without an active thread!");
+    assert(!Interrupts::AreEnabled(), "Interrupts must be disabled to sleep!");
+
+    SleepTimeout sleep(this, &lock, self);
+
+    self->WaitNext = nullptr;
+    self->Blocked = true;
+
+    if (this->Tail == nullptr)
+        this->Head = self;
+    else
+        this->Tail->WaitNext = self;
+
+    this->Tail = self;
+
+    sleep.Ticker.Start(timeout);
+    //  The timer function needs the lock, so it cannot act before the release.
+
+    lock.Release();
+
+    Scheduler::Block();
+
+    sleep.Ticker.Cancel();
+    //  The timer function may still be using the lock and the queue.
+
+    return !sleep.Expired;
+}
+
+Thread * WaitQueue::WakeOne()
+{
+    Thread * const thread = this->Head;
+
+    if (thread == nullptr)
+        return nullptr;
+
+    this->Head = thread->WaitNext;
+
+    if (this->Head == nullptr)
+        this->Tail = nullptr;
+
+    thread->WaitNext = nullptr;
+
+    Scheduler::Wake(thread);
+
+    return thread;
+}
+
+size_t WaitQueue::WakeAll()
+{
+    size_t count = 0;
+
+    while (this->WakeOne() != nullptr)
+        ++count;
+
+    return count;
+}
+
+bool WaitQueue::Remove(Thread * const thread)
+{
+    Thread * prev = nullptr;
+
+    for (Thread * cur = this->Head; cur != nullptr; prev = cur, cur = cur->WaitNext)
+        if (cur == thread)
+        {
+            if (prev == nullptr)
+                this->Head = cur->WaitNext;
+            else
+                prev->WaitNext = cur->WaitNext;
+
+            if (this->Tail == cur)
+                this->Tail = prev;
+
+            cur->WaitNext = nullptr;
+
+            return true;
+        }
+
+    return false;
+}
@@ -61,6 +61,9 @@ SystemDescriptorTableSource MadtSrc   = SystemDescriptorTableSource::None;
 paddr_t                     SratPaddr = nullpaddr;
 SystemDescriptorTableSource SratSrc   = SystemDescriptorTableSource::None;
 
+paddr_t                     HpetPaddr = nullpaddr;
+SystemDescriptorTableSource HpetSrc   = SystemDescriptorTableSource::None;
+
 /*****************
     ACPI class
 *****************/
@@ -72,6 +75,7 @@ acpi_table_rsdt * Acpi::RsdtPointer = nullptr;
 acpi_table_xsdt * Acpi::XsdtPointer = nullptr;
 acpi_table_madt * Acpi::MadtPointer = nullptr;
 acpi_table_srat * Acpi::SratPointer = nullptr;
+acpi_table_hpet * Acpi::HpetPointer = nullptr;
 
 size_t Acpi::LapicCount = 0;
 size_t Acpi::PresentLapicCount = 0;
@@ -342,6 +346,8 @@ Handle Acpi::HandleSystemDescriptorTable(paddr_t const paddr, SystemDescriptorTa
         return Acpi::HandleMadt(vaddr, paddr, src);
     else if (memeq(headerPtr->Signature, ACPI_SIG_SRAT, ACPI_NAME_SIZE))
         return Acpi::HandleSrat(vaddr, paddr, src);
+    else if (memeq(headerPtr->Signature, ACPI_SIG_HPET, ACPI_NAME_SIZE))
+        return Acpi::HandleHpet(vaddr, paddr, src);
 
     return HandleResult::Okay;
 }
@@ -430,6 +436,23 @@ Handle Acpi::HandleSrat(vaddr_t const vaddr, paddr_t const paddr, SystemDescript
     return HandleResult::Okay;
 }
 
+Handle Acpi::HandleHpet(vaddr_t const vaddr, paddr_t const paddr, SystemDescriptorTableSource const src)
+{
+    if (HpetPaddr == paddr || (HpetSrc != src && HpetSrc != SystemDescriptorTableSource::None))
+        return HandleResult::Okay;
+    //  Same physical address or different source table? No problemo, then.
+
+    if (HpetPointer != nullptr)
+        return HandleResult::Okay;
+    //  Machines may have several timer blocks, but one suffices.
+
+    HpetPointer = (acpi_table_hpet *)(uintptr_t)vaddr;
+    HpetPaddr = paddr;
+    HpetSrc = src;
+
+    return HandleResult::Okay;
+}
+
 /*  Utilities  */
 
 Handle Acpi::MapTable(paddr_t const header, vaddr_t & ptr)
@@ -514,3 +537,17 @@ Handle Acpi::FindLapicPaddr(paddr_t & paddr)
 
     return HandleResult::Okay;
 }
+
+Handle Acpi::FindHpetPaddr(paddr_t & paddr)
+{
+    if (HpetPointer == nullptr)
+        return HandleResult::NotFound;
+
+    if (HpetPointer->Address.SpaceId != 0)
+        return HandleResult::UnsupportedOperation;
+    //  The registers must be in the system memory space.
+
+    paddr = (paddr_t)HpetPointer->Address.Address;
+
+    return HandleResult::Okay;
+}
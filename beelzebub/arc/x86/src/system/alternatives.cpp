@@ -0,0 +1,116 @@
+/*
+    Copyright (c) 2015 Alexandru-Mihai Maftei. All rights reserved.
+
+
+    Developed by: Alexandru-Mihai Maftei
+    aka Vercas
+    http://vercas.com | https://github.com/vercas/Beelzebub
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal with the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+      * Redistributions of source code must retain the above copyright notice,
+        this list of conditions and the following disclaimers.
+      * Redistributions in binary form must reproduce the above copyright
+        notice, this list of conditions and the following disclaimers in the
+        documentation and/or other materials provided with the distribution.
+      * Neither the names of Alexandru-Mihai Maftei, Vercas, nor the names of
+        its contributors may be used to endorse or promote products derived from
+        this Software without specific prior written permission.
+
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+    WITH THE SOFTWARE.
+
+    ---
+
+    You may also find the text of this license in "LICENSE.md", along with a more
+    thorough explanation regarding other files.
+*/
+
+#include <system/alternatives.hpp>
+#include <system/stop_machine.hpp>
+#include <system/code_patch.hpp>
+
+#include <debug.hpp>
+
+using namespace Beelzebub;
+using namespace Beelzebub::System;
+
+struct AlternativeEntry
+{
+    uintptr_t Original;
+    uintptr_t Replacement;
+    uintptr_t OriginalSize;
+    uintptr_t ReplacementSize;
+    uintptr_t Feature;
+};
+
+__extern AlternativeEntry const alternatives_section_start;
+__extern AlternativeEntry const alternatives_section_end;
+
+static size_t AppliedCount = 0;
+
+struct ApplyCookie
+{
+    CpuId const * Cpuid;
+    bool Okay;
+};
+
+static void ApplyAll(void * cookie)
+{
+    ApplyCookie * const apply = reinterpret_cast<ApplyCookie *>(cookie);
+
+    for (AlternativeEntry const * entry = &alternatives_section_start; entry < &alternatives_section_end; ++entry)
+    {
+        if (!apply->Cpuid->CheckFeature((CpuFeature)entry->Feature))
+            continue;
+
+        bool const okay = WriteCode(reinterpret_cast<void *>(entry->Original), entry->OriginalSize
+            , reinterpret_cast<void const *>(entry->Replacement), entry->ReplacementSize);
+
+        assert_or(okay, "Failed to apply alternative %Xp over %Xp."
+            , entry->Replacement, entry->Original)
+        {
+            apply->Okay = false;
+
+            continue;
+        }
+
+        ++AppliedCount;
+    }
+}
+
+/*************************
+    Alternatives class
+*************************/
+
+/*  Operations  */
+
+Handle Alternatives::Apply(CpuId const & cpuid)
+{
+    ApplyCookie apply { &cpuid, true };
+
+    Handle res = StopMachine::Run(&ApplyAll, &apply);
+
+    if (res.IsOkayResult() && !apply.Okay)
+        return HandleResult::Failed;
+
+    return res;
+}
+
+/*  Properties  */
+
+size_t Alternatives::GetAppliedCount()
+{
+    return AppliedCount;
+}
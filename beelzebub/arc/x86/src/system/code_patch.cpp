@@ -38,6 +38,9 @@
 */
 
 #include <system/code_patch.hpp>
+#include <system/cpu.hpp>
+#include <system/interrupts.hpp>
+#include <entry.h>
 #include <string.h>
 
 using namespace Beelzebub;
@@ -134,3 +137,28 @@ bool System::TurnIntoNoOp(void * start, void * end, bool useJump)
 
     return true;
 }
+
+bool System::WriteCode(void * location, size_t size, void const * code, size_t codeSize)
+{
+    if (codeSize > size)
+        return false;
+
+    bool okay;
+
+    withInterrupts (false)
+    withWriteProtect (false)
+    {
+        memcpy(location, code, codeSize);
+
+        okay = TurnIntoNoOp(reinterpret_cast<uint8_t *>(location) + codeSize
+            , reinterpret_cast<uint8_t *>(location) + size, true);
+    }
+
+    size_t const cacheLineSize = BootstrapCpuid.GetClflushLineSize();
+    uintptr_t const end = reinterpret_cast<uintptr_t>(location) + size;
+
+    for (uintptr_t i = reinterpret_cast<uintptr_t>(location) & ~(cacheLineSize - 1); i < end; i += cacheLineSize)
+        CpuInstructions::FlushCache(reinterpret_cast<void *>(i));
+
+    return okay;
+}
@@ -92,6 +92,12 @@ void CpuId::Initialize()
     Execute(0x80000001U, this->ExtendedSignature, this->FeatureFlagsExtendedB
                        , this->FeatureFlagsExtendedC, this->FeatureIntegers[2]);
 
+    //  Find the advanced power management flags.
+    if (this->MaxExtendedValue >= 0x80000007U)
+        Execute(0x80000007U, dummy, dummy, dummy, this->FeatureIntegers[3]);
+    else
+        this->FeatureIntegers[3] = 0;
+
     if      (memeq(this->VendorString.Characters, "GenuineIntel", 12))
     {
         this->Vendor = CpuVendor::Intel;
@@ -160,7 +166,7 @@ bool CpuId::CheckFeature(const CpuFeature feature) const
     FEATUREBITEX(val, varInd, bit);
     //  Extracts the relevant information.
 
-    if (varInd < 3)
+    if (varInd < 4)
         return 0 != (this->FeatureIntegers[varInd] & bit);
     else
         return false;
@@ -0,0 +1,271 @@
+/*
+    Copyright (c) 2015 Alexandru-Mihai Maftei. All rights reserved.
+
+
+    Developed by: Alexandru-Mihai Maftei
+    aka Vercas
+    http://vercas.com | https://github.com/vercas/Beelzebub
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal with the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+      * Redistributions of source code must retain the above copyright notice,
+        this list of conditions and the following disclaimers.
+      * Redistributions in binary form must reproduce the above copyright
+        notice, this list of conditions and the following disclaimers in the
+        documentation and/or other materials provided with the distribution.
+      * Neither the names of Alexandru-Mihai Maftei, Vercas, nor the names of
+        its contributors may be used to endorse or promote products derived from
+        this Software without specific prior written permission.
+
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+    WITH THE SOFTWARE.
+
+    ---
+
+    You may also find the text of this license in "LICENSE.md", along with a more
+    thorough explanation regarding other files.
+*/
+
+#include <system/cross_cpu.hpp>
+#include <system/cpu.hpp>
+#include <system/interrupt_controllers/lapic.hpp>
+#include <synchronization/atomic.hpp>
+#include <kernel.hpp>
+
+#include <debug.hpp>
+
+using namespace Beelzebub;
+using namespace Beelzebub::Synchronization;
+using namespace Beelzebub::System;
+using namespace Beelzebub::System::InterruptControllers;
+
+/**
+ *  A function to run on a number of CPUs.
+ */
+struct Beelzebub::System::CrossCpuCall
+{
+    CrossCpuFunction Function;
+    void * Cookie;
+
+    Atomic<size_t> Pending;
+    //  CPUs which have not run the function yet.
+};
+
+#if   defined(__BEELZEBUB_SETTINGS_SMP)
+static CpuData * Cpus[CpuMask::Capacity];
+//  By index; null for CPUs which cannot be called yet.
+
+static CrossCpuCall AsyncCalls[CrossCpu::AsyncCallCount];
+
+/**
+ *  Runs the calls queued for the given CPU, which must be the current one.
+ *  Interrupts must be disabled.
+ */
+static void ProcessCalls(CpuData * const data)
+{
+    __atomic_store_n(&(data->CallRequested), false, __ATOMIC_SEQ_CST);
+    //  Calls queued from now on send another IPI, so none are left behind.
+
+    CrossCpuCall * call;
+
+    while (data->CallQueue.TryPop(call))
+    {
+        call->Function(call->Cookie);
+
+        --call->Pending;
+        //  The call may be reused or gone after this.
+    }
+}
+
+/**
+ *  Queues a call for the given CPU, sending it an IPI unless one is pending.
+ *  Interrupts must be disabled.
+ */
+static void Send(CpuData * const self, CpuData * const target, CrossCpuCall * const call)
+{
+    while (!target->CallQueue.TryPush(call))
+    {
+        ProcessCalls(self);
+        //  The target may be waiting for this CPU to make room too.
+
+        CpuInstructions::DoNothing();
+    }
+
+    if (__atomic_exchange_n(&(target->CallRequested), true, __ATOMIC_SEQ_CST))
+        return;
+    //  The target has yet to drain its queue, which now includes this call.
+
+    Lapic::SendIpi(LapicIcr(0)
+    .SetDeliveryMode(InterruptDeliveryModes::Fixed)
+    .SetDestinationShorthand(IcrDestinationShorthand::None)
+    .SetAssert(true)
+    .SetVector(CrossCpu::Vector)
+    .SetDestination(target->LapicId));
+}
+
+/**
+ *  Obtains a free call which outlives its caller.
+ */
+static CrossCpuCall * ClaimAsyncCall(CpuData * const self, size_t const count)
+{
+    while (true)
+    {
+        for (size_t i = 0; i < CrossCpu::AsyncCallCount; ++i)
+        {
+            size_t expected = 0;
+
+            if (AsyncCalls[i].Pending.CmpXchgStrong(expected, count))
+                return AsyncCalls + i;
+        }
+
+        ProcessCalls(self);
+        CpuInstructions::DoNothing();
+    }
+}
+
+/**
+ *  Waits for all the CPUs to run the given call.
+ */
+static void Await(CrossCpuCall * const call)
+{
+    while (call->Pending.Load(MemoryOrder::Acquire) != 0)
+    {
+        if (!Interrupts::AreEnabled())
+            ProcessCalls(Cpu::GetData());
+        //  Whoever runs this call may be waiting for this CPU as well.
+
+        CpuInstructions::DoNothing();
+    }
+}
+#endif
+
+/*********************
+    CrossCpu class
+*********************/
+
+/*  Interrupt Handler  */
+
+void CrossCpu::Handler(INTERRUPT_HANDLER_ARGS)
+{
+#if   defined(__BEELZEBUB_SETTINGS_SMP)
+    ProcessCalls(Cpu::GetData());
+#endif
+
+    Lapic::EndOfInterrupt();
+}
+
+/*  Initialization  */
+
+void CrossCpu::InitializeCpu()
+{
+#if   defined(__BEELZEBUB_SETTINGS_SMP)
+    CpuData * const data = Cpu::GetData();
+
+    assert(data->Index < CpuMask::Capacity
+        , "CPU #%us cannot be called; only %us CPUs can."
+        , data->Index, CpuMask::Capacity);
+
+    data->LapicId = Lapic::GetId();
+    data->CallRequested = false;
+
+    __atomic_store_n(Cpus + data->Index, data, __ATOMIC_RELEASE);
+#endif
+}
+
+/*  Operations  */
+
+Handle CrossCpu::CallOnCpu(size_t const cpu, CrossCpuFunction const func
+    , void * const cookie, bool const wait)
+{
+    if (cpu >= CpuMask::Capacity)
+        return HandleResult::ArgumentOutOfRange;
+
+    return CallOnMask(CpuMask().Set(cpu), func, cookie, wait);
+}
+
+Handle CrossCpu::CallOnMask(CpuMask const & mask, CrossCpuFunction const func
+    , void * const cookie, bool const wait)
+{
+#if   defined(__BEELZEBUB_SETTINGS_SMP)
+    CrossCpuCall local;
+    CrossCpuCall * call = nullptr;
+
+    withInterrupts (false)
+    {
+        CpuData * const self = Cpu::GetData();
+        size_t count = 0;
+
+        for (size_t i = 0; i < CpuMask::Capacity; ++i)
+            if (i != self->Index && mask.Get(i))
+            {
+                if (__atomic_load_n(Cpus + i, __ATOMIC_ACQUIRE) == nullptr)
+                    return HandleResult::ArgumentOutOfRange;
+
+                ++count;
+            }
+
+        if (count > 0)
+        {
+            if (wait)
+            {
+                call = &local;
+                call->Pending.Store(count, MemoryOrder::Relaxed);
+            }
+            else
+                call = ClaimAsyncCall(self, count);
+
+            call->Function = func;
+            call->Cookie = cookie;
+
+            for (size_t i = 0; i < CpuMask::Capacity; ++i)
+                if (i != self->Index && mask.Get(i))
+                    Send(self, Cpus[i], call);
+            //  Whatever is pushed into the queues is published by them.
+        }
+
+        if (mask.Get(self->Index))
+            func(cookie);
+    }
+
+    if (wait && call != nullptr)
+        Await(call);
+#else
+    for (size_t i = 1; i < CpuMask::Capacity; ++i)
+        if (mask.Get(i))
+            return HandleResult::ArgumentOutOfRange;
+    //  There is only one CPU.
+
+    if (mask.Get(0))
+        withInterrupts (false)
+            func(cookie);
+#endif
+
+    return HandleResult::Okay;
+}
+
+Handle CrossCpu::CallOnAll(CrossCpuFunction const func, void * const cookie
+    , bool const wait)
+{
+    CpuMask mask;
+
+#if   defined(__BEELZEBUB_SETTINGS_SMP)
+    for (size_t i = 0; i < CpuMask::Capacity; ++i)
+        if (__atomic_load_n(Cpus + i, __ATOMIC_ACQUIRE) != nullptr)
+            mask.Set(i);
+#else
+    mask.Set(0);
+#endif
+
+    return CallOnMask(mask, func, cookie, wait);
+}
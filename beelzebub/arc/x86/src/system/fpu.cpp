@@ -40,6 +40,7 @@
 #include <system/fpu.hpp>
 #include <system/cpu.hpp>
 #include <system/xcrs.hpp>
+#include <system/msrs.hpp>
 #include <entry.h>
 
 #include <debug.hpp>
@@ -62,11 +63,14 @@ using namespace Beelzebub::System;
 bool Fpu::Available = false;
 bool Fpu::Sse = false;
 bool Fpu::Avx = false;
+bool Fpu::Avx512 = false;
 bool Fpu::Xsave = false;
 
 size_t Fpu::StateSize = 0;
 size_t Fpu::StateAlignment = 0;
 
+FpuSaveMode Fpu::SaveMode = FpuSaveMode::Fxsave;
+
 XsaveRfbm Fpu::Xcr0 {};
 
 /*  Initialization  */
@@ -90,12 +94,28 @@ void Fpu::InitializeMain()
             uint32_t w, x, y, z;
             CpuId::Execute(0xDU, 0U, w, x, y, z);
 
-            ASSERT(y >= Fpu::StateSize
-                , "New FPU state size (%u4) shouldn't be smaller than the first"
-                  " one (%us)."
-                , y, Fpu::StateSize);
+            Fpu::Xcr0 = Fpu::Xcr0.SetX87(true).SetSse(Fpu::Sse).SetAvx(true);
+
+            if ((w & 0xE0U) == 0xE0U)
+            {
+                Fpu::Avx512 = true;
+
+                Fpu::Xcr0 = Fpu::Xcr0.SetAvx512Opmask(true)
+                                     .SetAvx512ZmmHigh256(true)
+                                     .SetAvx512High16Zmm(true);
+            }
+            //  The three AVX-512 components can only be enabled together.
 
-            Fpu::StateSize = y;
+            CpuId::Execute(0xDU, 1U, w, x, y, z);
+
+            if (w & 0x8U)
+                Fpu::SaveMode = FpuSaveMode::Xsaves;
+            else if (w & 0x2U)
+                Fpu::SaveMode = FpuSaveMode::Xsavec;
+            else if (w & 0x1U)
+                Fpu::SaveMode = FpuSaveMode::Xsaveopt;
+            else
+                Fpu::SaveMode = FpuSaveMode::Xsave;
         }
         
         if (!Fpu::Avx)
@@ -108,11 +128,30 @@ void Fpu::InitializeMain()
         Fpu::StateAlignment = 0;
     }
 
-    // msg("** FPU%b SSE%b AVX%b XSAVE%b; SS=%us SA=%us **%n"
-    //     , Fpu::Available, Fpu::Sse, Fpu::Avx, Fpu::Xsave
-    //     , Fpu::StateSize, Fpu::StateAlignment);
-
     Fpu::InitializeSecondary();
+
+    if (Fpu::Xsave)
+    {
+        uint32_t w, x, y, z;
+
+        if (Fpu::SaveMode >= FpuSaveMode::Xsavec)
+            CpuId::Execute(0xDU, 1U, w, x, y, z);
+        else
+            CpuId::Execute(0xDU, 0U, w, x, y, z);
+        //  Either way, EBX is the size for the components enabled right now,
+        //  in the compacted or the standard format respectively.
+
+        ASSERT(x >= Fpu::StateSize
+            , "New FPU state size (%u4) shouldn't be smaller than the first"
+              " one (%us)."
+            , x, Fpu::StateSize);
+
+        Fpu::StateSize = x;
+    }
+
+    // msg("** FPU%b SSE%b AVX%b AVX-512%b XSAVE%b/%u1; SS=%us SA=%us **%n"
+    //     , Fpu::Available, Fpu::Sse, Fpu::Avx, Fpu::Avx512, Fpu::Xsave
+    //     , (uint8_t)Fpu::SaveMode, Fpu::StateSize, Fpu::StateAlignment);
 }
 
 void Fpu::InitializeSecondary()
@@ -121,9 +160,11 @@ void Fpu::InitializeSecondary()
 
     if (Fpu::Xsave)
     {
-        Fpu::Xcr0 = Fpu::Xcr0.SetX87(Fpu::Available).SetSse(Fpu::Sse).SetAvx(Fpu::Avx);
-
         Xcrs::Write(0, Fpu::Xcr0.Low, Fpu::Xcr0.High);
+
+        if (Fpu::SaveMode == FpuSaveMode::Xsaves)
+            Msrs::Write(Msr::IA32_XSS, 0);
+        //  No supervisor components, so XSAVES saves the same as XSAVEC.
     }
 
     if (Fpu::Available)
@@ -136,26 +177,69 @@ void Fpu::InitializeSecondary()
 
 void Fpu::SaveState(void * state)
 {
-    if (Fpu::Xsave)
+    //  The modified optimization of XSAVEOPT and XSAVES relies on a thread's
+    //  state never being saved by a CPU which did not restore it last; see
+    //  `Scheduler::Steal`.
+
+    switch (Fpu::SaveMode)
     {
+    case FpuSaveMode::Xsaves:
+        asm volatile (  "xsaves" SAVE_SUFFIX " %[ptr] \n\t"
+                     :
+                     : [ptr]"m"(*((char *)state))
+                     , "a"(Fpu::Xcr0.Low), "d"(Fpu::Xcr0.High) );
+        break;
+
+    case FpuSaveMode::Xsavec:
+        asm volatile (  "xsavec" SAVE_SUFFIX " %[ptr] \n\t"
+                     :
+                     : [ptr]"m"(*((char *)state))
+                     , "a"(Fpu::Xcr0.Low), "d"(Fpu::Xcr0.High) );
+        break;
+
+    case FpuSaveMode::Xsaveopt:
+        asm volatile (  "xsaveopt" SAVE_SUFFIX " %[ptr] \n\t"
+                     :
+                     : [ptr]"m"(*((char *)state))
+                     , "a"(Fpu::Xcr0.Low), "d"(Fpu::Xcr0.High) );
+        break;
+
+    case FpuSaveMode::Xsave:
         asm volatile (  "xsave" SAVE_SUFFIX " %[ptr] \n\t"
                      :
                      : [ptr]"m"(*((char *)state))
                      , "a"(Fpu::Xcr0.Low), "d"(Fpu::Xcr0.High) );
-    }
-    else
+        break;
+
+    default:
         asm volatile ( "fxsave" SAVE_SUFFIX " %[ptr] \n\t" : : [ptr]"m"(*((char *)state)) );
+        break;
+    }
 }
 
 void Fpu::LoadState(void * state)
 {
-    if (Fpu::Xsave)
+    switch (Fpu::SaveMode)
     {
+    case FpuSaveMode::Xsaves:
+        asm volatile (  "xrstors" SAVE_SUFFIX " %[ptr] \n\t"
+                     :
+                     : [ptr]"m"(*((char *)state))
+                     , "a"(Fpu::Xcr0.Low), "d"(Fpu::Xcr0.High) );
+        break;
+
+    case FpuSaveMode::Xsavec:
+    case FpuSaveMode::Xsaveopt:
+    case FpuSaveMode::Xsave:
         asm volatile (  "xrstor" SAVE_SUFFIX " %[ptr] \n\t"
                      :
                      : [ptr]"m"(*((char *)state))
                      , "a"(Fpu::Xcr0.Low), "d"(Fpu::Xcr0.High) );
-    }
-    else
+        break;
+        //  XRSTOR tells the compacted format apart by XCOMP_BV.
+
+    default:
         asm volatile ( "fxrstor" SAVE_SUFFIX " %[ptr] \n\t" : : [ptr]"m"(*((char *)state)) );
+        break;
+    }
 }
@@ -0,0 +1,110 @@
+/*
+    Copyright (c) 2015 Alexandru-Mihai Maftei. All rights reserved.
+
+
+    Developed by: Alexandru-Mihai Maftei
+    aka Vercas
+    http://vercas.com | https://github.com/vercas/Beelzebub
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal with the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+      * Redistributions of source code must retain the above copyright notice,
+        this list of conditions and the following disclaimers.
+      * Redistributions in binary form must reproduce the above copyright
+        notice, this list of conditions and the following disclaimers in the
+        documentation and/or other materials provided with the distribution.
+      * Neither the names of Alexandru-Mihai Maftei, Vercas, nor the names of
+        its contributors may be used to endorse or promote products derived from
+        this Software without specific prior written permission.
+
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+    WITH THE SOFTWARE.
+
+    ---
+
+    You may also find the text of this license in "LICENSE.md", along with a more
+    thorough explanation regarding other files.
+*/
+
+#include <system/mwait.hpp>
+#include <system/cpuid.hpp>
+#include <system/timers/tsc.hpp>
+#include <entry.h>
+
+using namespace Beelzebub;
+using namespace Beelzebub::System;
+using namespace Beelzebub::System::Timers;
+
+/*****************
+    Mwait class
+*****************/
+
+/*  Statics  */
+
+bool Mwait::Available = false;
+
+uint32_t Mwait::DeepHint = Mwait::ShallowHint;
+uint32_t Mwait::DeepState = 1;
+
+uint64_t Mwait::ThresholdTicks = 0;
+
+/*  Initialization  */
+
+bool Mwait::Initialize()
+{
+    if (!BootstrapCpuid.CheckFeature(CpuFeature::MONITOR)
+        || BootstrapCpuid.MaxStandardValue < 0x5U)
+        return false;
+    //  Leaf 5 describes the monitored lines and the C-states.
+
+    uint32_t a, b, c, d;
+
+    CpuId::Execute(0x5U, a, b, c, d);
+
+    if ((a & 0xFFFFU) == 0)
+        return false;
+    //  No monitor line size means it cannot be used. Lines larger than the
+    //  wake lines merely cause spurious wakeups.
+
+    ThresholdTicks = Tsc::FromNanoseconds(ShallowThreshold);
+    Available = true;
+
+    if ((c & 0x1U) == 0)
+        return true;
+    //  Sub-states are not enumerated, so only C1 is known to work.
+
+    uint32_t const subStates = d;
+
+    if (BootstrapCpuid.MaxStandardValue < 0x6U)
+        return true;
+
+    CpuId::Execute(0x6U, a, b, c, d);
+
+    if ((a & 0x4U) == 0)
+        return true;
+    //  Without an always-running APIC timer, it may stop in deeper C-states.
+
+    for (uint32_t state = 7; state > 1; --state)
+        if (((subStates >> (state * 4)) & 0xFU) != 0)
+        {
+            DeepHint = (state - 1) << 4;
+            DeepState = state;
+
+            break;
+        }
+    //  EDX holds the number of sub-states of C0 through C7, a nibble each.
+    //  The first sub-state of a C-state is the shallowest.
+
+    return true;
+}
@@ -0,0 +1,117 @@
+/*
+    Copyright (c) 2015 Alexandru-Mihai Maftei. All rights reserved.
+
+
+    Developed by: Alexandru-Mihai Maftei
+    aka Vercas
+    http://vercas.com | https://github.com/vercas/Beelzebub
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal with the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+      * Redistributions of source code must retain the above copyright notice,
+        this list of conditions and the following disclaimers.
+      * Redistributions in binary form must reproduce the above copyright
+        notice, this list of conditions and the following disclaimers in the
+        documentation and/or other materials provided with the distribution.
+      * Neither the names of Alexandru-Mihai Maftei, Vercas, nor the names of
+        its contributors may be used to endorse or promote products derived from
+        this Software without specific prior written permission.
+
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+    WITH THE SOFTWARE.
+
+    ---
+
+    You may also find the text of this license in "LICENSE.md", along with a more
+    thorough explanation regarding other files.
+*/
+
+#include <system/static_key.hpp>
+#include <system/stop_machine.hpp>
+#include <system/code_patch.hpp>
+#include <string.h>
+
+#include <debug.hpp>
+
+using namespace Beelzebub;
+using namespace Beelzebub::System;
+
+struct StaticKeySite
+{
+    uintptr_t Code;
+    uintptr_t Target;
+    StaticKey * Key;
+};
+
+__extern StaticKeySite const static_keys_section_start;
+__extern StaticKeySite const static_keys_section_end;
+
+static uint8_t const SiteNop[StaticKey::SiteSize] = {0x0F, 0x1F, 0x44, 0x00, 0x00};
+
+struct StaticKeyChange
+{
+    StaticKey * Key;
+    bool Value;
+    bool Okay;
+};
+
+static void PatchSites(void * cookie)
+{
+    StaticKeyChange * const change = reinterpret_cast<StaticKeyChange *>(cookie);
+
+    for (StaticKeySite const * site = &static_keys_section_start; site < &static_keys_section_end; ++site)
+    {
+        if (site->Key != change->Key)
+            continue;
+
+        uint8_t code[StaticKey::SiteSize];
+
+        if (change->Value)
+        {
+            int32_t const offset = (int32_t)(site->Target - (site->Code + StaticKey::SiteSize));
+
+            code[0] = 0xE9;
+            memcpy(code + 1, &offset, sizeof(offset));
+            //  Always a 32-bit relative jump, so it fits in the no-op.
+        }
+        else
+            memcpy(code, SiteNop, StaticKey::SiteSize);
+
+        if (!WriteCode(reinterpret_cast<void *>(site->Code), StaticKey::SiteSize, code, StaticKey::SiteSize))
+            change->Okay = false;
+    }
+
+    change->Key->Enabled = change->Value;
+}
+
+/**********************
+    StaticKey struct
+**********************/
+
+/*  Operations  */
+
+Handle StaticKey::Set(bool const value)
+{
+    if (this->Enabled == value)
+        return HandleResult::Okay;
+
+    StaticKeyChange change { this, value, true };
+
+    Handle res = StopMachine::Run(&PatchSites, &change);
+
+    if (res.IsOkayResult() && !change.Okay)
+        return HandleResult::Failed;
+
+    return res;
+}
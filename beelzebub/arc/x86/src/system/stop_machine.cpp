@@ -0,0 +1,145 @@
+/*
+    Copyright (c) 2015 Alexandru-Mihai Maftei. All rights reserved.
+
+
+    Developed by: Alexandru-Mihai Maftei
+    aka Vercas
+    http://vercas.com | https://github.com/vercas/Beelzebub
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal with the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+      * Redistributions of source code must retain the above copyright notice,
+        this list of conditions and the following disclaimers.
+      * Redistributions in binary form must reproduce the above copyright
+        notice, this list of conditions and the following disclaimers in the
+        documentation and/or other materials provided with the distribution.
+      * Neither the names of Alexandru-Mihai Maftei, Vercas, nor the names of
+        its contributors may be used to endorse or promote products derived from
+        this Software without specific prior written permission.
+
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+    WITH THE SOFTWARE.
+
+    ---
+
+    You may also find the text of this license in "LICENSE.md", along with a more
+    thorough explanation regarding other files.
+*/
+
+#include <system/stop_machine.hpp>
+#include <system/cpu.hpp>
+#include <system/cpuid.hpp>
+#include <system/exceptions.hpp>
+#include <system/interrupt_controllers/lapic.hpp>
+#include <synchronization/atomic.hpp>
+#include <synchronization/spinlock.hpp>
+#include <kernel.hpp>
+
+#include <debug.hpp>
+
+using namespace Beelzebub;
+using namespace Beelzebub::Synchronization;
+using namespace Beelzebub::System;
+using namespace Beelzebub::System::InterruptControllers;
+
+#if   defined(__BEELZEBUB_SETTINGS_SMP)
+static Spinlock<> RunLock;
+static Atomic<bool> Stopping {false};
+static Atomic<size_t> Arrived {0};
+static Atomic<size_t> Departed {0};
+static Atomic<bool> Released {false};
+#endif
+
+/************************
+    StopMachine class
+************************/
+
+/*  Interrupt Handler  */
+
+void StopMachine::Handler(INTERRUPT_HANDLER_ARGS)
+{
+#if   defined(__BEELZEBUB_SETTINGS_SMP)
+    if (!Stopping.Load(MemoryOrder::Acquire))
+        return MiscellaneousInterruptHandler(state, ender, handler, vector);
+    //  Only globals are touched below, because the NMI may have arrived
+    //  before the kernel's GS was loaded.
+
+    ++Arrived;
+
+    while (!Released.Load(MemoryOrder::Acquire))
+        CpuInstructions::DoNothing();
+
+    uint32_t a, b, c, d;
+    CpuId::Execute(0, a, b, c, d);
+    //  Serializes, so no stale instructions of patched code are executed.
+
+    ++Departed;
+#else
+    MiscellaneousInterruptHandler(state, ender, handler, vector);
+#endif
+}
+
+/*  Operations  */
+
+Handle StopMachine::Run(StopMachineFunction const func, void * const cookie)
+{
+#if   defined(__BEELZEBUB_SETTINGS_SMP)
+    size_t const others = CpuDataSetUp ? Cpu::Count.Load() - 1 : 0;
+    //  Until the CPU data is set up, the other CPUs are not running.
+
+    if (others == 0)
+    {
+        withInterrupts (false)
+            func(cookie);
+
+        return HandleResult::Okay;
+    }
+
+    withInterrupts (false)
+    withLock (RunLock)
+    {
+        //  No interrupt handler may run here, as it could await a lock held by
+        //  a stopped CPU.
+
+        Arrived.Store(0);
+        Departed.Store(0);
+        Released.Store(false);
+        Stopping.Store(true, MemoryOrder::Release);
+
+        Lapic::SendIpi(LapicIcr(0)
+        .SetDeliveryMode(InterruptDeliveryModes::NMI)
+        .SetDestinationShorthand(IcrDestinationShorthand::AllExcludingSelf)
+        .SetAssert(true));
+        //  The vector is ignored for NMIs.
+
+        while (Arrived.Load() < others)
+            CpuInstructions::DoNothing();
+
+        func(cookie);
+
+        Released.Store(true, MemoryOrder::Release);
+
+        while (Departed.Load() < others)
+            CpuInstructions::DoNothing();
+        //  The counters cannot be reset while other CPUs still use them.
+
+        Stopping.Store(false, MemoryOrder::Release);
+    }
+#else
+    withInterrupts (false)
+        func(cookie);
+#endif
+
+    return HandleResult::Okay;
+}
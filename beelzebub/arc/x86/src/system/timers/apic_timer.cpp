@@ -0,0 +1,205 @@
+/*
+    Copyright (c) 2015 Alexandru-Mihai Maftei. All rights reserved.
+
+
+    Developed by: Alexandru-Mihai Maftei
+    aka Vercas
+    http://vercas.com | https://github.com/vercas/Beelzebub
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal with the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+      * Redistributions of source code must retain the above copyright notice,
+        this list of conditions and the following disclaimers.
+      * Redistributions in binary form must reproduce the above copyright
+        notice, this list of conditions and the following disclaimers in the
+        documentation and/or other materials provided with the distribution.
+      * Neither the names of Alexandru-Mihai Maftei, Vercas, nor the names of
+        its contributors may be used to endorse or promote products derived from
+        this Software without specific prior written permission.
+
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+    WITH THE SOFTWARE.
+
+    ---
+
+    You may also find the text of this license in "LICENSE.md", along with a more
+    thorough explanation regarding other files.
+*/
+
+#include <system/timers/apic_timer.hpp>
+#include <system/timers/timer_wheel.hpp>
+#include <system/interrupt_controllers/lapic.hpp>
+#include <system/cpu.hpp>
+#include <system/msrs.hpp>
+#include <execution/scheduler.hpp>
+#include <execution/soft_irq.hpp>
+#include <synchronization/rcu.hpp>
+#include <kernel.hpp>
+#include <entry.h>
+
+#include <debug.hpp>
+
+static constexpr uint64_t const CalibrationLength = 10000000;
+//  In nanoseconds.
+
+using namespace Beelzebub;
+using namespace Beelzebub::Execution;
+using namespace Beelzebub::Synchronization;
+using namespace Beelzebub::System;
+using namespace Beelzebub::System::InterruptControllers;
+using namespace Beelzebub::System::Timers;
+
+/**********************
+    ApicTimer class
+**********************/
+
+/*  Statics  */
+
+uint64_t ApicTimer::Frequency = 0;
+bool ApicTimer::TscDeadlineMode = false;
+
+uint64_t ApicTimer::TscToTimer = 0;
+
+/*  Interrupt Handler  */
+
+void ApicTimer::Handler(INTERRUPT_HANDLER_ARGS_FULL)
+{
+    Tick(state);
+
+    Lapic::EndOfInterrupt();
+}
+
+/*  Initialization  */
+
+Handle ApicTimer::Calibrate()
+{
+    TscDeadlineMode = Tsc::Invariant && BootstrapCpuid.CheckFeature(CpuFeature::TscDeadline);
+    //  Deadlines would drift with the rate of a TSC which is not invariant.
+
+    Lapic::WriteRegister(LapicRegister::TimerDivisor, (uint32_t)LapicTimerDivisor::By16);
+    Lapic::SetLvtTimer(LapicLvtTimer(0).SetVector(Vector).SetMasked(true));
+
+    uint64_t const length = Tsc::FromNanoseconds(CalibrationLength);
+    uint64_t duration;
+    uint32_t counted;
+
+    withInterrupts (false)
+    {
+        Lapic::WriteRegister(LapicRegister::TimerInitialCount, 0xFFFFFFFFU);
+
+        uint64_t const start = CpuInstructions::Rdtsc();
+
+        do duration = CpuInstructions::Rdtsc() - start;
+        while (duration < length);
+
+        counted = 0xFFFFFFFFU - Lapic::ReadRegister(LapicRegister::TimerCurrentCount);
+    }
+
+    Lapic::WriteRegister(LapicRegister::TimerInitialCount, 0);
+
+    if (length == 0 || counted == 0)
+        return HandleResult::UnsupportedOperation;
+
+    Frequency = (uint64_t)counted * Tsc::Frequency / duration;
+
+    TscToTimer = (Frequency << 32) / Tsc::Frequency;
+
+    return HandleResult::Okay;
+}
+
+void ApicTimer::InitializeCpu()
+{
+    Cpu::GetData()->TimerDeadline = 0;
+
+    Lapic::WriteRegister(LapicRegister::TimerDivisor, (uint32_t)LapicTimerDivisor::By16);
+    Lapic::SetLvtTimer(LapicLvtTimer(0).SetVector(Vector)
+        .SetMode(TscDeadlineMode ? LapicTimerMode::TscDeadline : LapicTimerMode::OneShot));
+
+    if (TscDeadlineMode)
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    //  The write to the LVT must not be reordered after the first write of
+    //  the deadline MSR, which would be ignored.
+}
+
+/*  Events  */
+
+void ApicTimer::Tick(IsrState * const state)
+{
+    CpuData * const data = Cpu::GetData();
+
+    data->TimerDeadline = 0;
+    ++data->TimerTicks;
+
+    Rcu::ReportQuiescentState();
+    //  Read-side critical sections cannot be interrupted.
+
+    if unlikely(Rcu::HasCallbacks())
+        SoftIrq::Raise(SoftIrqVector::Rcu);
+    //  They are invoked on the way out of the interrupt.
+
+    TimerWheel::Tick();
+    //  Wakes up the timer thread, which may preempt the current one below.
+
+    if (Scheduling)
+        Scheduler::Tick(state);
+    //  This re-arms the timer if the CPU is busy.
+}
+
+void ApicTimer::Arm(uint64_t const deadline)
+{
+    if unlikely(Frequency == 0)
+        return;
+    //  Something else ticks periodically instead.
+
+    CpuData * const data = Cpu::GetData();
+
+    if (data->TimerDeadline != 0 && data->TimerDeadline <= deadline)
+        return;
+    //  The pending event comes first; its handler lets everyone ask again.
+
+    data->TimerDeadline = deadline;
+
+    if (TscDeadlineMode)
+    {
+        Msrs::Write(Msr::IA32_TSC_DEADLINE, deadline);
+
+        return;
+    }
+
+    uint64_t const now = CpuInstructions::Rdtsc();
+    uint64_t delta = deadline > now ? deadline - now : 0;
+
+    if (delta > 0xFFFFFFFFU)
+        delta = 0xFFFFFFFFU;
+    //  Very far deadlines get an early event.
+
+    uint64_t const count = (delta * TscToTimer) >> 32;
+
+    Lapic::WriteRegister(LapicRegister::TimerInitialCount
+        , count == 0 ? 1 : (uint32_t)count);
+    //  A count of zero would stop the timer instead.
+}
+
+void ApicTimer::Disarm()
+{
+    if unlikely(Frequency == 0)
+        return;
+
+    Cpu::GetData()->TimerDeadline = 0;
+
+    if (TscDeadlineMode)
+        Msrs::Write(Msr::IA32_TSC_DEADLINE, (uint64_t)0);
+    else
+        Lapic::WriteRegister(LapicRegister::TimerInitialCount, 0);
+}
@@ -0,0 +1,260 @@
+/*
+    Copyright (c) 2015 Alexandru-Mihai Maftei. All rights reserved.
+
+
+    Developed by: Alexandru-Mihai Maftei
+    aka Vercas
+    http://vercas.com | https://github.com/vercas/Beelzebub
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal with the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+      * Redistributions of source code must retain the above copyright notice,
+        this list of conditions and the following disclaimers.
+      * Redistributions in binary form must reproduce the above copyright
+        notice, this list of conditions and the following disclaimers in the
+        documentation and/or other materials provided with the distribution.
+      * Neither the names of Alexandru-Mihai Maftei, Vercas, nor the names of
+        its contributors may be used to endorse or promote products derived from
+        this Software without specific prior written permission.
+
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+    WITH THE SOFTWARE.
+
+    ---
+
+    You may also find the text of this license in "LICENSE.md", along with a more
+    thorough explanation regarding other files.
+*/
+
+#include <system/timers/hpet.hpp>
+#include <system/timers/apic_timer.hpp>
+#include <system/interrupt_controllers/pic.hpp>
+#include <system/interrupt_controllers/lapic.hpp>
+#include <system/acpi.hpp>
+#include <system/cpu.hpp>
+#include <memory/vmm.hpp>
+#include <kernel.hpp>
+
+#include <debug.hpp>
+
+static constexpr size_t const CapabilitiesRegister  = 0x000;
+static constexpr size_t const ConfigurationRegister = 0x010;
+static constexpr size_t const StatusRegister        = 0x020;
+
+static constexpr size_t TimerConfigurationRegister(size_t const n) { return 0x100 + 0x20 * n; }
+static constexpr size_t TimerComparatorRegister(size_t const n) { return 0x108 + 0x20 * n; }
+
+static constexpr uint64_t const EnableCounter       = 1 << 0;
+static constexpr uint64_t const EnableLegacyRoutes  = 1 << 1;
+
+static constexpr uint64_t const TimerLevelTriggered = 1 << 1;
+static constexpr uint64_t const TimerEnabled        = 1 << 2;
+static constexpr uint64_t const TimerPeriodic       = 1 << 3;
+static constexpr uint64_t const TimerForce32Bit     = 1 << 8;
+static constexpr uint64_t const TimerRouteMask      = 0x1F << 9;
+static constexpr uint64_t const TimerUsesFsb        = 1 << 14;
+
+using namespace Beelzebub;
+using namespace Beelzebub::Memory;
+using namespace Beelzebub::System;
+using namespace Beelzebub::System::InterruptControllers;
+using namespace Beelzebub::System::Timers;
+
+static __forceinline uint64_t ReadRegister(size_t const offset)
+{
+#if   defined(__BEELZEBUB__ARCH_AMD64)
+    return *((uint64_t volatile *)(Hpet::Address + offset));
+#else
+    uint32_t volatile * const reg = (uint32_t volatile *)(Hpet::Address + offset);
+
+    return ((uint64_t)reg[1] << 32) | reg[0];
+#endif
+}
+
+static __forceinline void WriteRegister(size_t const offset, uint64_t const value)
+{
+#if   defined(__BEELZEBUB__ARCH_AMD64)
+    *((uint64_t volatile *)(Hpet::Address + offset)) = value;
+#else
+    uint32_t volatile * const reg = (uint32_t volatile *)(Hpet::Address + offset);
+
+    reg[0] = (uint32_t)value;
+    reg[1] = (uint32_t)(value >> 32);
+#endif
+}
+
+/*****************
+    Hpet class
+*****************/
+
+/*  Statics  */
+
+vaddr_t Hpet::Address = nullvaddr;
+
+uint64_t Hpet::Frequency = 0;
+uint32_t Hpet::Period = 0;
+uint64_t Hpet::CounterMask = 0;
+
+size_t Hpet::ComparatorCount = 0;
+bool Hpet::LegacyReplacement = false;
+
+uint8_t Hpet::Irq = 0xFF;
+
+uint64_t Hpet::TickLength = 0;
+uint64_t Hpet::NextTick = 0;
+
+/*  Interrupt Handler  */
+
+void Hpet::IrqHandler(INTERRUPT_HANDLER_ARGS_FULL)
+{
+    uint64_t const now = GetCounter();
+    uint64_t next = (NextTick + TickLength) & CounterMask;
+
+    if (((next - now) & CounterMask) > TickLength)
+        next = (now + TickLength) & CounterMask;
+    //  Ticks which were missed are not made up for.
+
+    WriteRegister(TimerComparatorRegister(0), next);
+    NextTick = next;
+
+#if   defined(__BEELZEBUB_SETTINGS_SMP)
+    if (Cpu::Count.Load() > 1)
+        Lapic::SendIpi(LapicIcr(0)
+        .SetDeliveryMode(InterruptDeliveryModes::Fixed)
+        .SetDestinationShorthand(IcrDestinationShorthand::AllExcludingSelf)
+        .SetAssert(true)
+        .SetVector(ApicTimer::Vector));
+    //  The other CPUs handle it like their own timer.
+#endif
+
+    ApicTimer::Tick(state);
+
+    END_OF_INTERRUPT();
+}
+
+/*  Initialization  */
+
+Handle Hpet::Initialize()
+{
+    paddr_t paddr = nullpaddr;
+    Handle res = Acpi::FindHpetPaddr(paddr);
+
+    if (!res.IsOkayResult())
+        return res;
+
+    vaddr_t const vaddr = Vmm::KernelHeapCursor.FetchAdd(PageSize);
+
+    res = Vmm::MapPage(&BootstrapProcess, vaddr, RoundDown(paddr, PageSize)
+        , MemoryFlags::Global | MemoryFlags::Writable, PageDescriptor::Invalid);
+
+    assert_or(res.IsOkayResult()
+        , "Failed to map page at %Xp (%XP) for HPET: %H%n"
+        , vaddr, paddr, res)
+    {
+        return res;
+    }
+
+    Address = vaddr + (paddr & (PageSize - 1));
+
+    uint64_t const caps = ReadRegister(CapabilitiesRegister);
+
+    Period = (uint32_t)(caps >> 32);
+
+    if (Period == 0 || Period > 100000000)
+    {
+        Address = nullvaddr;
+
+        return HandleResult::IntegrityFailure;
+    }
+    //  The specification caps the period at 100 nanoseconds.
+
+    Frequency = 1000000000000000ULL / Period;
+    CounterMask = 0 != (caps & (1 << 13)) ? UINT64_MAX : 0xFFFFFFFFULL;
+    ComparatorCount = (size_t)((caps >> 8) & 0x1F) + 1;
+    LegacyReplacement = 0 != (caps & (1 << 15));
+
+    uint64_t const config = ReadRegister(ConfigurationRegister);
+
+    for (size_t i = 0; i < ComparatorCount; ++i)
+        WriteRegister(TimerConfigurationRegister(i)
+            , ReadRegister(TimerConfigurationRegister(i)) & ~TimerEnabled);
+    //  Whatever the firmware left running stays quiet.
+
+    WriteRegister(ConfigurationRegister, (config & ~EnableLegacyRoutes) | EnableCounter);
+
+    return HandleResult::Okay;
+}
+
+Handle Hpet::StartTicking(uint64_t const period)
+{
+    if (!IsAvailable())
+        return HandleResult::UnsupportedOperation;
+
+    uint64_t timer = ReadRegister(TimerConfigurationRegister(0));
+    uint8_t irq = 0xFF;
+
+    if (LegacyReplacement)
+        irq = 0;
+    //  The first comparator replaces the PIT.
+    else
+    {
+        uint32_t const routes = (uint32_t)(timer >> 32);
+
+        for (uint8_t i = 1; i < 16; ++i)
+            if (i != 2 && 0 != (routes & (1U << i)) && !Pic::IsSubscribed(i))
+            {
+                irq = i;
+
+                break;
+            }
+
+        if (irq == 0xFF)
+            return HandleResult::UnsupportedOperation;
+        //  Only the IRQs of the PIC can be used.
+
+        timer = (timer & ~TimerRouteMask) | ((uint64_t)irq << 9);
+    }
+
+    TickLength = period * Frequency / 1000000000ULL;
+
+    if (TickLength == 0)
+        TickLength = 1;
+
+    timer &= ~(TimerLevelTriggered | TimerPeriodic | TimerUsesFsb);
+    //  Edge-triggered and one-shot, so every tick sets the next one.
+
+    if (CounterMask != UINT64_MAX)
+        timer |= TimerForce32Bit;
+
+    withInterrupts (false)
+    {
+        Pic::Subscribe(irq, &IrqHandler, false);
+
+        WriteRegister(TimerConfigurationRegister(0), timer | TimerEnabled);
+        WriteRegister(StatusRegister, 1);
+
+        if (LegacyReplacement)
+            WriteRegister(ConfigurationRegister
+                , ReadRegister(ConfigurationRegister) | EnableLegacyRoutes);
+
+        NextTick = (GetCounter() + TickLength) & CounterMask;
+        WriteRegister(TimerComparatorRegister(0), NextTick);
+
+        Irq = irq;
+
+        Pic::SetMasked(irq, false);
+    }
+
+    return HandleResult::Okay;
+}
@@ -39,13 +39,10 @@
 
 #include <system/timers/pit.hpp>
 #include <system/io_ports.hpp>
-#include <system/cpu.hpp>   //  Only used for task switching right now...
-#include <kernel.hpp>
 #include <debug.hpp>
 #include <_print/isr.hpp>
 
 using namespace Beelzebub;
-using namespace Beelzebub::Execution;
 using namespace Beelzebub::Synchronization;
 using namespace Beelzebub::System;
 using namespace Beelzebub::System::Timers;
@@ -63,33 +60,8 @@ Atomic<size_t> Pit::Counter {0};
 void Pit::IrqHandler(INTERRUPT_HANDLER_ARGS_FULL)
 {
     ++Counter;
-
-    if (CpuDataSetUp && Scheduling)
-    {
-        Thread * const activeThread = Cpu::GetThread();
-
-        if (activeThread != nullptr && activeThread->Next != activeThread)
-        {
-            activeThread->State = *state;
-
-            // if (activeThread == &BootstrapThread)
-            //     msg("(( RIP = %Xp ))", state->RIP);
-
-            // msg("PRE-SWITCH ");
-            // PrintToDebugTerminal(state);
-            // msg("%n");
-
-            // msg("(( AT=%Xp; N=%Xp; P=%Xp; BST=%B ))%n"
-            //     , activeThread, activeThread->Next, activeThread->Previous
-            //     , activeThread == &BootstrapThread);
-
-            activeThread->SwitchToNext(state);
-
-            // msg("%nPOST-SWITCH ");
-            // PrintToDebugTerminal(state);
-            // msg("%n");
-        }
-    }
+    //  Only counts during early initialization; the LAPIC timers take over
+    //  afterwards, and this IRQ is masked.
 
     END_OF_INTERRUPT();
 }
@@ -112,3 +84,28 @@ void Pit::SendCommand(PitCommand const cmd)
 {
     Io::Out8(0x43, cmd.Value);
 }
+
+/*  Countdown  */
+
+void Pit::StartCountdown(uint16_t const count)
+{
+    Io::Out8(0x61, (uint8_t)((Io::In8(0x61) & ~0x02) | 0x01));
+    //  Raises the gate of channel 2 and keeps the speaker quiet.
+
+    PitCommand cmd {};
+    cmd.SetChannel(PitChannel::Channel2);
+    cmd.SetAccessMode(PitAccessMode::LowHigh);
+    cmd.SetOperatingMode(PitOperatingMode::InterruptOnTerminalCount);
+
+    SendCommand(cmd);
+
+    Io::Out8(0x42, (uint8_t)(count     ));  //  Low byte
+    Io::Out8(0x42, (uint8_t)(count >> 8));  //  High byte
+    //  Counting starts after the high byte is written.
+}
+
+bool Pit::IsCountdownOver()
+{
+    return 0 != (Io::In8(0x61) & 0x20);
+    //  This bit mirrors the output of channel 2, which goes up at zero.
+}
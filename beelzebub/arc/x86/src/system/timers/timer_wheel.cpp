@@ -0,0 +1,526 @@
+/*
+    Copyright (c) 2015 Alexandru-Mihai Maftei. All rights reserved.
+
+
+    Developed by: Alexandru-Mihai Maftei
+    aka Vercas
+    http://vercas.com | https://github.com/vercas/Beelzebub
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal with the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+      * Redistributions of source code must retain the above copyright notice,
+        this list of conditions and the following disclaimers.
+      * Redistributions in binary form must reproduce the above copyright
+        notice, this list of conditions and the following disclaimers in the
+        documentation and/or other materials provided with the distribution.
+      * Neither the names of Alexandru-Mihai Maftei, Vercas, nor the names of
+        its contributors may be used to endorse or promote products derived from
+        this Software without specific prior written permission.
+
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+    WITH THE SOFTWARE.
+
+    ---
+
+    You may also find the text of this license in "LICENSE.md", along with a more
+    thorough explanation regarding other files.
+*/
+
+#include <system/timers/timer_wheel.hpp>
+#include <system/timers/apic_timer.hpp>
+#include <system/timers/tsc.hpp>
+#include <execution/thread_init.hpp>
+#include <execution/scheduler.hpp>
+#include <execution/yield.hpp>
+#include <memory/vmm.hpp>
+#include <system/cpu.hpp>
+#include <kernel.hpp>
+
+#include <debug.hpp>
+
+using namespace Beelzebub;
+using namespace Beelzebub::Execution;
+using namespace Beelzebub::Memory;
+using namespace Beelzebub::Synchronization;
+using namespace Beelzebub::System;
+using namespace Beelzebub::System::Timers;
+
+static __forceinline TimerWheel * GetLocalWheel()
+{
+    return &(Cpu::GetData()->Timers);
+}
+
+/**
+ *  Obtains the first tick of the wheel which starts no earlier than the given
+ *  monotonic time.
+ */
+static __forceinline uint64_t ToTicks(uint64_t const nanoseconds)
+{
+    return (nanoseconds + ((uint64_t)1 << TimerWheel::ResolutionShift) - 1)
+        >> TimerWheel::ResolutionShift;
+}
+
+/******************
+    Timer class
+******************/
+
+/*  Operations  */
+
+void Timer::Start(uint64_t const delay, uint64_t const period)
+{
+    this->Cancel();
+
+    withInterrupts (false)
+    {
+        TimerWheel * const wheel = GetLocalWheel();
+        uint64_t expiry;
+
+        withLock (wheel->Lock)
+        {
+            uint64_t const now = Tsc::GetMonotonicNanoseconds();
+
+            if (wheel->Count == 0)
+                wheel->Current = now >> TimerWheel::ResolutionShift;
+            //  An empty wheel is not advanced by interrupts.
+
+            this->Wheel = wheel;
+            this->Expiry = ToTicks(now + delay);
+            this->Period = period;
+
+            wheel->Insert(this);
+
+            expiry = wheel->GetNextExpiry();
+        }
+
+        ApicTimer::Arm(Tsc::GetTimestamp(expiry << TimerWheel::ResolutionShift));
+    }
+}
+
+bool Timer::Cancel()
+{
+    bool pending = false;
+
+    withInterrupts (false)
+        while (true)
+        {
+            TimerWheel * const wheel = this->Wheel;
+
+            if (wheel == nullptr)
+                break;
+
+            wheel->Lock.Acquire();
+
+            if (this->Wheel != wheel)
+            {
+                wheel->Lock.Release();
+
+                continue;
+            }
+            //  It was migrated in the meantime.
+
+            if (this->List != nullptr)
+            {
+                wheel->Remove(this);
+
+                pending = true;
+            }
+
+            this->Period = 0;
+            //  Also stops a running periodic timer from coming back.
+
+            wheel->Lock.Release();
+
+            break;
+        }
+
+    Thread * const self = Cpu::GetThread();
+
+    while (this->RunningOn != nullptr && this->RunningOn != self)
+        if (Scheduler::IsActive())
+            Yield::Now();
+        else
+            CpuInstructions::DoNothing();
+    //  The function may be using the timer, which the caller may be about to
+    //  free. A function cancelling its own timer does not wait for itself.
+
+    return pending;
+}
+
+/***********************
+    TimerWheel class
+***********************/
+
+/*  Initialization  */
+
+void TimerWheel::InitializeCpu(Thread * const worker)
+{
+    new (worker) Thread(&BootstrapProcess);
+
+    uintptr_t stackVaddr = nullvaddr;
+
+    Handle res = Vmm::AllocatePages(&BootstrapProcess
+        , WorkerStackPages
+        , MemoryAllocationOptions::Commit | MemoryAllocationOptions::VirtualKernelHeap
+        , MemoryFlags::Global | MemoryFlags::Writable
+        , MemoryContent::ThreadStack
+        , stackVaddr);
+
+    ASSERT(res.IsOkayResult()
+        , "Failed to allocate stack for timer thread: %H."
+        , res);
+
+    worker->KernelStackTop = stackVaddr + WorkerStackPages * PageSize;
+    worker->KernelStackBottom = stackVaddr;
+
+    worker->EntryPoint = &WorkerEntryPoint;
+
+    InitializeThreadState(worker);
+
+    worker->Priority = ThreadPriority::RealTime;
+    worker->Pinned = true;
+
+    TimerWheel * const wheel = GetLocalWheel();
+
+    withInterrupts (false)
+    {
+        withLock (wheel->Lock)
+        {
+            wheel->Current = Tsc::GetMonotonicNanoseconds() >> ResolutionShift;
+            wheel->Worker = worker;
+        }
+    }
+
+    res = Scheduler::Enqueue(worker);
+
+    ASSERT(res.IsOkayResult()
+        , "Failed to enqueue timer thread: %H."
+        , res);
+}
+
+/*  Events  */
+
+void TimerWheel::Tick()
+{
+    TimerWheel * const wheel = GetLocalWheel();
+
+    if (wheel->Count == 0)
+        return;
+
+    uint64_t expiry;
+    bool expired;
+
+    withLock (wheel->Lock)
+    {
+        wheel->Advance(Tsc::GetMonotonicNanoseconds() >> ResolutionShift);
+
+        expiry = wheel->GetNextExpiry();
+        expired = wheel->Expired != nullptr && wheel->Worker != nullptr;
+    }
+
+    if (expired)
+        Scheduler::Wake(wheel->Worker);
+    //  The timer thread takes precedence over everything else.
+
+    if (expiry != 0)
+        ApicTimer::Arm(Tsc::GetTimestamp(expiry << ResolutionShift));
+}
+
+void TimerWheel::Rearm()
+{
+    TimerWheel * const wheel = GetLocalWheel();
+
+    if (wheel->Count == 0)
+        return;
+
+    uint64_t expiry;
+
+    withLock (wheel->Lock)
+        expiry = wheel->GetNextExpiry();
+
+    if (expiry != 0)
+        ApicTimer::Arm(Tsc::GetTimestamp(expiry << ResolutionShift));
+}
+
+void TimerWheel::Migrate(TimerWheel * const target)
+{
+    TimerWheel * const wheel = GetLocalWheel();
+
+    if (wheel->Count == 0 || target == wheel)
+        return;
+
+    TimerWheel * const first = wheel < target ? wheel : target;
+    TimerWheel * const second = wheel < target ? target : wheel;
+    //  Both locks are always taken in the same order.
+
+    first->Lock.Acquire();
+    second->Lock.Acquire();
+
+    if (target->Count == 0)
+        target->Current = wheel->Current;
+
+    for (size_t level = 0; level < LevelCount; ++level)
+        for (size_t index = 0; index < SlotCount; ++index)
+        {
+            Timer * timer = wheel->Slots[level][index];
+
+            while (timer != nullptr)
+            {
+                Timer * const next = timer->Next;
+
+                if (!timer->Pinned)
+                {
+                    wheel->Remove(timer);
+
+                    timer->Wheel = target;
+                    target->Insert(timer);
+                }
+
+                timer = next;
+            }
+        }
+
+    second->Lock.Release();
+    first->Lock.Release();
+}
+
+/*  Slots  */
+
+void TimerWheel::Insert(Timer * const timer)
+{
+    uint64_t const expiry = timer->Expiry < this->Current ? this->Current : timer->Expiry;
+    uint64_t const delta = expiry - this->Current;
+
+    size_t level = 0;
+
+    while (level < LevelCount - 1 && delta >= ((uint64_t)1 << ((level + 1) * LevelBits)))
+        ++level;
+
+    uint64_t slot = expiry;
+
+    if (delta >= ((uint64_t)1 << (LevelCount * LevelBits)))
+        slot = this->Current + ((uint64_t)1 << (LevelCount * LevelBits)) - 1;
+    //  Too far away; it will be cascaded down and placed again until it fits.
+
+    size_t const index = (size_t)(slot >> (level * LevelBits)) & (SlotCount - 1);
+    Timer * * const list = &(this->Slots[level][index]);
+
+    timer->Previous = nullptr;
+    timer->Next = *list;
+
+    if (*list != nullptr)
+        (*list)->Previous = timer;
+
+    *list = timer;
+    timer->List = list;
+
+    this->Occupied[level] |= (uint64_t)1 << index;
+    ++this->Count;
+}
+
+void TimerWheel::Remove(Timer * const timer)
+{
+    Timer * * const list = timer->List;
+
+    if (timer->Previous != nullptr)
+        timer->Previous->Next = timer->Next;
+    else
+        *list = timer->Next;
+
+    if (timer->Next != nullptr)
+        timer->Next->Previous = timer->Previous;
+
+    timer->Next = timer->Previous = nullptr;
+    timer->List = nullptr;
+
+    if (list == &(this->Expired))
+        return;
+
+    --this->Count;
+
+    if (*list == nullptr)
+    {
+        size_t const position = (size_t)(list - &(this->Slots[0][0]));
+
+        this->Occupied[position / SlotCount] &= ~((uint64_t)1 << (position % SlotCount));
+    }
+}
+
+void TimerWheel::Cascade(size_t const level, size_t const index)
+{
+    Timer * timer = this->Slots[level][index];
+
+    this->Slots[level][index] = nullptr;
+    this->Occupied[level] &= ~((uint64_t)1 << index);
+
+    while (timer != nullptr)
+    {
+        Timer * const next = timer->Next;
+
+        --this->Count;
+        this->Insert(timer);
+        //  Lands on a lower level, or here again if it is very far away.
+
+        timer = next;
+    }
+}
+
+void TimerWheel::Advance(uint64_t const now)
+{
+    while (this->Current <= now)
+    {
+        if (this->Count == 0)
+        {
+            this->Current = now + 1;
+
+            break;
+        }
+
+        size_t const index = (size_t)this->Current & (SlotCount - 1);
+
+        if (index == 0)
+            for (size_t level = 1; level < LevelCount; ++level)
+            {
+                size_t const upper = (size_t)(this->Current >> (level * LevelBits)) & (SlotCount - 1);
+
+                this->Cascade(level, upper);
+
+                if (upper != 0)
+                    break;
+            }
+        //  The lower level wrapped around, so the next slot of the upper one
+        //  is spread over it.
+
+        if ((this->Occupied[0] >> index) == 0)
+        {
+            uint64_t const turn = (this->Current | (SlotCount - 1)) + 1;
+
+            this->Current = turn <= now ? turn : now + 1;
+
+            continue;
+        }
+        //  Nothing else expires before the next turn.
+
+        Timer * timer = this->Slots[0][index];
+
+        this->Slots[0][index] = nullptr;
+        this->Occupied[0] &= ~((uint64_t)1 << index);
+
+        while (timer != nullptr)
+        {
+            Timer * const next = timer->Next;
+
+            --this->Count;
+            this->PushExpired(timer);
+
+            timer = next;
+        }
+
+        ++this->Current;
+    }
+}
+
+uint64_t TimerWheel::GetNextExpiry() const
+{
+    if (this->Count == 0)
+        return 0;
+
+    size_t const index = (size_t)this->Current & (SlotCount - 1);
+    uint64_t const ahead = this->Occupied[0] >> index;
+
+    if (ahead != 0)
+        return this->Current + (uint64_t)__builtin_ctzll(ahead);
+
+    return (this->Current | (SlotCount - 1)) + 1;
+    //  Upper levels are only looked at when the lowest one wraps around.
+}
+
+void TimerWheel::PushExpired(Timer * const timer)
+{
+    timer->Previous = nullptr;
+    timer->Next = this->Expired;
+
+    if (this->Expired != nullptr)
+        this->Expired->Previous = timer;
+
+    this->Expired = timer;
+    timer->List = &(this->Expired);
+}
+
+Timer * TimerWheel::PopExpired()
+{
+    Timer * const timer = this->Expired;
+
+    if (timer != nullptr)
+        this->Remove(timer);
+
+    return timer;
+}
+
+/*  Timer Thread  */
+
+void * TimerWheel::WorkerEntryPoint(void * const)
+{
+    Thread * const self = Cpu::GetThread();
+    TimerWheel * const wheel = GetLocalWheel();
+    //  The thread is pinned, so this is always its wheel.
+
+    while (true)
+    {
+        Timer * timer;
+
+        withInterrupts (false)
+        {
+            withLock (wheel->Lock)
+            {
+                timer = wheel->PopExpired();
+
+                if (timer != nullptr)
+                    timer->RunningOn = self;
+                else
+                    self->Blocked = true;
+            }
+        }
+
+        if (timer == nullptr)
+        {
+            Scheduler::Block();
+
+            continue;
+        }
+        //  The interrupt handler wakes this thread when timers expire.
+
+        timer->Function(timer);
+
+        withInterrupts (false)
+        {
+            TimerWheel * const owner = timer->Wheel;
+            //  Cannot be changed while running, because migration only
+            //  touches pending timers.
+
+            withLock (owner->Lock)
+            {
+                if (timer->Period != 0 && timer->List == nullptr)
+                {
+                    timer->Expiry += ToTicks(timer->Period);
+                    owner->Insert(timer);
+                }
+                //  Periodic timers keep their phase, unless restarted.
+
+                timer->RunningOn = nullptr;
+            }
+        }
+    }
+
+    return nullptr;
+}
@@ -0,0 +1,294 @@
+/*
+    Copyright (c) 2015 Alexandru-Mihai Maftei. All rights reserved.
+
+
+    Developed by: Alexandru-Mihai Maftei
+    aka Vercas
+    http://vercas.com | https://github.com/vercas/Beelzebub
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal with the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+      * Redistributions of source code must retain the above copyright notice,
+        this list of conditions and the following disclaimers.
+      * Redistributions in binary form must reproduce the above copyright
+        notice, this list of conditions and the following disclaimers in the
+        documentation and/or other materials provided with the distribution.
+      * Neither the names of Alexandru-Mihai Maftei, Vercas, nor the names of
+        its contributors may be used to endorse or promote products derived from
+        this Software without specific prior written permission.
+
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+    WITH THE SOFTWARE.
+
+    ---
+
+    You may also find the text of this license in "LICENSE.md", along with a more
+    thorough explanation regarding other files.
+*/
+
+#include <system/timers/tsc.hpp>
+#include <system/timers/pit.hpp>
+#include <system/timers/hpet.hpp>
+#include <system/alternatives.hpp>
+#include <system/interrupts.hpp>
+#include <synchronization/spinlock.hpp>
+#include <entry.h>
+
+#include <debug.hpp>
+
+static constexpr size_t const CalibrationRuns = 3;
+static constexpr uint16_t const CalibrationCount = 11932;
+//  About 10 milliseconds worth of PIT periods.
+
+static constexpr uint64_t const HpetCalibrationLength = 2000000;
+//  In nanoseconds. Reading the HPET is precise, so this can be shorter.
+static constexpr size_t const HpetSamples = 8;
+
+static constexpr size_t const WarpIterations = 10000;
+
+using namespace Beelzebub;
+using namespace Beelzebub::Synchronization;
+using namespace Beelzebub::System;
+using namespace Beelzebub::System::Timers;
+
+/**
+ *  Finds the most precise multiplier and shift which convert values at the
+ *  `from` rate into the `to` rate, with a multiplier of 32 bits.
+ */
+static void ComputeScale(uint64_t const from, uint64_t const to
+    , uint64_t & mul, uint32_t & shift)
+{
+    for (shift = 32; shift > 0; --shift)
+    {
+        if (to > (UINT64_MAX >> shift))
+            continue;
+
+        mul = (to << shift) / from;
+
+        if (mul <= 0xFFFFFFFFU)
+            return;
+    }
+
+    mul = to / from;
+}
+
+/**
+ *  Reads the TSC after all prior instructions, so it is ordered with locks.
+ */
+static __forceinline uint64_t ReadOrdered()
+{
+    uint32_t low, high;
+
+    asm volatile ( ALTERNATIVE("lfence \n\t rdtsc", "rdtscp")
+                 : "=a"(low), "=d"(high)
+                 : ALTERNATIVE_FEATURE(RDTSCP)
+                 : "ecx", "memory" );
+    //  RDTSCP also waits for prior instructions, and writes the TSC_AUX MSR
+    //  into ECX.
+
+    return ((uint64_t)high << 32) | low;
+}
+
+/**
+ *  Reads the HPET main counter along with the TSC value at the middle of the
+ *  read, keeping the fastest of a few attempts.
+ */
+static uint64_t SampleHpet(uint64_t & tsc)
+{
+    uint64_t counter = 0, best = UINT64_MAX;
+
+    for (size_t i = 0; i < HpetSamples; ++i)
+    {
+        uint64_t const before = ReadOrdered();
+        uint64_t const value = Hpet::GetCounter();
+        uint64_t const after = ReadOrdered();
+
+        if (after - before < best)
+        {
+            best = after - before;
+            counter = value;
+            tsc = before + best / 2;
+        }
+    }
+
+    return counter;
+}
+
+/**
+ *  Measures the frequency of the TSC against the HPET.
+ */
+static uint64_t CalibrateAgainstHpet()
+{
+    uint64_t const length = HpetCalibrationLength * Hpet::Frequency / 1000000000ULL;
+    uint64_t startTsc = 0, endTsc = 0, elapsed;
+
+    withInterrupts (false)
+    {
+        uint64_t const start = SampleHpet(startTsc);
+
+        do elapsed = (Hpet::GetCounter() - start) & Hpet::CounterMask;
+        while (elapsed < length);
+
+        elapsed = (SampleHpet(endTsc) - start) & Hpet::CounterMask;
+    }
+
+    if (elapsed == 0)
+        return 0;
+
+    return (endTsc - startTsc) * Hpet::Frequency / elapsed;
+}
+
+/**
+ *  Measures the frequency of the TSC against the PIT.
+ */
+static uint64_t CalibrateAgainstPit()
+{
+    uint64_t best = UINT64_MAX;
+
+    withInterrupts (false)
+        for (size_t i = 0; i < CalibrationRuns; ++i)
+        {
+            Pit::StartCountdown(CalibrationCount);
+
+            uint64_t const start = CpuInstructions::Rdtsc();
+
+            while (!Pit::IsCountdownOver())
+                CpuInstructions::DoNothing();
+
+            uint64_t const duration = CpuInstructions::Rdtsc() - start;
+
+            if (duration < best)
+                best = duration;
+            //  Delays can only make a run longer, so the shortest is kept.
+        }
+
+    if (best == 0 || best == UINT64_MAX)
+        return 0;
+
+    return best * Pit::BaseFrequency / CalibrationCount;
+}
+
+/****************
+    Tsc class
+****************/
+
+/*  Statics  */
+
+uint64_t Tsc::Frequency = 0;
+
+bool Tsc::Invariant = false;
+bool Tsc::Synchronized = true;
+uint64_t Tsc::MaximumWarp = 0;
+
+bool Tsc::HpetClock = false;
+
+uint64_t Tsc::Origin = 0;
+uint64_t Tsc::HpetOrigin = 0, Tsc::HpetBase = 0;
+
+uint64_t Tsc::NanosecondMultiplier = 0, Tsc::TickMultiplier = 0;
+uint32_t Tsc::NanosecondShift = 0, Tsc::TickShift = 0;
+
+static Spinlock<> WarpLock;
+static uint64_t WarpLast;
+static uint32_t WarpArrivals, WarpDepartures;
+
+/*  Initialization  */
+
+Handle Tsc::Calibrate()
+{
+    Invariant = BootstrapCpuid.CheckFeature(CpuFeature::InvariantTsc);
+
+    Frequency = Hpet::IsAvailable() ? CalibrateAgainstHpet() : CalibrateAgainstPit();
+
+    if (Frequency == 0)
+        return HandleResult::UnsupportedOperation;
+
+    ComputeScale(Frequency, 1000000000, NanosecondMultiplier, NanosecondShift);
+    ComputeScale(1000000000, Frequency, TickMultiplier, TickShift);
+
+    Origin = CpuInstructions::Rdtsc();
+
+    WarpLock.Reset();
+    WarpArrivals = WarpDepartures = 0;
+
+    return HandleResult::Okay;
+}
+
+void Tsc::CheckWarp(bool const bsp)
+{
+    withInterrupts (false)
+    {
+        __atomic_add_fetch(&WarpArrivals, 1, __ATOMIC_SEQ_CST);
+
+        while (__atomic_load_n(&WarpArrivals, __ATOMIC_ACQUIRE) < 2)
+            CpuInstructions::DoNothing();
+        //  Both CPUs take turns reading their TSCs in the same period.
+
+        uint64_t warp = 0;
+
+        for (size_t i = 0; i < WarpIterations; ++i)
+        {
+            uint64_t prev = 0, now = 0;
+
+            withLock (WarpLock)
+            {
+                prev = WarpLast;
+                now = ReadOrdered();
+                WarpLast = now;
+            }
+
+            if (now < prev && prev - now > warp)
+                warp = prev - now;
+            //  The other CPU read a larger value before this one.
+        }
+
+        uint64_t seen = __atomic_load_n(&MaximumWarp, __ATOMIC_RELAXED);
+
+        while (warp > seen && !__atomic_compare_exchange_n(&MaximumWarp, &seen, warp
+            , true, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED))
+            ;   //  `seen` is refreshed by every failed exchange.
+
+        __atomic_add_fetch(&WarpDepartures, 1, __ATOMIC_SEQ_CST);
+
+        if (bsp)
+        {
+            while (__atomic_load_n(&WarpDepartures, __ATOMIC_ACQUIRE) < 2)
+                CpuInstructions::DoNothing();
+
+            if (MaximumWarp != 0)
+                Synchronized = false;
+
+            WarpLast = 0;
+            WarpArrivals = WarpDepartures = 0;
+            //  Ready for the next AP.
+        }
+    }
+}
+
+bool Tsc::SelectClock()
+{
+    if (IsReliable())
+        return false;
+
+    if (!Hpet::IsAvailable() || Hpet::CounterMask != UINT64_MAX)
+        return false;
+    //  A 32-bit main counter would wrap around within minutes.
+
+    HpetBase = GetMonotonicNanoseconds();
+    HpetOrigin = Hpet::GetCounter();
+
+    HpetClock = true;
+
+    return true;
+}
@@ -0,0 +1,345 @@
+/*
+    Copyright (c) 2015 Alexandru-Mihai Maftei. All rights reserved.
+
+
+    Developed by: Alexandru-Mihai Maftei
+    aka Vercas
+    http://vercas.com | https://github.com/vercas/Beelzebub
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal with the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+      * Redistributions of source code must retain the above copyright notice,
+        this list of conditions and the following disclaimers.
+      * Redistributions in binary form must reproduce the above copyright
+        notice, this list of conditions and the following disclaimers in the
+        documentation and/or other materials provided with the distribution.
+      * Neither the names of Alexandru-Mihai Maftei, Vercas, nor the names of
+        its contributors may be used to endorse or promote products derived from
+        this Software without specific prior written permission.
+
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+    WITH THE SOFTWARE.
+
+    ---
+
+    You may also find the text of this license in "LICENSE.md", along with a more
+    thorough explanation regarding other files.
+*/
+
+#include <system/topology.hpp>
+#include <system/cpuid.hpp>
+#include <system/cpu.hpp>
+#include <synchronization/spinlock.hpp>
+#include <entry.h>
+#include <math.h>
+
+#include <debug.hpp>
+
+using namespace Beelzebub;
+using namespace Beelzebub::Synchronization;
+using namespace Beelzebub::System;
+using namespace Beelzebub::Terminals;
+
+/*  Registry  */
+
+static CpuData * Cpus[CpuMask::Capacity];
+static Spinlock<> RegistryLock;
+
+/**
+ *  Obtains the number of bits needed to tell apart the given number of IDs.
+ */
+static __forceinline uint8_t GetShift(uint32_t const count)
+{
+    return count <= 1 ? 0 : (uint8_t)(32 - __builtin_clz(count - 1));
+}
+
+/**
+ *  Tells whether two CPUs have the same identifier at a level. The wider
+ *  shift of the two is used, so it is symmetric even on hybrid processors.
+ */
+static __forceinline bool Shares(CpuTopology const & a, CpuTopology const & b
+    , uint8_t const shiftA, uint8_t const shiftB)
+{
+    uint8_t const shift = Maximum(shiftA, shiftB);
+
+    return shift >= 32 || (a.ApicId >> shift) == (b.ApicId >> shift);
+}
+
+/*  Decoding  */
+
+/**
+ *  Reads leaf 0x1F or 0xB, which both describe the levels above the thread.
+ */
+static bool DecodeExtendedLeaf(uint32_t const leaf, CpuTopology & topo)
+{
+    uint32_t a, b, c, d;
+
+    CpuId::Execute(leaf, 0, a, b, c, d);
+
+    if (b == 0)
+        return false;
+    //  No logical processors at the first level means the leaf is unsupported.
+
+    topo.ApicId = d;
+
+    for (uint32_t sub = 0; sub < 8; ++sub)
+    {
+        CpuId::Execute(leaf, sub, a, b, c, d);
+
+        uint32_t const type = (c >> 8) & 0xFF;
+
+        if (type == 0)
+            break;
+
+        if (type == 1)
+            topo.SmtShift = (uint8_t)(a & 0x1F);
+
+        topo.PackageShift = (uint8_t)(a & 0x1F);
+        //  The last level gives the shift of the package ID.
+    }
+
+    return true;
+}
+
+/**
+ *  Uses the maximum counts of threads and cores per package, on Intel CPUs
+ *  without leaf 0xB.
+ */
+static void DecodeIntelLegacy(CpuTopology & topo, uint32_t const b, bool const htt)
+{
+    if (!htt)
+        return;
+
+    uint32_t const logical = (b >> 16) & 0xFF;
+    uint32_t cores = 1;
+
+    if (BootstrapCpuid.MaxStandardValue >= 0x4U)
+    {
+        uint32_t w, x, y, z;
+
+        CpuId::Execute(0x4U, 0U, w, x, y, z);
+
+        cores = (w >> 26) + 1;
+    }
+
+    topo.SmtShift = GetShift(logical > cores ? logical / cores : 1);
+    topo.PackageShift = GetShift(logical);
+}
+
+/**
+ *  Uses the core count and topology extensions of AMD CPUs.
+ */
+static void DecodeAmdLegacy(CpuTopology & topo, bool const topoExt)
+{
+    uint32_t a, b, c, d;
+
+    if (BootstrapCpuid.MaxExtendedValue >= 0x80000008U)
+    {
+        CpuId::Execute(0x80000008U, a, b, c, d);
+
+        uint32_t const size = (c >> 12) & 0xF;
+
+        topo.PackageShift = size != 0 ? (uint8_t)size : GetShift((c & 0xFF) + 1);
+    }
+
+    if (topoExt && BootstrapCpuid.MaxExtendedValue >= 0x8000001EU)
+    {
+        CpuId::Execute(0x8000001EU, a, b, c, d);
+
+        topo.SmtShift = GetShift(((b >> 8) & 0xFF) + 1);
+    }
+}
+
+/**
+ *  Reads the deterministic cache parameters, which leaf 0x4 of Intel and leaf
+ *  0x8000001D of AMD give in the same format.
+ */
+static void DecodeCaches(uint32_t const leaf, CpuTopology & topo)
+{
+    uint32_t lastLevel = 0;
+
+    for (uint32_t sub = 0; sub < 16; ++sub)
+    {
+        uint32_t a, b, c, d;
+
+        CpuId::Execute(leaf, sub, a, b, c, d);
+
+        uint32_t const type = a & 0x1F;
+
+        if (type == 0)
+            break;
+        //  No more caches.
+
+        if (type == 2)
+            continue;
+        //  Instruction caches say nothing of data sharing.
+
+        uint32_t const level = (a >> 5) & 0x7;
+        uint8_t const shift = GetShift(((a >> 14) & 0xFFF) + 1);
+
+        if (level == 2)
+            topo.L2Shift = shift;
+
+        if (level >= lastLevel)
+        {
+            lastLevel = level;
+            topo.LlcShift = shift;
+        }
+    }
+}
+
+/************************
+    CpuTopology struct
+************************/
+
+/*  Initialization  */
+
+void CpuTopology::InitializeCpu()
+{
+    CpuData * const data = Cpu::GetData();
+    CpuTopology & topo = data->Topology;
+
+    uint32_t a, b, c, d;
+
+    CpuId::Execute(0x1U, a, b, c, d);
+
+    topo.ApicId = b >> 24;
+    //  Replaced by the full x2APIC ID below, if available.
+
+    bool const htt = 0 != (d & (1U << 28));
+    bool const amd = BootstrapCpuid.Vendor == CpuVendor::Amd;
+    bool topoExt = false;
+
+    if (BootstrapCpuid.MaxExtendedValue >= 0x80000001U)
+    {
+        CpuId::Execute(0x80000001U, a, b, c, d);
+
+        topoExt = 0 != (c & (1U << 22));
+    }
+
+    uint32_t const maxStandard = BootstrapCpuid.MaxStandardValue;
+
+    if (!(maxStandard >= 0x1FU && DecodeExtendedLeaf(0x1FU, topo))
+        && !(maxStandard >= 0xBU && DecodeExtendedLeaf(0xBU, topo)))
+    {
+        CpuId::Execute(0x1U, a, b, c, d);
+
+        if (amd)
+            DecodeAmdLegacy(topo, topoExt);
+        else
+            DecodeIntelLegacy(topo, b, htt);
+    }
+
+    topo.L2Shift = topo.SmtShift;
+    topo.LlcShift = topo.PackageShift;
+    //  Private L2 caches and shared L3 caches are the norm.
+
+    if (amd)
+    {
+        if (topoExt && BootstrapCpuid.MaxExtendedValue >= 0x8000001DU)
+            DecodeCaches(0x8000001DU, topo);
+    }
+    else if (maxStandard >= 0x4U)
+        DecodeCaches(0x4U, topo);
+
+    size_t const index = data->Index;
+
+    assert_or(index < CpuMask::Capacity
+        , "CPU #%us does not fit in the topology masks.", index)
+    {
+        return;
+    }
+
+    withLock (RegistryLock)
+    {
+        __atomic_store_n(Cpus + index, data, __ATOMIC_RELEASE);
+
+        for (size_t i = 0; i < CpuMask::Capacity; ++i)
+        {
+            if (Cpus[i] == nullptr)
+                continue;
+
+            CpuTopology & other = Cpus[i]->Topology;
+            TopologyLevel const level = topo.GetSharedLevel(other);
+
+            if (level <= TopologyLevel::Core)
+            {
+                topo.CoreMask.Set(i);
+                other.CoreMask.Set(index);
+            }
+
+            if (level <= TopologyLevel::L2)
+            {
+                topo.L2Mask.Set(i);
+                other.L2Mask.Set(index);
+            }
+
+            if (level <= TopologyLevel::Llc)
+            {
+                topo.LlcMask.Set(i);
+                other.LlcMask.Set(index);
+            }
+
+            if (level <= TopologyLevel::Package)
+            {
+                topo.PackageMask.Set(i);
+                other.PackageMask.Set(index);
+            }
+        }
+        //  This includes the CPU itself.
+    }
+}
+
+/*  Registry  */
+
+CpuData * CpuTopology::GetCpu(size_t const index)
+{
+    if unlikely(index >= CpuMask::Capacity)
+        return nullptr;
+
+    return __atomic_load_n(Cpus + index, __ATOMIC_ACQUIRE);
+}
+
+/*  Queries  */
+
+TopologyLevel CpuTopology::GetSharedLevel(CpuTopology const & other) const
+{
+    if (this->ApicId == other.ApicId)
+        return TopologyLevel::Thread;
+
+    if (Shares(*this, other, this->SmtShift, other.SmtShift))
+        return TopologyLevel::Core;
+
+    if (Shares(*this, other, this->L2Shift, other.L2Shift))
+        return TopologyLevel::L2;
+
+    if (Shares(*this, other, this->LlcShift, other.LlcShift))
+        return TopologyLevel::Llc;
+
+    if (Shares(*this, other, this->PackageShift, other.PackageShift))
+        return TopologyLevel::Package;
+
+    return TopologyLevel::System;
+}
+
+/*  Debug  */
+
+TerminalWriteResult CpuTopology::PrintToTerminal(TerminalBase * const term) const
+{
+    return term->WriteFormat("APIC ID %u4: core %u4, L2 %u4, LLC %u4, package %u4;"
+        " %us SMT siblings, %us L2 sharers, %us LLC sharers, %us in package.%n"
+        , this->ApicId, this->GetCoreId(), this->GetL2Id(), this->GetLlcId()
+        , this->GetPackageId(), this->CoreMask.GetCount(), this->L2Mask.GetCount()
+        , this->LlcMask.GetCount(), this->PackageMask.GetCount());
+}
@@ -0,0 +1,100 @@
+/*
+    Copyright (c) 2015 Alexandru-Mihai Maftei. All rights reserved.
+
+
+    Developed by: Alexandru-Mihai Maftei
+    aka Vercas
+    http://vercas.com | https://github.com/vercas/Beelzebub
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal with the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+      * Redistributions of source code must retain the above copyright notice,
+        this list of conditions and the following disclaimers.
+      * Redistributions in binary form must reproduce the above copyright
+        notice, this list of conditions and the following disclaimers in the
+        documentation and/or other materials provided with the distribution.
+      * Neither the names of Alexandru-Mihai Maftei, Vercas, nor the names of
+        its contributors may be used to endorse or promote products derived from
+        this Software without specific prior written permission.
+
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+    WITH THE SOFTWARE.
+
+    ---
+
+    You may also find the text of this license in "LICENSE.md", along with a more
+    thorough explanation regarding other files.
+*/
+
+#include <system/static_key.hpp>
+#include <system/alternatives.hpp>
+#include <utils/unit_tests.hpp>
+
+#include <debug.hpp>
+
+using namespace Beelzebub;
+using namespace Beelzebub::System;
+using namespace Beelzebub::Utils;
+
+static StaticKey TestKey;
+
+static __noinline bool TestKeyBranch()
+{
+    if (STATIC_KEY_ENABLED(TestKey))
+        return true;
+    else
+        return false;
+}
+
+static __noinline uint32_t TestAlternative()
+{
+    uint32_t res;
+
+    asm volatile ( ALTERNATIVE("movl $1, %k[res]", "movl $2, %k[res]")
+                 : [res]"=r"(res)
+                 : ALTERNATIVE_FEATURE(FPU) );
+
+    return res;
+}
+
+/*****************
+    Unit Tests
+*****************/
+
+DEFINE_TEST(Code Patching, Static Keys)
+{
+    REQUIRE(!TestKey.IsEnabled(), "New static key is enabled.%n");
+    REQUIRE(!TestKeyBranch(), "New static key branches to its enabled code.%n");
+
+    Handle res = TestKey.Enable();
+
+    REQUIRE(res.IsOkayResult(), "Failed to enable static key: %H%n", res);
+    REQUIRE(TestKey.IsEnabled(), "Enabled static key reads as disabled.%n");
+    REQUIRE(TestKeyBranch(), "Enabled static key branches to its disabled code.%n");
+
+    res = TestKey.Disable();
+
+    REQUIRE(res.IsOkayResult(), "Failed to disable static key: %H%n", res);
+    REQUIRE(!TestKey.IsEnabled(), "Disabled static key reads as enabled.%n");
+    REQUIRE(!TestKeyBranch(), "Disabled static key branches to its enabled code.%n");
+}
+
+DEFINE_TEST(Code Patching, Alternatives)
+{
+    uint32_t const val = TestAlternative();
+
+    REQUIRE(val == 2, "Alternative for the FPU was not applied; got %u4.%n", val);
+    //  Every CPU this kernel runs on has an FPU, and the alternatives are
+    //  applied before unit tests are run.
+}
@@ -0,0 +1,136 @@
+/*
+    Copyright (c) 2015 Alexandru-Mihai Maftei. All rights reserved.
+
+
+    Developed by: Alexandru-Mihai Maftei
+    aka Vercas
+    http://vercas.com | https://github.com/vercas/Beelzebub
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal with the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+      * Redistributions of source code must retain the above copyright notice,
+        this list of conditions and the following disclaimers.
+      * Redistributions in binary form must reproduce the above copyright
+        notice, this list of conditions and the following disclaimers in the
+        documentation and/or other materials provided with the distribution.
+      * Neither the names of Alexandru-Mihai Maftei, Vercas, nor the names of
+        its contributors may be used to endorse or promote products derived from
+        this Software without specific prior written permission.
+
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+    WITH THE SOFTWARE.
+
+    ---
+
+    You may also find the text of this license in "LICENSE.md", along with a more
+    thorough explanation regarding other files.
+*/
+
+#ifdef __BEELZEBUB__TEST_CROSS_CPU
+
+#include <tests/cross_cpu.hpp>
+#include <system/cross_cpu.hpp>
+#include <system/cpu.hpp>
+#include <synchronization/atomic.hpp>
+#include <kernel.hpp>
+
+#include <debug.hpp>
+
+static constexpr size_t const RoundTrips = 2000;
+static constexpr size_t const AsyncCalls = 10000;
+
+using namespace Beelzebub;
+using namespace Beelzebub::Synchronization;
+using namespace Beelzebub::System;
+using namespace Beelzebub::Terminals;
+
+static Atomic<size_t> Counter {0};
+static size_t volatile RanOn;
+
+static void Increment(void * const)
+{
+    ++Counter;
+}
+
+static void RecordCpu(void * const)
+{
+    RanOn = Cpu::GetData()->Index;
+}
+
+void TestCrossCpu()
+{
+    size_t const self = Cpu::GetData()->Index;
+#if   defined(__BEELZEBUB_SETTINGS_SMP)
+    size_t const count = Cpu::Count.Load();
+#else
+    size_t const count = Cpu::Count;
+#endif
+
+    Counter.Store(0);
+
+    Handle res = CrossCpu::CallOnAll(&Increment, nullptr);
+
+    ASSERT(res.IsOkayResult(), "Failed to call every CPU: %H.", res);
+    ASSERT(Counter.Load() == count
+        , "%us CPUs ran the function instead of %us.", Counter.Load(), count);
+
+    if (count < 2)
+        return;
+
+    size_t const target = self == 0 ? 1 : 0;
+
+    uint64_t const start = CpuInstructions::Rdtsc();
+
+    for (size_t i = 0; i < RoundTrips; ++i)
+    {
+        RanOn = SIZE_MAX;
+
+        res = CrossCpu::CallOnCpu(target, &RecordCpu, nullptr);
+
+        ASSERT(res.IsOkayResult(), "Failed to call CPU #%us: %H.", target, res);
+        ASSERT(RanOn == target, "Function ran on CPU #%us instead of #%us.", RanOn, target);
+    }
+
+    uint64_t const duration = CpuInstructions::Rdtsc() - start;
+
+    DEBUG_TERM_ << "Synchronous call round-trip: AVG " << (duration / RoundTrips)
+                << " cycles." << EndLine;
+
+    Counter.Store(0);
+
+    CpuMask others;
+
+    for (size_t i = 0; i < count; ++i)
+        if (i != self)
+            others.Set(i);
+
+    uint64_t const asyncStart = CpuInstructions::Rdtsc();
+
+    for (size_t i = 0; i < AsyncCalls; ++i)
+    {
+        res = CrossCpu::CallOnMask(others, &Increment, nullptr, false);
+
+        ASSERT(res.IsOkayResult(), "Failed to queue asynchronous call: %H.", res);
+    }
+
+    while (Counter.Load() < AsyncCalls * (count - 1))
+        CpuInstructions::DoNothing();
+
+    uint64_t const asyncDuration = CpuInstructions::Rdtsc() - asyncStart;
+
+    DEBUG_TERM_ << "Asynchronous call to " << (count - 1) << " CPUs: AVG "
+                << (asyncDuration / AsyncCalls) << " cycles." << EndLine;
+}
+
+#endif
@@ -0,0 +1,200 @@
+/*
+    Copyright (c) 2015 Alexandru-Mihai Maftei. All rights reserved.
+
+
+    Developed by: Alexandru-Mihai Maftei
+    aka Vercas
+    http://vercas.com | https://github.com/vercas/Beelzebub
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal with the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+      * Redistributions of source code must retain the above copyright notice,
+        this list of conditions and the following disclaimers.
+      * Redistributions in binary form must reproduce the above copyright
+        notice, this list of conditions and the following disclaimers in the
+        documentation and/or other materials provided with the distribution.
+      * Neither the names of Alexandru-Mihai Maftei, Vercas, nor the names of
+        its contributors may be used to endorse or promote products derived from
+        this Software without specific prior written permission.
+
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+    WITH THE SOFTWARE.
+
+    ---
+
+    You may also find the text of this license in "LICENSE.md", along with a more
+    thorough explanation regarding other files.
+*/
+
+#ifdef __BEELZEBUB__TEST_DEFERRED_WORK
+
+#include <tests/deferred_work.hpp>
+#include <execution/soft_irq.hpp>
+#include <execution/work_queue.hpp>
+#include <execution/yield.hpp>
+#include <system/cross_cpu.hpp>
+#include <system/cpu.hpp>
+#include <synchronization/atomic.hpp>
+#include <kernel.hpp>
+
+#include <debug.hpp>
+
+static constexpr size_t const RoundTrips = 2000;
+
+using namespace Beelzebub;
+using namespace Beelzebub::Execution;
+using namespace Beelzebub::Synchronization;
+using namespace Beelzebub::System;
+using namespace Beelzebub::Terminals;
+
+/**
+ *  Where and how a deferred function ran.
+ */
+struct DeferredRun
+{
+    size_t volatile Cpu;
+    bool volatile InterruptsEnabled;
+    bool volatile InSoftIrq;
+    bool volatile InWorker;
+    uint64_t volatile Timestamp;
+};
+
+static DeferredRun Runs[CpuMask::Capacity];
+static Atomic<size_t> Counter {0};
+
+static void Record(DeferredRun * const run)
+{
+    CpuData * const data = Cpu::GetData();
+
+    run->Timestamp = CpuInstructions::Rdtsc();
+    run->Cpu = data->Index;
+    run->InterruptsEnabled = Interrupts::AreEnabled();
+    run->InSoftIrq = SoftIrq::IsActive();
+    run->InWorker = Cpu::GetThread() == data->Work.GetWorker();
+
+    ++Counter;
+}
+
+static void RecordTasklet(Tasklet * const tasklet)
+{
+    Record((DeferredRun *)(tasklet->Cookie));
+}
+
+static void RecordWork(WorkItem * const item)
+{
+    Record((DeferredRun *)(item->Cookie));
+}
+
+static Tasklet Tasklets[CpuMask::Capacity];
+static WorkItem Items[CpuMask::Capacity];
+
+static void ScheduleFromInterrupt(void * const)
+{
+    size_t const index = Cpu::GetData()->Index;
+
+    Tasklets[index].Schedule();
+    WorkQueue::QueueLocal(Items + index);
+}
+
+static void AwaitCounter(size_t const target)
+{
+    while (Counter.Load() < target)
+        Yield::Now();
+}
+
+static void CheckRuns(size_t const count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        DeferredRun const & run = Runs[i];
+
+        ASSERT(run.Cpu == i, "Deferred function of CPU #%us ran on CPU #%us.", i, run.Cpu);
+        ASSERT(run.InterruptsEnabled, "Deferred function ran with interrupts disabled.");
+    }
+}
+
+void TestDeferredWork()
+{
+    size_t const self = Cpu::GetData()->Index;
+#if   defined(__BEELZEBUB_SETTINGS_SMP)
+    size_t const count = Cpu::Count.Load();
+#else
+    size_t const count = Cpu::Count;
+#endif
+
+    //  First, tasklets scheduled by a thread.
+
+    Counter.Store(0);
+    new (Tasklets + self) Tasklet(&RecordTasklet, Runs + self);
+
+    bool scheduled = Tasklets[self].Schedule();
+
+    ASSERT(scheduled, "Fresh tasklet was considered scheduled.");
+
+    AwaitCounter(1);
+
+    ASSERT(Runs[self].Cpu == self && Runs[self].InSoftIrq
+        , "Tasklet did not run in a soft interrupt of this CPU.");
+    ASSERT(Runs[self].InterruptsEnabled, "Tasklet ran with interrupts disabled.");
+
+    //  Then tasklets and work items queued by interrupt handlers on every CPU.
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        new (Tasklets + i) Tasklet(&RecordTasklet, Runs + i);
+        new (Items + i) WorkItem(&RecordWork, Runs + i);
+    }
+
+    Counter.Store(0);
+
+    Handle res = CrossCpu::CallOnAll(&ScheduleFromInterrupt, nullptr);
+
+    ASSERT(res.IsOkayResult(), "Failed to call every CPU: %H.", res);
+
+    AwaitCounter(2 * count);
+    CheckRuns(count);
+    //  This CPU ran the function with interrupts disabled, outside of any
+    //  interrupt, so its tasklet waits for the next one or for the worker.
+
+    for (size_t i = 0; i < count; ++i)
+        ASSERT(Runs[i].InWorker && !Runs[i].InSoftIrq
+            , "Work item of CPU #%us did not run in its worker thread.", i);
+    //  Work items run last, so they are the ones recorded.
+
+    //  Finally, the latency of work items.
+
+    new (Items + self) WorkItem(&RecordWork, Runs + self);
+
+    uint64_t total = 0;
+
+    for (size_t i = 0; i < RoundTrips; ++i)
+    {
+        Counter.Store(0);
+
+        uint64_t const start = CpuInstructions::Rdtsc();
+
+        bool const queued = WorkQueue::QueueLocal(Items + self);
+
+        ASSERT(queued, "Work item was still queued.");
+
+        AwaitCounter(1);
+
+        total += Runs[self].Timestamp - start;
+    }
+
+    DEBUG_TERM_ << "Work item queuing to execution: AVG " << (total / RoundTrips)
+                << " cycles." << EndLine;
+}
+
+#endif
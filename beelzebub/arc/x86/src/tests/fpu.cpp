@@ -40,10 +40,14 @@
 #ifdef __BEELZEBUB__TEST_FPU
 
 #include <tests/fpu.hpp>
+#include <execution/extended_states.hpp>
+#include <system/fpu.hpp>
+#include <system/interrupts.hpp>
 
 #include <debug.hpp>
 
 using namespace Beelzebub;
+using namespace Beelzebub::Execution;
 using namespace Beelzebub::System;
 
 #pragma GCC diagnostic push
@@ -60,6 +64,41 @@ __cold __fancy __noinline void TestSse2()
     ASSERT(c == -1, "Eh...");
 }
 
+/**
+ *  Checks that a register survives a round trip through an extended state
+ *  area, with whichever instructions were picked.
+ */
+__cold __fancy __noinline void TestSaveRestore()
+{
+    if (!ExtendedStates::Initialized)
+        return;
+
+    void * state = nullptr;
+    Handle res = ExtendedStates::AllocateNew(state);
+
+    ASSERT(res.IsOkayResult(), "Failed to allocate an extended state: %H", res);
+
+    double a = 42, b = 0;
+
+    withInterrupts (false)
+    {
+        asm volatile ("movsd %0, %%xmm0 \n\t" : : "m"(a) : "xmm0");
+
+        Fpu::SaveState(state);
+
+        asm volatile ("xorpd %%xmm0, %%xmm0 \n\t" : : : "xmm0");
+
+        Fpu::LoadState(state);
+
+        asm volatile ("movsd %%xmm0, %0 \n\t" : "=m"(b));
+    }
+
+    ASSERT(b == a, "XMM0 was not restored: %Xd instead of %Xd."
+        , b, a);
+
+    ExtendedStates::Deallocate(state);
+}
+
 void TestFpu()
 {
     volatile double a = 1;
@@ -70,6 +109,7 @@ void TestFpu()
     ASSERT(a == 32, "Eh...");
 
     TestSse2();
+    TestSaveRestore();
 
     union { double d; uint64_t u; } b = {a};
 
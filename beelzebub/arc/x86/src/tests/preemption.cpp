@@ -0,0 +1,197 @@
+/*
+    Copyright (c) 2015 Alexandru-Mihai Maftei. All rights reserved.
+
+
+    Developed by: Alexandru-Mihai Maftei
+    aka Vercas
+    http://vercas.com | https://github.com/vercas/Beelzebub
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal with the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+      * Redistributions of source code must retain the above copyright notice,
+        this list of conditions and the following disclaimers.
+      * Redistributions in binary form must reproduce the above copyright
+        notice, this list of conditions and the following disclaimers in the
+        documentation and/or other materials provided with the distribution.
+      * Neither the names of Alexandru-Mihai Maftei, Vercas, nor the names of
+        its contributors may be used to endorse or promote products derived from
+        this Software without specific prior written permission.
+
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+    WITH THE SOFTWARE.
+
+    ---
+
+    You may also find the text of this license in "LICENSE.md", along with a more
+    thorough explanation regarding other files.
+*/
+
+#ifdef __BEELZEBUB__TEST_PREEMPTION
+
+#include <tests/preemption.hpp>
+#include <execution/thread_init.hpp>
+#include <execution/scheduler.hpp>
+#include <execution/yield.hpp>
+#include <memory/vmm.hpp>
+#include <synchronization/spinlock.hpp>
+#include <system/cpu.hpp>
+#include <kernel.hpp>
+
+#include <debug.hpp>
+
+static constexpr size_t const SampleCount = 64;
+static constexpr uint64_t const SectionCycles = 2000000;
+//  A critical section this long spans a fair share of a timer period.
+
+using namespace Beelzebub;
+using namespace Beelzebub::Execution;
+using namespace Beelzebub::Memory;
+using namespace Beelzebub::Synchronization;
+using namespace Beelzebub::System;
+using namespace Beelzebub::Terminals;
+
+static Thread ProbeThread;
+static Spinlock<> HogLock;
+
+static size_t volatile TickSeen;
+static uint64_t volatile TickTime;
+//  Set by the hog when it notices a timer tick inside its critical section.
+
+static size_t volatile DeferredCount, ImmediateCount;
+static uint64_t volatile LatencyAcc, MinLatency, MaxLatency;
+
+/*  The probe measures the time between a timer tick which occurred inside
+    the hog's critical section and the moment it is switched to. Ticks which
+    happened outside of critical sections are just counted.  */
+
+static __hot void * ProbeEntryPoint(void * const)
+{
+    size_t lastTicks = Cpu::GetData()->TimerTicks;
+
+    while (DeferredCount + ImmediateCount < SampleCount)
+    {
+        size_t const ticks = Cpu::GetData()->TimerTicks;
+
+        if (ticks == lastTicks)
+            continue;
+        //  Still in the same time slice.
+
+        uint64_t const now = CpuInstructions::Rdtsc();
+        COMPILER_MEMORY_BARRIER();
+
+        lastTicks = ticks;
+
+        if (TickSeen != ticks)
+        {
+            ++ImmediateCount;
+
+            continue;
+        }
+
+        uint64_t const latency = now - TickTime;
+
+        LatencyAcc += latency;
+
+        if (latency < MinLatency) MinLatency = latency;
+        if (latency > MaxLatency) MaxLatency = latency;
+
+        ++DeferredCount;
+    }
+
+    Cpu::GetThread()->Blocked = true;
+
+    while (true)
+        Yield::Now();
+    //  Never to be switched to again.
+}
+
+static __startup void InitializeProbeThread()
+{
+    new (&ProbeThread) Thread(&BootstrapProcess);
+
+    uintptr_t stackVaddr = nullvaddr;
+
+    Handle res = Vmm::AllocatePages(&BootstrapProcess
+        , 3
+        , MemoryAllocationOptions::Commit | MemoryAllocationOptions::VirtualKernelHeap
+        , MemoryFlags::Global | MemoryFlags::Writable
+        , MemoryContent::ThreadStack
+        , stackVaddr);
+
+    ASSERT(res.IsOkayResult()
+        , "Failed to allocate stack for preemption probe thread: %H."
+        , res);
+
+    ProbeThread.KernelStackTop = stackVaddr + 3 * PageSize;
+    ProbeThread.KernelStackBottom = stackVaddr;
+
+    ProbeThread.EntryPoint = &ProbeEntryPoint;
+
+    InitializeThreadState(&ProbeThread);
+}
+
+void TestPreemption()
+{
+    TickSeen = 0;
+    DeferredCount = ImmediateCount = 0;
+    LatencyAcc = MaxLatency = 0;
+    MinLatency = 0xFFFFFFFFFFFFFFFFUL;
+
+    InitializeProbeThread();
+
+    ProbeThread.Pinned = true;
+    Scheduler::Enqueue(&ProbeThread);
+    //  It has to share this CPU with the hog.
+
+    size_t ticks = Cpu::GetData()->TimerTicks;
+
+    while (DeferredCount + ImmediateCount < SampleCount)
+    {
+        withLock (HogLock)
+        {
+            uint64_t const start = CpuInstructions::Rdtsc();
+
+            do
+            {
+                size_t const now = Cpu::GetData()->TimerTicks;
+
+                if (now != ticks)
+                {
+                    TickTime = CpuInstructions::Rdtsc();
+                    COMPILER_MEMORY_BARRIER();
+                    TickSeen = ticks = now;
+                }
+            } while (CpuInstructions::Rdtsc() - start < SectionCycles);
+        }
+
+        ticks = Cpu::GetData()->TimerTicks;
+        //  Ticks outside of the critical section are not the hog's business.
+    }
+
+    if (DeferredCount == 0)
+    {
+        DEBUG_TERM_ << "Preemption latency: no switches were deferred by the "
+                    << ImmediateCount << " ticks." << EndLine;
+        //  Kernel preemption is off, so critical sections are interrupted.
+    }
+    else
+    {
+        DEBUG_TERM_
+            << "Preemption latency (" << DeferredCount << " deferred, " << ImmediateCount
+            << " immediate switches): AVG " << (LatencyAcc / DeferredCount)
+            << "; MIN " << MinLatency << "; MAX " << MaxLatency << EndLine;
+    }
+}
+
+#endif
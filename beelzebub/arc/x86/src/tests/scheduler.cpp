@@ -0,0 +1,241 @@
+/*
+    Copyright (c) 2015 Alexandru-Mihai Maftei. All rights reserved.
+
+
+    Developed by: Alexandru-Mihai Maftei
+    aka Vercas
+    http://vercas.com | https://github.com/vercas/Beelzebub
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal with the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+      * Redistributions of source code must retain the above copyright notice,
+        this list of conditions and the following disclaimers.
+      * Redistributions in binary form must reproduce the above copyright
+        notice, this list of conditions and the following disclaimers in the
+        documentation and/or other materials provided with the distribution.
+      * Neither the names of Alexandru-Mihai Maftei, Vercas, nor the names of
+        its contributors may be used to endorse or promote products derived from
+        this Software without specific prior written permission.
+
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+    WITH THE SOFTWARE.
+
+    ---
+
+    You may also find the text of this license in "LICENSE.md", along with a more
+    thorough explanation regarding other files.
+*/
+
+#ifdef __BEELZEBUB__TEST_SCHEDULER
+
+#include <tests/scheduler.hpp>
+#include <execution/thread_init.hpp>
+#include <execution/scheduler.hpp>
+#include <execution/yield.hpp>
+#include <memory/vmm.hpp>
+#include <synchronization/semaphore.hpp>
+#include <system/cpu.hpp>
+#include <kernel.hpp>
+
+#include <debug.hpp>
+
+static constexpr size_t const SwitchIterations = 20000;
+static constexpr size_t const WakeIterations = 2000;
+
+using namespace Beelzebub;
+using namespace Beelzebub::Execution;
+using namespace Beelzebub::Memory;
+using namespace Beelzebub::Synchronization;
+using namespace Beelzebub::System;
+using namespace Beelzebub::Terminals;
+
+/**
+ *  Data shared by a sleeper thread and the thread which wakes it up.
+ */
+struct WakeBenchmark
+{
+    Thread Sleeper;
+    Semaphore Signal;
+
+    uint64_t volatile ReleaseTime;
+    size_t volatile Count;
+
+    uint64_t LatencyAcc, MinLatency, MaxLatency;
+};
+
+static Thread PingThread;
+static bool volatile PingDone;
+
+static WakeBenchmark LocalBench, RemoteBench;
+
+/*  Threads  */
+
+static void Retire()
+{
+    Cpu::GetThread()->Blocked = true;
+
+    while (true)
+        Scheduler::Block();
+    //  Never to be woken up.
+}
+
+static __hot void * PingEntryPoint(void * const)
+{
+    while (!PingDone)
+        Yield::Now();
+
+    Retire();
+
+    return nullptr;
+}
+
+static __hot void * SleeperEntryPoint(void * const)
+{
+    WakeBenchmark * const bench = Cpu::GetThread() == &(LocalBench.Sleeper)
+        ? &LocalBench : &RemoteBench;
+
+    for (size_t i = 0; i < WakeIterations; ++i)
+    {
+        bench->Signal.Acquire();
+
+        uint64_t const latency = CpuInstructions::Rdtsc() - bench->ReleaseTime;
+
+        bench->LatencyAcc += latency;
+
+        if (latency < bench->MinLatency) bench->MinLatency = latency;
+        if (latency > bench->MaxLatency) bench->MaxLatency = latency;
+
+        COMPILER_MEMORY_BARRIER();
+        ++bench->Count;
+    }
+
+    Retire();
+
+    return nullptr;
+}
+
+static __startup void InitializeBenchmarkThread(Thread * const t, ThreadEntryPointFunction const entry, bool const pinned)
+{
+    new (t) Thread(&BootstrapProcess);
+
+    uintptr_t stackVaddr = nullvaddr;
+
+    Handle res = Vmm::AllocatePages(&BootstrapProcess
+        , 3
+        , MemoryAllocationOptions::Commit | MemoryAllocationOptions::VirtualKernelHeap
+        , MemoryFlags::Global | MemoryFlags::Writable
+        , MemoryContent::ThreadStack
+        , stackVaddr);
+
+    ASSERT(res.IsOkayResult()
+        , "Failed to allocate stack for scheduler benchmark thread: %H."
+        , res);
+
+    t->KernelStackTop = stackVaddr + 3 * PageSize;
+    t->KernelStackBottom = stackVaddr;
+
+    t->EntryPoint = entry;
+
+    InitializeThreadState(t);
+
+    t->Priority = ThreadPriority::High;
+    t->Pinned = pinned;
+
+    res = Scheduler::Enqueue(t);
+
+    ASSERT(res.IsOkayResult()
+        , "Failed to enqueue scheduler benchmark thread: %H."
+        , res);
+}
+
+/*  Benchmarks  */
+
+static __startup void BenchmarkSwitches()
+{
+    PingDone = false;
+
+    InitializeBenchmarkThread(&PingThread, &PingEntryPoint, true);
+
+    uint64_t const start = CpuInstructions::Rdtsc();
+
+    for (size_t i = 0; i < SwitchIterations; ++i)
+        Yield::Now();
+
+    uint64_t const duration = CpuInstructions::Rdtsc() - start;
+
+    PingDone = true;
+    Yield::Now();
+    //  Lets the ping thread retire.
+
+    DEBUG_TERM_ << "Context switch: AVG " << (duration / (2 * SwitchIterations))
+                << " cycles over " << (2 * SwitchIterations) << " switches." << EndLine;
+}
+
+static __startup void BenchmarkWakeUps(WakeBenchmark * const bench, bool const remote)
+{
+    new (&(bench->Signal)) Semaphore(0);
+    bench->Count = 0;
+    bench->LatencyAcc = bench->MaxLatency = 0;
+    bench->MinLatency = 0xFFFFFFFFFFFFFFFFUL;
+
+    InitializeBenchmarkThread(&(bench->Sleeper), &SleeperEntryPoint, !remote);
+
+    for (size_t i = 0; i < WakeIterations; ++i)
+    {
+        while (!bench->Sleeper.Blocked || bench->Sleeper.Running)
+            if (remote)
+                CpuInstructions::DoNothing();
+            else
+                Yield::Now();
+        //  Only a thread which has given up its CPU is really woken up.
+
+        bench->ReleaseTime = CpuInstructions::Rdtsc();
+        COMPILER_MEMORY_BARRIER();
+
+        bench->Signal.Release();
+
+        while (bench->Count <= i)
+            if (remote)
+                CpuInstructions::DoNothing();
+            else
+                Yield::Now();
+    }
+
+    DEBUG_TERM_
+        << (remote ? "Remote" : "Local") << " wake-up latency: AVG "
+        << (bench->LatencyAcc / WakeIterations) << "; MIN " << bench->MinLatency
+        << "; MAX " << bench->MaxLatency << EndLine;
+}
+
+void TestScheduler()
+{
+    Thread * const self = Cpu::GetThread();
+    ThreadPriority const priority = self->Priority;
+
+    self->Priority = ThreadPriority::High;
+    //  Other threads of this CPU stay out of the way.
+
+    BenchmarkSwitches();
+    BenchmarkWakeUps(&LocalBench, false);
+
+#if   defined(__BEELZEBUB_SETTINGS_SMP)
+    if (Cpu::Count.Load() > 1)
+        BenchmarkWakeUps(&RemoteBench, true);
+    //  The sleeper goes to an idle CPU, which is woken up by an IPI.
+#endif
+
+    self->Priority = priority;
+}
+
+#endif
@@ -0,0 +1,80 @@
+/*
+    Copyright (c) 2015 Alexandru-Mihai Maftei. All rights reserved.
+
+
+    Developed by: Alexandru-Mihai Maftei
+    aka Vercas
+    http://vercas.com | https://github.com/vercas/Beelzebub
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal with the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+      * Redistributions of source code must retain the above copyright notice,
+        this list of conditions and the following disclaimers.
+      * Redistributions in binary form must reproduce the above copyright
+        notice, this list of conditions and the following disclaimers in the
+        documentation and/or other materials provided with the distribution.
+      * Neither the names of Alexandru-Mihai Maftei, Vercas, nor the names of
+        its contributors may be used to endorse or promote products derived from
+        this Software without specific prior written permission.
+
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+    WITH THE SOFTWARE.
+
+    ---
+
+    You may also find the text of this license in "LICENSE.md", along with a more
+    thorough explanation regarding other files.
+*/
+
+#include <synchronization/spinlock_uninterruptible.hpp>
+#include <system/interrupts.hpp>
+#include <utils/unit_tests.hpp>
+
+#include <debug.hpp>
+
+using namespace Beelzebub;
+using namespace Beelzebub::Synchronization;
+using namespace Beelzebub::System;
+using namespace Beelzebub::Utils;
+
+/*****************
+    Unit Tests
+*****************/
+
+DEFINE_TEST(Spinlocks, Uninterruptible TryAcquire)
+{
+    SpinlockUninterruptible<false> lock;
+    SpinlockUninterruptible<false>::Cookie cookie, other;
+    //  The non-SMP flavour is a real lock in every build.
+
+    bool const enabled = Interrupts::AreEnabled();
+
+    lock.Reset();
+
+    REQUIRE(lock.TryAcquire(cookie), "Failed to acquire a free uninterruptible spinlock.%n");
+    REQUIRE(!lock.Check(), "Acquired uninterruptible spinlock reads as free.%n");
+    REQUIRE(!Interrupts::AreEnabled(), "Acquired uninterruptible spinlock left interrupts enabled.%n");
+
+    REQUIRE(!lock.TryAcquire(other), "Acquired a held uninterruptible spinlock.%n");
+    REQUIRE(!lock.Check(), "Failed acquisition freed an uninterruptible spinlock.%n");
+
+    lock.Release(cookie);
+
+    REQUIRE(lock.Check(), "Released uninterruptible spinlock reads as held.%n");
+    REQUIRE(Interrupts::AreEnabled() == enabled, "Releasing an uninterruptible spinlock did not restore the interrupt state.%n");
+
+    REQUIRE(lock.TryAcquire(cookie), "Failed to acquire a released uninterruptible spinlock.%n");
+
+    lock.Release(cookie);
+}
@@ -0,0 +1,238 @@
+/*
+    Copyright (c) 2015 Alexandru-Mihai Maftei. All rights reserved.
+
+
+    Developed by: Alexandru-Mihai Maftei
+    aka Vercas
+    http://vercas.com | https://github.com/vercas/Beelzebub
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal with the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+      * Redistributions of source code must retain the above copyright notice,
+        this list of conditions and the following disclaimers.
+      * Redistributions in binary form must reproduce the above copyright
+        notice, this list of conditions and the following disclaimers in the
+        documentation and/or other materials provided with the distribution.
+      * Neither the names of Alexandru-Mihai Maftei, Vercas, nor the names of
+        its contributors may be used to endorse or promote products derived from
+        this Software without specific prior written permission.
+
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+    WITH THE SOFTWARE.
+
+    ---
+
+    You may also find the text of this license in "LICENSE.md", along with a more
+    thorough explanation regarding other files.
+*/
+
+#ifdef __BEELZEBUB__TEST_TIMERS
+
+#include <tests/timers.hpp>
+#include <system/timers/timer_wheel.hpp>
+#include <system/timers/tsc.hpp>
+#include <system/timers/hpet.hpp>
+#include <execution/scheduler.hpp>
+#include <synchronization/semaphore.hpp>
+#include <system/cpu.hpp>
+#include <kernel.hpp>
+
+#include <debug.hpp>
+
+static constexpr size_t const ExpiryIterations = 100;
+static constexpr uint64_t const ExpiryDelay = 2000000;      //  2 ms
+static constexpr uint64_t const TimerPeriod = 2000000;      //  2 ms
+static constexpr uint64_t const PeriodicLength = 50000000;  //  50 ms
+static constexpr uint64_t const SleepLength = 3000000;      //  3 ms
+static constexpr uint64_t const TimeoutLength = 5000000;    //  5 ms
+static constexpr uint64_t const ClockLength = 20000000;     //  20 ms
+
+using namespace Beelzebub;
+using namespace Beelzebub::Execution;
+using namespace Beelzebub::Synchronization;
+using namespace Beelzebub::System;
+using namespace Beelzebub::System::Timers;
+using namespace Beelzebub::Terminals;
+
+static Semaphore Expired;
+static uint64_t volatile ExpiryTime;
+static size_t volatile PeriodicCount;
+
+/*  Timer Functions  */
+
+static void RecordExpiry(Timer * const)
+{
+    ExpiryTime = Tsc::GetMonotonicNanoseconds();
+
+    Expired.Release();
+}
+
+static void CountPeriod(Timer * const)
+{
+    ++PeriodicCount;
+}
+
+static void FailExpiry(Timer * const)
+{
+    ASSERT(false, "Cancelled timer has expired!");
+}
+
+/*  Tests  */
+
+static __startup void TestExpiry()
+{
+    new (&Expired) Semaphore(0);
+
+    Timer timer(&RecordExpiry);
+    uint64_t lateAcc = 0, minLate = 0xFFFFFFFFFFFFFFFFUL, maxLate = 0;
+
+    for (size_t i = 0; i < ExpiryIterations; ++i)
+    {
+        uint64_t const start = Tsc::GetMonotonicNanoseconds();
+
+        timer.Start(ExpiryDelay);
+        Expired.Acquire();
+
+        uint64_t const elapsed = ExpiryTime - start;
+
+        ASSERT(elapsed >= ExpiryDelay
+            , "Timer expired early: %u8 ns instead of %u8 ns."
+            , elapsed, ExpiryDelay);
+
+        uint64_t const late = elapsed - ExpiryDelay;
+
+        lateAcc += late;
+
+        if (late < minLate) minLate = late;
+        if (late > maxLate) maxLate = late;
+    }
+
+    DEBUG_TERM_ << "Timer lateness: AVG " << (lateAcc / ExpiryIterations)
+                << " ns; MIN " << minLate << " ns; MAX " << maxLate << " ns." << EndLine;
+}
+
+static __startup void TestPeriodic()
+{
+    PeriodicCount = 0;
+
+    Timer timer(&CountPeriod);
+
+    timer.Start(TimerPeriod, TimerPeriod);
+    Scheduler::Sleep(PeriodicLength);
+
+    bool const pending = timer.Cancel();
+    size_t const count = PeriodicCount;
+
+    ASSERT(pending, "Periodic timer was not pending anymore!");
+    ASSERT(count > 0 && count <= PeriodicLength / TimerPeriod
+        , "Periodic timer expired %us times in %u8 ns.", count, PeriodicLength);
+
+    Scheduler::Sleep(2 * TimerPeriod);
+
+    ASSERT(PeriodicCount == count, "Periodic timer expired after cancellation!");
+}
+
+static __startup void TestCancel()
+{
+    Timer timer(&FailExpiry);
+
+    timer.Start(ExpiryDelay);
+
+    ASSERT(timer.IsPending(), "Timer is not pending after being started!");
+    ASSERT(timer.Cancel(), "Pending timer could not be cancelled!");
+    ASSERT(!timer.IsPending(), "Timer is still pending after cancellation!");
+
+    Scheduler::Sleep(2 * ExpiryDelay);
+}
+
+static __startup void TestSleep()
+{
+    uint64_t const start = Tsc::GetMonotonicNanoseconds();
+
+    Scheduler::Sleep(SleepLength);
+
+    uint64_t const elapsed = Tsc::GetMonotonicNanoseconds() - start;
+
+    ASSERT(elapsed >= SleepLength
+        , "Thread slept for %u8 ns instead of %u8 ns."
+        , elapsed, SleepLength);
+
+    DEBUG_TERM_ << "Sleep of " << SleepLength << " ns took " << elapsed << " ns." << EndLine;
+}
+
+static __startup void TestTimeout()
+{
+    Semaphore sem(0);
+
+    uint64_t const start = Tsc::GetMonotonicNanoseconds();
+
+    bool const acquired = sem.TryAcquire(TimeoutLength);
+
+    uint64_t const elapsed = Tsc::GetMonotonicNanoseconds() - start;
+
+    ASSERT(!acquired, "Acquired a unit of an empty semaphore!");
+    ASSERT(elapsed >= TimeoutLength
+        , "Semaphore timed out after %u8 ns instead of %u8 ns."
+        , elapsed, TimeoutLength);
+
+    sem.Release();
+
+    ASSERT(sem.TryAcquire(TimeoutLength), "Failed to acquire an available unit!");
+}
+
+static __startup void TestClocks()
+{
+    uint64_t startCounter = 0, start = 0, endCounter = 0, end = 0;
+
+    withInterrupts (false)
+    {
+        startCounter = Hpet::GetCounter();
+        start = Tsc::GetMonotonicNanoseconds();
+    }
+
+    Scheduler::Sleep(ClockLength);
+
+    withInterrupts (false)
+    {
+        endCounter = Hpet::GetCounter();
+        end = Tsc::GetMonotonicNanoseconds();
+    }
+
+    uint64_t const hpet = Hpet::ToNanoseconds((endCounter - startCounter) & Hpet::CounterMask);
+    uint64_t const tsc = end - start;
+    uint64_t const drift = hpet > tsc ? hpet - tsc : tsc - hpet;
+
+    ASSERT(drift < ClockLength / 1000
+        , "TSC and HPET disagree: %u8 ns versus %u8 ns."
+        , tsc, hpet);
+    //  Both were read back to back, so they may only differ by calibration
+    //  error.
+
+    DEBUG_TERM_ << "TSC and HPET differ by " << drift << " ns over "
+                << tsc << " ns." << EndLine;
+}
+
+void TestTimers()
+{
+    if (Hpet::IsAvailable())
+        TestClocks();
+
+    TestExpiry();
+    TestPeriodic();
+    TestCancel();
+    TestSleep();
+    TestTimeout();
+}
+
+#endif
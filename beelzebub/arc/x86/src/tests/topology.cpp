@@ -0,0 +1,125 @@
+/*
+    Copyright (c) 2015 Alexandru-Mihai Maftei. All rights reserved.
+
+
+    Developed by: Alexandru-Mihai Maftei
+    aka Vercas
+    http://vercas.com | https://github.com/vercas/Beelzebub
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal with the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+      * Redistributions of source code must retain the above copyright notice,
+        this list of conditions and the following disclaimers.
+      * Redistributions in binary form must reproduce the above copyright
+        notice, this list of conditions and the following disclaimers in the
+        documentation and/or other materials provided with the distribution.
+      * Neither the names of Alexandru-Mihai Maftei, Vercas, nor the names of
+        its contributors may be used to endorse or promote products derived from
+        this Software without specific prior written permission.
+
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+    WITH THE SOFTWARE.
+
+    ---
+
+    You may also find the text of this license in "LICENSE.md", along with a more
+    thorough explanation regarding other files.
+*/
+
+#ifdef __BEELZEBUB__TEST_TOPOLOGY
+
+#include <tests/topology.hpp>
+#include <system/topology.hpp>
+#include <system/cpu.hpp>
+#include <kernel.hpp>
+
+#include <debug.hpp>
+
+using namespace Beelzebub;
+using namespace Beelzebub::System;
+using namespace Beelzebub::Terminals;
+
+/**
+ *  Makes sure that a mask holds exactly the CPUs which share the given level
+ *  with the given one.
+ */
+static void CheckMask(CpuData * const data, CpuMask const & mask
+    , TopologyLevel const level, char const * const name)
+{
+    for (size_t i = 0; i < CpuMask::Capacity; ++i)
+    {
+        CpuData * const other = CpuTopology::GetCpu(i);
+
+        if (other == nullptr)
+        {
+            ASSERT(!mask.Get(i), "%s mask of CPU #%us has absent CPU #%us."
+                , name, data->Index, i);
+
+            continue;
+        }
+
+        bool const shared = data->Topology.GetSharedLevel(other->Topology) <= level;
+
+        ASSERT(mask.Get(i) == shared
+            , "%s mask of CPU #%us disagrees with the topology of CPU #%us."
+            , name, data->Index, i);
+
+        ASSERT(shared == (other->Topology.GetSharedLevel(data->Topology) <= level)
+            , "CPUs #%us and #%us disagree on sharing their %s."
+            , data->Index, i, name);
+    }
+}
+
+void TestTopology()
+{
+#if   defined(__BEELZEBUB_SETTINGS_SMP)
+    size_t const count = Cpu::Count.Load();
+#else
+    size_t const count = Cpu::Count;
+#endif
+
+    size_t found = 0;
+
+    for (size_t i = 0; i < CpuMask::Capacity; ++i)
+    {
+        CpuData * const data = CpuTopology::GetCpu(i);
+
+        if (data == nullptr)
+            continue;
+
+        ++found;
+
+        CpuTopology const & topo = data->Topology;
+
+        ASSERT(data->Index == i, "CPU #%us is registered as #%us.", data->Index, i);
+        ASSERT(topo.CoreMask.Get(i) && topo.L2Mask.Get(i)
+            && topo.LlcMask.Get(i) && topo.PackageMask.Get(i)
+            , "CPU #%us is missing from its own masks.", i);
+        ASSERT(topo.SmtShift <= topo.PackageShift
+            , "CPU #%us has more SMT bits (%u1) than package bits (%u1)."
+            , i, topo.SmtShift, topo.PackageShift);
+
+        CheckMask(data, topo.CoreMask, TopologyLevel::Core, "Core");
+        CheckMask(data, topo.L2Mask, TopologyLevel::L2, "L2");
+        CheckMask(data, topo.LlcMask, TopologyLevel::Llc, "LLC");
+        CheckMask(data, topo.PackageMask, TopologyLevel::Package, "Package");
+
+        DEBUG_TERM_ << "CPU #" << i << ": ";
+        topo.PrintToTerminal(Debug::DebugTerminal);
+    }
+
+    ASSERT(found == count, "%us CPUs have a topology instead of %us.", found, count);
+}
+
+#endif
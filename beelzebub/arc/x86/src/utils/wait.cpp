@@ -38,29 +38,52 @@
 */
 
 #include <utils/wait.hpp>
-#include <system/timers/pit.hpp>
+#include <system/timers/apic_timer.hpp>
+#include <execution/scheduler.hpp>
+#include <system/interrupts.hpp>
 #include <system/cpu_instructions.hpp>
-#include <math.h>
+#include <system/cpu.hpp>
 
 using namespace Beelzebub;
+using namespace Beelzebub::Execution;
 using namespace Beelzebub::System;
 using namespace Beelzebub::System::Timers;
 using namespace Beelzebub::Utils;
 
+/**
+ *  Halts until the deadline passes or any interrupt arrives.
+ */
+static void HaltUntil(uint64_t const deadline)
+{
+    Interrupts::Disable();
+
+    ApicTimer::Arm(deadline);
+
+    if (CpuInstructions::Rdtsc() < deadline)
+        CpuInstructions::EnableInterruptsAndHalt();
+    else
+        Interrupts::Enable();
+    //  The timer cannot fire between arming and halting.
+}
+
 void Utils::Wait(uint64_t const microseconds)
 {
-    size_t difference = RoundUp(microseconds, 1000) / 1000;
-    //  Round up to the length of a timer tick in microseconds, then get the
-    //  number of ticks.
+    if (Scheduler::IsActive() && Interrupts::AreEnabled()
+        && Cpu::GetThread()->Priority != ThreadPriority::Idle)
+    {
+        Scheduler::Sleep(microseconds * 1000);
+
+        return;
+    }
+    //  Idle threads cannot block, because they are what runs otherwise. Code
+    //  which disabled interrupts keeps the CPU as well.
 
-    size_t volatile counterStart = Pit::Counter;
+    uint64_t const deadline = ApicTimer::GetDeadline(microseconds);
 
     withInterrupts (true)
-        do
-        {
-            CpuInstructions::Halt();
-        } while (Pit::Counter.Load() - counterStart < difference);
-        //  Yes, the CPU can be halted currently, because only the BSP uses these.
+        while (CpuInstructions::Rdtsc() < deadline)
+            HaltUntil(deadline);
+        //  Any CPU can wait, because each has its own timer.
 }
 
 bool Utils::Wait(uint64_t const microseconds, PredicateFunction0 const pred)
@@ -69,20 +92,16 @@ bool Utils::Wait(uint64_t const microseconds, PredicateFunction0 const pred)
         return true;
     //  Eh, just checkin'?
 
-    size_t difference = RoundUp(microseconds, 1000) / 1000;
-    //  Round up to the length of a timer tick in microseconds, then get the
-    //  number of ticks.
-
-    size_t volatile counterStart = Pit::Counter;
+    uint64_t const deadline = ApicTimer::GetDeadline(microseconds);
 
     withInterrupts (true)
-        do
+        while (CpuInstructions::Rdtsc() < deadline)
         {
-            CpuInstructions::Halt();
+            HaltUntil(deadline);
 
             if (pred())
                 return true;
-        } while (Pit::Counter.Load() - counterStart < difference);
+        }
 
     return pred();
 }
@@ -46,6 +46,22 @@ namespace Beelzebub { namespace Execution
 {
     typedef void * (*ThreadEntryPointFunction)(void * const arg);
 
+    struct RunQueue;
+
+    /**
+     *  Scheduling priority of a thread. Lower values take precedence.
+     */
+    enum class ThreadPriority : uint8_t
+    {
+        RealTime = 0,
+        High     = 1,
+        Normal   = 2,
+        Low      = 3,
+        Idle     = 4,   //  Only run when nothing else can.
+    };
+
+    static size_t const ThreadPriorityCount = 5;
+
     /**
      *  A unit of execution.
      */
@@ -62,8 +78,16 @@ namespace Beelzebub { namespace Execution
             , KernelStackPointer()
             , State()
             , ExtendedState(nullptr)
-            , Previous(nullptr)
-            , Next(nullptr)
+            , Running(false)
+            , Blocked(false)
+#ifdef __BEELZEBUB_SETTINGS_KERNEL_PREEMPTION
+            , PreemptCount(0)
+#endif
+            , Priority(ThreadPriority::Normal)
+            , Pinned(false)
+            , Queue(nullptr)
+            , RunNext(nullptr)
+            , WaitNext(nullptr)
             , EntryPoint()
         {
 
@@ -79,8 +103,16 @@ namespace Beelzebub { namespace Execution
             , KernelStackPointer()
             , State()
             , ExtendedState(nullptr)
-            , Previous(nullptr)
-            , Next(nullptr)
+            , Running(false)
+            , Blocked(false)
+#ifdef __BEELZEBUB_SETTINGS_KERNEL_PREEMPTION
+            , PreemptCount(0)
+#endif
+            , Priority(ThreadPriority::Normal)
+            , Pinned(false)
+            , Queue(nullptr)
+            , RunNext(nullptr)
+            , WaitNext(nullptr)
             , EntryPoint()
         {
 
@@ -89,7 +121,6 @@ namespace Beelzebub { namespace Execution
         /*  Operations  */
 
         __hot Handle SwitchTo(Thread * const other, ThreadState * const dest);    //  Implemented in architecture-specific code.
-        Handle SwitchToNext(ThreadState * const dest) { return this->SwitchTo(this->Next, dest); }
 
         /*  Properties  */
 
@@ -107,14 +138,22 @@ namespace Beelzebub { namespace Execution
         ThreadState State;
         void * ExtendedState;
 
-        /*  Linkage  */
+        bool volatile Running;  //  Active on a CPU right now.
+        bool volatile Blocked;  //  Waiting to be woken up; not in any run queue.
+
+#ifdef __BEELZEBUB_SETTINGS_KERNEL_PREEMPTION
+        size_t PreemptCount;    //  Saved while the thread is switched out.
+#endif
+
+        /*  Scheduling  */
 
-        Thread * Previous;
-        Thread * Next;
+        ThreadPriority Priority;
+        bool Pinned;        //  Never taken by another CPU.
 
-        Handle IntroduceNext(Thread * const other);
+        RunQueue * Queue;   //  That of the CPU which runs the thread.
+        Thread * RunNext;   //  Used by run queues.
 
-        //  TODO: Eventually implement a proper scheduler and drop the linkage system.
+        Thread * WaitNext;  //  Used by wait queues.
 
         /*  Parameters  */
 
@@ -50,6 +50,7 @@ namespace Beelzebub
     {
           PageFaultStackSize = 1 * PageSize,
         DoubleFaultStackSize = 1 * PageSize,
+                NmiStackSize = 1 * PageSize,
                 CpuStackSize = 3 * PageSize,
     };
 
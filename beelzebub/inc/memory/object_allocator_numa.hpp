@@ -0,0 +1,143 @@
+/*
+    Copyright (c) 2015 Alexandru-Mihai Maftei. All rights reserved.
+
+
+    Developed by: Alexandru-Mihai Maftei
+    aka Vercas
+    http://vercas.com | https://github.com/vercas/Beelzebub
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal with the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+      * Redistributions of source code must retain the above copyright notice,
+        this list of conditions and the following disclaimers.
+      * Redistributions in binary form must reproduce the above copyright
+        notice, this list of conditions and the following disclaimers in the
+        documentation and/or other materials provided with the distribution.
+      * Neither the names of Alexandru-Mihai Maftei, Vercas, nor the names of
+        its contributors may be used to endorse or promote products derived from
+        this Software without specific prior written permission.
+
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+    WITH THE SOFTWARE.
+
+    ---
+
+    You may also find the text of this license in "LICENSE.md", along with a more
+    thorough explanation regarding other files.
+*/
+
+#pragma once
+
+#include <memory/object_allocator_smp.hpp>
+#include <synchronization/atomic.hpp>
+
+namespace Beelzebub { namespace Memory
+{
+    /**
+     *  <summary>
+     *  Manages pools of fixed-size objects with one pool chain per domain.
+     *  </summary>
+     *  <remarks>
+     *  Objects are allocated from the chain of the calling CPU's domain, so
+     *  new pools are made of pages given by that domain's physical allocator.
+     *  Objects are always returned to the chain they were allocated from,
+     *  regardless of the CPU which frees them. Every object carries the index
+     *  of its home domain in a byte right past its end, so the owning chain is
+     *  found without searching.
+     *  </remarks>
+     */
+    class ObjectAllocatorNuma
+    {
+    public:
+        /*  Constants  */
+
+        static size_t const MaximumDomainCount = 8;
+
+        /*  Constructors  */
+
+        inline ObjectAllocatorNuma()
+            : ObjectSize(0)
+            , Quota(0)
+            , BusyCount(0)
+            , PeakBusyCount(0)
+            , Chains()
+        {
+
+        }
+
+        ObjectAllocatorNuma(ObjectAllocatorNuma const &) = delete;
+        ObjectAllocatorNuma & operator =(ObjectAllocatorNuma const &) = delete;
+
+        ObjectAllocatorNuma(size_t const objectSize, size_t const objectAlignment
+            , AcquirePoolFunc acquirer, EnlargePoolFunc enlarger, ReleasePoolFunc releaser
+            , PoolReleaseOptions const releaseOptions = PoolReleaseOptions::ReleaseAll
+            , size_t const busyBit = SIZE_MAX, size_t const quota = SIZE_MAX);
+        //  The quota applies to all domains together.
+
+        /*  Methods  */
+
+        template<typename T>
+        inline Handle AllocateObject(T * & result, size_t estimatedLeft = 1)
+        {
+            if (sizeof(T) > this->ObjectSize)
+                return HandleResult::ArgumentTemplateInvalid;
+
+            void * pRes;
+
+            Handle hRes = this->AllocateObject(pRes, estimatedLeft);
+
+            result = (T *)pRes;
+
+            return hRes;
+        }
+
+        __hot Handle AllocateObject(void * & result, size_t estimatedLeft = 1);
+        __hot Handle DeallocateObject(void * const object);
+
+        /// <summary>Disposes of the pool chains of all domains.</summary>
+        __cold void Dispose();
+
+        /// <summary>Releases the empty pools of all domains.</summary>
+        __cold size_t Shrink();
+
+        /*  Properties  */
+
+        inline size_t GetObjectSize() const { return this->ObjectSize; }
+
+        size_t GetCapacity() const;
+        size_t GetFreeCount() const;
+        inline size_t GetBusyCount() const { return this->BusyCount.Load(); }
+
+        /// <summary>Sums up the statistics of all chains; the name is left untouched.</summary>
+        void GetStatistics(ObjectAllocatorStatistics & stats) const;
+
+        inline ObjectAllocatorSmp & GetChain(size_t const domain)
+        {
+            return this->Chains[domain];
+        }
+
+    private:
+        /*  Accounting  */
+
+        size_t ObjectSize;  //  Excludes the domain tag.
+        size_t Quota;
+
+        Synchronization::Atomic<size_t> BusyCount;
+        Synchronization::Atomic<size_t> PeakBusyCount;
+
+        /*  Chains  */
+
+        ObjectAllocatorSmp Chains[MaximumDomainCount];
+    };
+}}
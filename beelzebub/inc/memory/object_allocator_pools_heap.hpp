@@ -48,6 +48,16 @@ namespace Beelzebub { namespace Memory
                                  , size_t minimumObjects
                                  , ObjectPoolBase * & result);
 
+    /**
+     *  Same as `AcquirePoolInKernelHeap`, but the pool is not coloured, so its
+     *  first object follows the header directly.
+     *  Only meant for measuring the effect of colouring.
+     */
+    Handle AcquireUncolouredPoolInKernelHeap(size_t objectSize
+                                           , size_t headerSize
+                                           , size_t minimumObjects
+                                           , ObjectPoolBase * & result);
+
     Handle EnlargePoolInKernelHeap(size_t objectSize
                                  , size_t headerSize
                                  , size_t minimumExtraObjects
@@ -0,0 +1,120 @@
+/*
+    Copyright (c) 2015 Alexandru-Mihai Maftei. All rights reserved.
+
+
+    Developed by: Alexandru-Mihai Maftei
+    aka Vercas
+    http://vercas.com | https://github.com/vercas/Beelzebub
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal with the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+      * Redistributions of source code must retain the above copyright notice,
+        this list of conditions and the following disclaimers.
+      * Redistributions in binary form must reproduce the above copyright
+        notice, this list of conditions and the following disclaimers in the
+        documentation and/or other materials provided with the distribution.
+      * Neither the names of Alexandru-Mihai Maftei, Vercas, nor the names of
+        its contributors may be used to endorse or promote products derived from
+        this Software without specific prior written permission.
+
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+    WITH THE SOFTWARE.
+
+    ---
+
+    You may also find the text of this license in "LICENSE.md", along with a more
+    thorough explanation regarding other files.
+*/
+
+#pragma once
+
+#include <memory/object_allocator_pools.hpp>
+#include <terminals/base.hpp>
+
+namespace Beelzebub { namespace Memory
+{
+    /**
+     *  <summary>Keeps track of the named object allocators of the kernel.</summary>
+     */
+    class ObjectAllocatorRegistry
+    {
+    public:
+        /*  Types  */
+
+        typedef void (* CollectFunc)(void const * allocator, ObjectAllocatorStatistics & stats);
+        typedef size_t (* ShrinkFunc)(void * allocator);
+
+        /*  Constants  */
+
+        static size_t const Capacity = 64;
+
+        /*  Constructor(s)  */
+
+        ObjectAllocatorRegistry() = delete;
+        ObjectAllocatorRegistry(ObjectAllocatorRegistry const &) = delete;
+        ObjectAllocatorRegistry & operator =(ObjectAllocatorRegistry const &) = delete;
+
+        /*  (Un)registration  */
+
+        template<typename TAlloc>
+        static inline Handle Register(char const * const name, TAlloc & alloc)
+        {
+            return Register(name, &alloc, &CollectFrom<TAlloc>, &ShrinkFrom<TAlloc>);
+        }
+
+        static Handle Register(char const * const name, void * const alloc
+            , CollectFunc const collect, ShrinkFunc const shrink = nullptr);
+        static Handle Unregister(void const * const alloc);
+
+        /*  Statistics  */
+
+        static size_t GetCount();
+
+        /**
+         *  <summary>Fills in the statistics row of the allocator at the given index.</summary>
+         *  <remarks>
+         *  Indices may shift when an allocator is unregistered.
+         *  </remarks>
+         */
+        static Handle Collect(size_t const index, ObjectAllocatorStatistics & stats);
+
+        /// <summary>Writes the statistics of all registered allocators as a table.</summary>
+        static void Dump(Terminals::TerminalBase * const term);
+
+        /*  Memory Pressure  */
+
+        /**
+         *  <summary>Releases the empty pools of registered allocators.</summary>
+         *  <remarks>
+         *  Stops once at least <paramref name="bytesWanted"/> bytes were
+         *  released, and returns the number of bytes released. Releases
+         *  nothing if the registry is busy, because it never waits for a lock.
+         *  </remarks>
+         */
+        static size_t Shrink(size_t const bytesWanted);
+
+    private:
+        template<typename TAlloc>
+        static void CollectFrom(void const * const alloc, ObjectAllocatorStatistics & stats)
+        {
+            reinterpret_cast<TAlloc const *>(alloc)->GetStatistics(stats);
+        }
+
+        template<typename TAlloc>
+        static size_t ShrinkFrom(void * const alloc)
+        {
+            return reinterpret_cast<TAlloc *>(alloc)->Shrink();
+        }
+    };
+}}
@@ -49,10 +49,10 @@
     #endif
 
     #include <memory/object_allocator_pools.hpp>
-    #include <synchronization/spinlock.hpp>
+    #include <synchronization/queued_spinlock.hpp>
     #include <synchronization/atomic.hpp>
 
-    #define OBJA_LOCK_TYPE Beelzebub::Synchronization::Spinlock<>
+    #define OBJA_LOCK_TYPE Beelzebub::Synchronization::HotSpinlock<>
     #define OBJA_COOK_TYPE Beelzebub::System::int_cookie_t
 
     namespace Beelzebub { namespace Memory
@@ -39,8 +39,10 @@
 
 #pragma once
 
-#include <synchronization/spinlock_uninterruptible.hpp>
+#include <synchronization/queued_spinlock.hpp>
 #include <synchronization/atomic.hpp>
+#include <synchronization/seqlock.hpp>
+#include <memory/page_allocation_statistics.h>
 // #include <terminals/base.hpp>
 #include <beel/handles.h>
 
@@ -381,6 +383,14 @@ namespace Beelzebub { namespace Memory
                 && ((phys_start + length) <= this->AllocationEnd);
         }
 
+        /*  Statistics  */
+
+        /**
+         *  Reads the counters without contending with allocations; they are
+         *  consistent with each other.
+         */
+        void GetStatistics(PageAllocationStatistics & stats) const;
+
         /*  Miscellaneous  */
 
         __cold inline void RemapControlStructures(vaddr_t const newAddr)
@@ -410,6 +420,7 @@ namespace Beelzebub { namespace Memory
         /*  Utilitary Methods  */
 
         //  Pops a page off the stack. (stack selected based on status)
+        //  The caller must be writing the statistics.
         __hot Handle PopPage(pgind_t const ind);
 
         /*  Fields  */
@@ -419,10 +430,17 @@ namespace Beelzebub { namespace Memory
         pgind_t * Stack;
         //  El stacko de páginas libres. Lmao.
 
-        Synchronization::SpinlockUninterruptible<> Locker;
+        Synchronization::HotSpinlockUninterruptible<> Locker;
+
+        Synchronization::SeqLock StatisticsSequence;
+        //  Bumped around changes to the counters, under the locker.
 
     public:
 
+        Synchronization::Atomic<psize_t> * OwnerFreePageCount;
+        //  Free page count of the allocator this space is linked into, if any.
+        //  It is kept in step with this space's own.
+
         PageAllocationSpace * Next;
         PageAllocationSpace * Previous;
 
@@ -474,10 +492,34 @@ namespace Beelzebub { namespace Memory
 
         __hot bool TryGetPageDescriptor(paddr_t const paddr, PageDescriptor * & res);
 
+        /*  Memory Pressure  */
+
+        static psize_t const DefaultLowWatermark = 256;
+
+        //  Number of free pages below which the memory shrinkers are invoked.
+        psize_t LowWatermark;
+
+        //  Sum of the free pages of all the allocation spaces.
+        Synchronization::Atomic<psize_t> FreePageCount;
+
+        __forceinline psize_t GetFreePageCount() const
+        {
+            return this->FreePageCount.Load(Synchronization::MemoryOrder::Relaxed);
+        }
+
+        /// <summary>Sums up the statistics of all the allocation spaces.</summary>
+        void GetStatistics(PageAllocationStatistics & stats) const;
+
+        /// <summary>Whether allocating the given number of pages would drop below the low watermark.</summary>
+        __forceinline bool IsUnderPressure(psize_t const pending = 1) const
+        {
+            return this->GetFreePageCount() < this->LowWatermark + pending;
+        }
+
         /*  Synchronization  */
 
         //  Used for mutual exclusion over the linking pointers of the
-        //  allocation spaces.
+        //  allocation spaces. Readers walk the chain under RCU.
         Synchronization::SpinlockUninterruptible<> ChainLock;
 
         /*  Space Chaining  */
@@ -489,5 +531,9 @@ namespace Beelzebub { namespace Memory
         __cold void AppendAllocationSpace(PageAllocationSpace * const space);
 
         __cold void RemapLinks(vaddr_t const oldAddr, vaddr_t const newAddr);
+
+    private:
+
+        __cold void Adopt(PageAllocationSpace * const space);
     };
 }}
@@ -0,0 +1,97 @@
+/*
+    Copyright (c) 2015 Alexandru-Mihai Maftei. All rights reserved.
+
+
+    Developed by: Alexandru-Mihai Maftei
+    aka Vercas
+    http://vercas.com | https://github.com/vercas/Beelzebub
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal with the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+      * Redistributions of source code must retain the above copyright notice,
+        this list of conditions and the following disclaimers.
+      * Redistributions in binary form must reproduce the above copyright
+        notice, this list of conditions and the following disclaimers in the
+        documentation and/or other materials provided with the distribution.
+      * Neither the names of Alexandru-Mihai Maftei, Vercas, nor the names of
+        its contributors may be used to endorse or promote products derived from
+        this Software without specific prior written permission.
+
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+    WITH THE SOFTWARE.
+
+    ---
+
+    You may also find the text of this license in "LICENSE.md", along with a more
+    thorough explanation regarding other files.
+*/
+
+#pragma once
+
+#include <beel/handles.h>
+
+namespace Beelzebub { namespace Memory
+{
+    /**
+     *  <summary>
+     *  Keeps track of the callbacks which give memory back to the physical
+     *  allocators when these run low.
+     *  </summary>
+     *  <remarks>
+     *  The object allocator registry is always the first shrinker.
+     *  </remarks>
+     */
+    class Shrinkers
+    {
+    public:
+        /*  Types  */
+
+        /**
+         *  <summary>Attempts to free the given number of pages.</summary>
+         *  <remarks>
+         *  Returns the number of pages actually freed. Shrinkers may be invoked
+         *  with interrupts disabled and allocator locks held by the current
+         *  CPU, so they must never wait for a lock.
+         *  </remarks>
+         */
+        typedef size_t (* ShrinkFunc)(void * cookie, size_t pagesWanted);
+
+        /*  Constants  */
+
+        static size_t const Capacity = 16;
+
+        /*  Constructor(s)  */
+
+        Shrinkers() = delete;
+        Shrinkers(Shrinkers const &) = delete;
+        Shrinkers & operator =(Shrinkers const &) = delete;
+
+        /*  (Un)registration  */
+
+        static Handle Register(ShrinkFunc const func, void * const cookie = nullptr);
+        static Handle Unregister(ShrinkFunc const func, void * const cookie = nullptr);
+
+        /*  Operation  */
+
+        /**
+         *  <summary>Invokes the shrinkers until the given number of pages is freed.</summary>
+         *  <remarks>
+         *  Returns the number of pages freed. Only one CPU shrinks at a time;
+         *  concurrent calls return 0 immediately, and so do calls made while
+         *  the shrinkers are being (un)registered.
+         *  </remarks>
+         */
+        static size_t Shrink(size_t const pagesWanted);
+    };
+}}
@@ -44,7 +44,7 @@
 #include <utils/avl_tree.hpp>
 #include <memory/object_allocator.hpp>
 
-#include <synchronization/rw_spinlock.hpp>
+#include <synchronization/big_reader_rw_spinlock.hpp>
 #include <synchronization/atomic.hpp>
 
 namespace Beelzebub { namespace Memory
@@ -89,7 +89,7 @@ namespace Beelzebub { namespace Memory
 
         /*  Fields  */
 
-        Synchronization::RwSpinlock Lock;
+        Synchronization::BigReaderRwSpinlock Lock;
 
         ObjectAllocator Alloc;
         Utils::AvlTree<MemoryRegion> Tree;
@@ -0,0 +1,138 @@
+/*
+    Copyright (c) 2015 Alexandru-Mihai Maftei. All rights reserved.
+
+
+    Developed by: Alexandru-Mihai Maftei
+    aka Vercas
+    http://vercas.com | https://github.com/vercas/Beelzebub
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal with the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+      * Redistributions of source code must retain the above copyright notice,
+        this list of conditions and the following disclaimers.
+      * Redistributions in binary form must reproduce the above copyright
+        notice, this list of conditions and the following disclaimers in the
+        documentation and/or other materials provided with the distribution.
+      * Neither the names of Alexandru-Mihai Maftei, Vercas, nor the names of
+        its contributors may be used to endorse or promote products derived from
+        this Software without specific prior written permission.
+
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+    WITH THE SOFTWARE.
+
+    ---
+
+    You may also find the text of this license in "LICENSE.md", along with a more
+    thorough explanation regarding other files.
+*/
+
+#pragma once
+
+#include <synchronization/atomic.hpp>
+#include <system/cpu_instructions.hpp>
+
+namespace Beelzebub { namespace Synchronization
+{
+    /**
+     *  Sequence lock, for data which is read often and written rarely.
+     *  Writers bump the sequence around their updates and must be serialized
+     *  by other means (usually the lock which guards the data anyway).
+     *  Readers never write; they retry whenever a write overlapped their reads:
+     *
+     *      size_t seq;
+     *
+     *      do
+     *      {
+     *          seq = lock.BeginRead();
+     *          //  Copy the data.
+     *      } while (lock.RetryRead(seq));
+     */
+    struct SeqLock
+    {
+    public:
+
+        /*  Constructor(s)  */
+
+        inline constexpr SeqLock() : Sequence(0) { }
+
+        SeqLock(SeqLock const &) = delete;
+        SeqLock & operator =(SeqLock const &) = delete;
+
+        /*  Writing  */
+
+        /**
+         *  Marks the beginning of an update; the sequence becomes odd.
+         */
+        __forceinline void BeginWrite() volatile
+        {
+            this->Sequence.Store(this->Sequence.Load(MemoryOrder::Relaxed) + 1, MemoryOrder::Relaxed);
+
+            COMPILER_MEMORY_BARRIER();
+            //  x86 does not reorder stores with older stores.
+        }
+
+        /**
+         *  Marks the end of an update; the sequence becomes even.
+         */
+        __forceinline void EndWrite() volatile
+        {
+            COMPILER_MEMORY_BARRIER();
+
+            this->Sequence.Store(this->Sequence.Load(MemoryOrder::Relaxed) + 1, MemoryOrder::Release);
+        }
+
+        /*  Reading  */
+
+        /**
+         *  Awaits the end of an update in progress and returns the sequence
+         *  number to check the reads against.
+         */
+        __forceinline size_t BeginRead() const volatile
+        {
+            size_t seq;
+
+            while ((seq = this->Sequence.Load(MemoryOrder::Acquire)) & 1)
+                System::CpuInstructions::DoNothing();
+
+            COMPILER_MEMORY_BARRIER();
+
+            return seq;
+        }
+
+        /**
+         *  Checks whether the data read since the given sequence number may be
+         *  torn, in which case it must be read again.
+         */
+        __forceinline __must_check bool RetryRead(size_t const seq) const volatile
+        {
+            COMPILER_MEMORY_BARRIER();
+            //  x86 does not reorder loads with other loads.
+
+            return this->Sequence.Load(MemoryOrder::Acquire) != seq;
+        }
+
+        /*  Properties  */
+
+        __forceinline size_t GetSequence() const volatile
+        {
+            return this->Sequence.Load();
+        }
+
+    private:
+
+        /*  Fields  */
+
+        Atomic<size_t> Sequence;
+    };
+}}
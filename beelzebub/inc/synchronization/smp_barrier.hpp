@@ -42,6 +42,7 @@
 #include <synchronization/atomic.hpp>
 #include <system/cpu.hpp>
 #include <system/cpu_instructions.hpp>
+#include <debug.hpp>
 
 namespace Beelzebub { namespace Synchronization
 {
@@ -65,92 +66,111 @@ namespace Beelzebub { namespace Synchronization
          *  Resets the barrier, so it will open when the specified number
          *  of cores reach it.
          */
-        __forceinline void Reset(size_t const coreCount = 1) volatile
-        {
-            this->Value = 1;
-        }
+        __forceinline void Reset(size_t const) volatile { }
 
         /**
          *  Reach the barrier, awaiting for other cores if necessary.
          */
         __forceinline void Reach() volatile
         {
-            this->Value = 0;
+            COMPILER_MEMORY_BARRIER();
         }
 
-        /*  Properties  */
+#else
+
+        /*  Constants  */
+
+        static size_t const ArrivalFanIn = 4;
+
+        /*  Operations  */
 
         /**
-         *  Checks whether the spinlock is free or not.
+         *  Resets the barrier, so it will open every time the specified number
+         *  of cores reach it. Those must be the cores with the lowest indexes,
+         *  and none of them may be inside the barrier.
+         *  Nodes are allocated on the kernel heap when the barrier does not
+         *  have enough for the given participants.
          */
-        __forceinline __must_check bool IsOpen() const volatile
-        {
-            return this->Value == (size_t)0;
-        }
+        __cold void Reset(size_t const participants) volatile;
 
-        __forceinline size_t GetValue() const volatile
+        /**
+         *  Reach the barrier, awaiting for all other cores.
+         *  The barrier opens every time all the participants reach it, so it may be
+         *  reached any number of times without being reset.
+         */
+        inline void Reach() volatile
         {
-            return this->Value;
-        }
+            size_t const count = this->Participants;
+            size_t const index = System::Cpu::GetData()->Index;
 
-        /*  Fields  */
+            ASSERT(index < count, "Core %us cannot reach a barrier of %us cores."
+                , index, count);
+            //  Also catches barriers which were never reset.
 
-    private:
+            Node volatile & node = this->Nodes[index];
+            bool const sense = !node.Sense;
+            //  Every arrival flips the bit of its core in the parent's mask.
 
-        size_t volatile Value;
+            uint32_t const expected = sense ? GetChildMask(index, count) : 0;
 
-#else
+            while (__atomic_load_n(&(node.Arrived), __ATOMIC_ACQUIRE) != expected)
+                System::CpuInstructions::DoNothing();
+            //  Wait for the subtree to arrive.
 
-        /*  Operations  */
+            if (index != 0)
+            {
+                size_t const parent = (index - 1) / ArrivalFanIn;
 
-        /**
-         *  Resets the barrier, so it will open when all cores reach it.
-         */
-        __forceinline void Reset() volatile
-        {
-            this->Value.Store(System::Cpu::Count);
-        }
+                __atomic_fetch_xor(&(this->Nodes[parent].Arrived)
+                    , 1U << ((index - 1) % ArrivalFanIn), __ATOMIC_ACQ_REL);
 
-        /**
-         *  Resets the barrier, so it will open when the specified number
-         *  of cores reach it.
-         */
-        __forceinline void Reset(size_t const coreCount) volatile
-        {
-            this->Value.Store(coreCount);
-        }
+                while (__atomic_load_n(&(node.WakeSense), __ATOMIC_ACQUIRE) != sense)
+                    System::CpuInstructions::DoNothing();
+                //  Only the root learns of the barrier opening on its own.
+            }
 
-        /**
-         *  Reach the barrier, awaiting for other cores if necessary.
-         */
-        inline void Reach() volatile
-        {
-            --this->Value;
+            for (size_t child = 2 * index + 1; child <= 2 * index + 2 && child < count; ++child)
+                __atomic_store_n(&(this->Nodes[child].WakeSense), sense, __ATOMIC_RELEASE);
+            //  Wakeup goes down a binary tree, which is shallower in latency
+            //  than the arrival tree is in stores.
 
-            while (this->Value)
-            	System::CpuInstructions::DoNothing();
+            node.Sense = sense;
         }
 
-        /*  Properties  */
+    private:
+
+        /*  Types  */
 
         /**
-         *  Checks whether the spinlock is free or not.
+         *  State of a core, which only spins on its own cache line.
          */
-        __forceinline __must_check bool IsOpen() const volatile
+        struct Node
         {
-            return this->Value == (size_t)0;
-        }
+            uint32_t Arrived;   //  Bits of the children, flipped on arrival.
+            bool WakeSense;     //  Set by the parent when the barrier opens.
+            bool Sense;         //  Only touched by the owner.
+        } __aligned(CacheLineSize);
+
+        /*  Utilities  */
 
-        __forceinline size_t GetValue() const volatile
+        static __forceinline uint32_t GetChildMask(size_t const index, size_t const count)
         {
-            return this->Value.Load();
+            size_t const first = ArrivalFanIn * index + 1;
+
+            if (first >= count)
+                return 0;
+
+            size_t const children = count - first;
+
+            return (1U << (children < ArrivalFanIn ? children : ArrivalFanIn)) - 1;
         }
 
         /*  Fields  */
 
-    private:
-
-        Atomic<size_t> volatile Value; 
+        size_t Participants;
+        size_t NodeCapacity;
+        Node * Nodes;
+        //  One for every participant, allocated by `Reset`.
 #endif
 	};
 }}
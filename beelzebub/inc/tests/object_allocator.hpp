@@ -42,8 +42,6 @@
 #include <synchronization/smp_barrier.hpp>
 #include <beel/handles.h>
 
-extern Beelzebub::Synchronization::SmpBarrier ObjectAllocatorTestBarrier1;
-extern Beelzebub::Synchronization::SmpBarrier ObjectAllocatorTestBarrier2;
-extern Beelzebub::Synchronization::SmpBarrier ObjectAllocatorTestBarrier3;
+extern Beelzebub::Synchronization::SmpBarrier ObjectAllocatorTestBarrier;
 
 __startup Beelzebub::Handle TestObjectAllocator(bool const bsp);
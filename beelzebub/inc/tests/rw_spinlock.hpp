@@ -41,8 +41,6 @@
 
 #include <synchronization/smp_barrier.hpp>
 
-extern Beelzebub::Synchronization::SmpBarrier RwSpinlockTestBarrier1;
-extern Beelzebub::Synchronization::SmpBarrier RwSpinlockTestBarrier2;
-extern Beelzebub::Synchronization::SmpBarrier RwSpinlockTestBarrier3;
+extern Beelzebub::Synchronization::SmpBarrier RwSpinlockTestBarrier;
 
 __startup void TestRwSpinlock(bool bsp);
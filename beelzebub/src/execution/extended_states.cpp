@@ -38,15 +38,16 @@
 */
 
 #include <execution/extended_states.hpp>
-#include <memory/object_allocator_smp.hpp>
+#include <memory/object_allocator_numa.hpp>
 #include <memory/object_allocator_pools_heap.hpp>
+#include <memory/object_allocator_registry.hpp>
 #include <string.h>
 
 using namespace Beelzebub;
 using namespace Beelzebub::Execution;
 using namespace Beelzebub::Memory;
 
-ObjectAllocatorSmp ExtendedStatesAllocator;
+ObjectAllocatorNuma ExtendedStatesAllocator;
 
 void * templateState = nullptr;
 
@@ -75,9 +76,11 @@ Handle ExtendedStates::Initialize(size_t const size, size_t const alignment)
     }
     else
     {
-        new (&ExtendedStatesAllocator) ObjectAllocatorSmp(size, alignment
+        new (&ExtendedStatesAllocator) ObjectAllocatorNuma(size, alignment
             , &AcquirePoolInKernelHeap, &EnlargePoolInKernelHeap, &ReleasePoolFromKernelHeap);
 
+        ObjectAllocatorRegistry::Register("Extended States", ExtendedStatesAllocator);
+
         ExtendedStates::Initialized = true;
 
         return HandleResult::Okay;
@@ -98,7 +101,7 @@ Handle ExtendedStates::AllocateTemplate(void * & state)
 
     templateState = state;
 
-    memset(state, 0, ExtendedStatesAllocator.ObjectSize);
+    memset(state, 0, ExtendedStatesAllocator.GetObjectSize());
     //  Clear all the bits, for the cheap (f)xsave implementations that just
     //  leave the reserved bits/bytes/whatever unchanged.
 
@@ -113,7 +116,7 @@ Handle ExtendedStates::AllocateNew(void * & state)
         return res;
 
     if (templateState != nullptr)
-        memcpy(state, templateState, ExtendedStatesAllocator.ObjectSize);
+        memcpy(state, templateState, ExtendedStatesAllocator.GetObjectSize());
 
     return HandleResult::Okay;
 }
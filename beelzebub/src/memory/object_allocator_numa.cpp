@@ -0,0 +1,203 @@
+/*
+    Copyright (c) 2015 Alexandru-Mihai Maftei. All rights reserved.
+
+
+    Developed by: Alexandru-Mihai Maftei
+    aka Vercas
+    http://vercas.com | https://github.com/vercas/Beelzebub
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal with the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+      * Redistributions of source code must retain the above copyright notice,
+        this list of conditions and the following disclaimers.
+      * Redistributions in binary form must reproduce the above copyright
+        notice, this list of conditions and the following disclaimers in the
+        documentation and/or other materials provided with the distribution.
+      * Neither the names of Alexandru-Mihai Maftei, Vercas, nor the names of
+        its contributors may be used to endorse or promote products derived from
+        this Software without specific prior written permission.
+
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+    WITH THE SOFTWARE.
+
+    ---
+
+    You may also find the text of this license in "LICENSE.md", along with a more
+    thorough explanation regarding other files.
+*/
+
+#include <memory/object_allocator_numa.hpp>
+#include <system/cpu.hpp>
+#include <kernel.hpp>
+
+#include <debug.hpp>
+
+using namespace Beelzebub;
+using namespace Beelzebub::Memory;
+using namespace Beelzebub::System;
+
+static __forceinline size_t GetLocalDomainIndex()
+{
+    if unlikely(!CpuDataSetUp)
+        return Domain0.Index;
+
+    size_t const index = Cpu::GetData()->DomainDescriptor->Index;
+
+    assert(index < ObjectAllocatorNuma::MaximumDomainCount
+        , "Domain index %us exceeds the maximum supported by NUMA object "
+          "allocators (%us).%n"
+        , index, ObjectAllocatorNuma::MaximumDomainCount);
+
+    return index;
+}
+
+/*******************************
+    ObjectAllocatorNuma class
+*******************************/
+
+/*  Constructors  */
+
+ObjectAllocatorNuma::ObjectAllocatorNuma(size_t const objectSize, size_t const objectAlignment
+    , AcquirePoolFunc acquirer, EnlargePoolFunc enlarger, ReleasePoolFunc releaser
+    , PoolReleaseOptions const releaseOptions, size_t const busyBit, size_t const quota)
+    : ObjectSize(objectSize)
+    , Quota(quota)
+    , BusyCount(0)
+    , PeakBusyCount(0)
+    , Chains()
+{
+    for (size_t i = 0; i < MaximumDomainCount; ++i)
+        new (this->Chains + i) ObjectAllocatorSmp(objectSize + sizeof(uint8_t), objectAlignment
+            , acquirer, enlarger, releaser, releaseOptions, busyBit, SIZE_MAX);
+    //  The chains do not acquire any pools until they are first used, so
+    //  domains which do not exist cost nothing but the size of a chain head.
+    //  The quota is enforced here, across all of them.
+}
+
+/*  Methods  */
+
+Handle ObjectAllocatorNuma::AllocateObject(void * & result, size_t estimatedLeft)
+{
+    size_t const busyCount = ++this->BusyCount;
+
+    if (busyCount > this->Quota)
+    {
+        --this->BusyCount;
+
+        return HandleResult::ObjaMaximumCapacity;
+    }
+
+    size_t const domain = GetLocalDomainIndex();
+
+    Handle res = this->Chains[domain].AllocateObject(result, estimatedLeft);
+    //  Pools are acquired and enlarged on the calling CPU, which will take the
+    //  physical pages from its own domain's allocator.
+
+    if unlikely(!res.IsOkayResult())
+    {
+        --this->BusyCount;
+
+        return res;
+    }
+
+    reinterpret_cast<uint8_t *>(result)[this->ObjectSize] = (uint8_t)domain;
+
+    size_t peak = this->PeakBusyCount.Load();
+
+    while (busyCount > peak && !this->PeakBusyCount.CmpXchgWeak(peak, busyCount))
+        ;   //  `peak` is refreshed by every failed exchange.
+
+    return HandleResult::Okay;
+}
+
+Handle ObjectAllocatorNuma::DeallocateObject(void * const object)
+{
+    size_t const domain = reinterpret_cast<uint8_t const *>(object)[this->ObjectSize];
+
+    if unlikely(domain >= MaximumDomainCount)
+        return HandleResult::ArgumentOutOfRange;
+    //  Certainly not an object of this allocator.
+
+    Handle res = this->Chains[domain].DeallocateObject(object);
+
+    if likely(res.IsOkayResult())
+        --this->BusyCount;
+
+    return res;
+}
+
+void ObjectAllocatorNuma::Dispose()
+{
+    for (size_t i = 0; i < MaximumDomainCount; ++i)
+        this->Chains[i].Dispose();
+}
+
+size_t ObjectAllocatorNuma::Shrink()
+{
+    size_t released = 0;
+
+    for (size_t i = 0; i < MaximumDomainCount; ++i)
+        released += this->Chains[i].Shrink();
+
+    return released;
+}
+
+/*  Properties  */
+
+size_t ObjectAllocatorNuma::GetCapacity() const
+{
+    size_t sum = 0;
+
+    for (size_t i = 0; i < MaximumDomainCount; ++i)
+        sum += this->Chains[i].GetCapacity();
+
+    return sum;
+}
+
+size_t ObjectAllocatorNuma::GetFreeCount() const
+{
+    size_t sum = 0;
+
+    for (size_t i = 0; i < MaximumDomainCount; ++i)
+        sum += this->Chains[i].GetFreeCount();
+
+    return sum;
+}
+
+void ObjectAllocatorNuma::GetStatistics(ObjectAllocatorStatistics & stats) const
+{
+    this->Chains[0].GetStatistics(stats);
+
+    for (size_t i = 1; i < MaximumDomainCount; ++i)
+    {
+        ObjectAllocatorStatistics chain;
+
+        this->Chains[i].GetStatistics(chain);
+
+        stats.Capacity              += chain.Capacity;
+        stats.FreeCount             += chain.FreeCount;
+        stats.PoolCount             += chain.PoolCount;
+        stats.Allocations           += chain.Allocations;
+        stats.Deallocations         += chain.Deallocations;
+        stats.PoolAcquisitions      += chain.PoolAcquisitions;
+        stats.PoolReleases          += chain.PoolReleases;
+        stats.LinkageSpinCycles     += chain.LinkageSpinCycles;
+        stats.PropertiesSpinCycles  += chain.PropertiesSpinCycles;
+    }
+
+    stats.ObjectSize    = this->ObjectSize;
+    stats.BusyCount     = this->BusyCount.Load();
+    stats.PeakBusyCount = this->PeakBusyCount.Load();
+    //  The chains only see the objects of their own domain.
+}
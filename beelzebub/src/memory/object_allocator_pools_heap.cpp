@@ -39,6 +39,7 @@
 
 #include <memory/object_allocator_pools_heap.hpp>
 #include <memory/vmm.hpp>
+#include <synchronization/atomic.hpp>
 #include <system/cpu.hpp>
 #include <kernel.hpp>
 #include <entry.h>
@@ -48,8 +49,13 @@
 
 using namespace Beelzebub;
 using namespace Beelzebub::Memory;
+using namespace Beelzebub::Synchronization;
 using namespace Beelzebub::System;
 
+static Atomic<size_t> NextPoolColour {0};
+//  Rotates the offset of the first object in every new pool, so objects with
+//  the same index in different pools do not all compete for the same cache sets.
+
 static __noinline Handle GetKernelHeapPages(size_t const pageCount, uintptr_t & address)
 {
     Handle res;
@@ -102,14 +108,28 @@ static __noinline Handle GetKernelHeapPages(size_t const pageCount, uintptr_t &
 static __noinline void FillPool(ObjectPoolBase volatile * volatile pool
                               , size_t const objectSize
                               , size_t const headerSize
-                              , obj_ind_t const objectCount)
+                              , size_t const poolSize
+                              , bool const colour)
 {
+    size_t const usable = poolSize - headerSize;
+    obj_ind_t const objectCount = (obj_ind_t)(usable / objectSize);
+    //  TODO: Get rid of this division and make the loop below stop when the
+    //  cursor reaches the end of the page(s).
+
+    size_t const colours = (usable - objectCount * objectSize) / CacheLineSize + 1;
+    //  The slack at the end of the pool decides how many colours fit. There is
+    //  always at least one: no offset.
+
+    if (colour)
+        pool->ColourOffset = (obj_ind_t)((NextPoolColour++ % colours) * CacheLineSize);
+    else
+        pool->ColourOffset = 0;
     pool->Capacity = objectCount;
     pool->FreeCount = objectCount;
 
     COMPILER_MEMORY_BARRIER();
 
-    uintptr_t cursor = (uintptr_t)pool + headerSize;
+    uintptr_t cursor = (uintptr_t)pool + headerSize + pool->ColourOffset;
     FreeObject * last = nullptr;
 
     for (obj_ind_t i = 0; i < objectCount; ++i, cursor += objectSize)
@@ -138,10 +158,11 @@ static __noinline void FillPool(ObjectPoolBase volatile * volatile pool
     COMPILER_MEMORY_BARRIER();
 }
 
-Handle Memory::AcquirePoolInKernelHeap(size_t objectSize
-                                     , size_t headerSize
-                                     , size_t minimumObjects
-                                     , ObjectPoolBase * & result)
+static Handle AcquirePool(size_t const objectSize
+                         , size_t const headerSize
+                         , size_t const minimumObjects
+                         , ObjectPoolBase * & result
+                         , bool const colour)
 {
     assert(headerSize >= sizeof(ObjectPoolBase)
         , "The given header size (%us) apprats to be lower than the size of an "
@@ -162,11 +183,7 @@ Handle Memory::AcquirePoolInKernelHeap(size_t objectSize
     new (const_cast<ObjectPoolBase *>(pool)) ObjectPoolBase();
     //  Construct in place to initialize the fields.
 
-    size_t const objectCount = ((pageCount * PageSize) - headerSize) / objectSize;
-    //  TODO: Get rid of this division and make the loop below stop when the
-    //  cursor reaches the end of the page(s).
-
-    FillPool(pool, objectSize, headerSize, (obj_ind_t)objectCount);
+    FillPool(pool, objectSize, headerSize, pageCount * PageSize, colour);
 
     //  The pool was constructed in place, so the rest of the fields should
     //  be in a good state.
@@ -176,13 +193,32 @@ Handle Memory::AcquirePoolInKernelHeap(size_t objectSize
     return HandleResult::Okay;
 }
 
+Handle Memory::AcquirePoolInKernelHeap(size_t objectSize
+                                     , size_t headerSize
+                                     , size_t minimumObjects
+                                     , ObjectPoolBase * & result)
+{
+    return AcquirePool(objectSize, headerSize, minimumObjects, result, true);
+}
+
+Handle Memory::AcquireUncolouredPoolInKernelHeap(size_t objectSize
+                                               , size_t headerSize
+                                               , size_t minimumObjects
+                                               , ObjectPoolBase * & result)
+{
+    return AcquirePool(objectSize, headerSize, minimumObjects, result, false);
+}
+
 Handle Memory::EnlargePoolInKernelHeap(size_t objectSize
                                      , size_t headerSize
                                      , size_t minimumExtraObjects
                                      , ObjectPoolBase * pool)
 {
-    size_t const oldPageCount = RoundUp(objectSize * pool->Capacity + headerSize, PageSize) / PageSize;
-    size_t newPageCount = RoundUp(objectSize * (pool->Capacity + minimumExtraObjects) + headerSize, PageSize) / PageSize;
+    size_t const objectsOffset = headerSize + pool->ColourOffset;
+    //  The colour of a pool does not change when it is enlarged.
+
+    size_t const oldPageCount = RoundUp(objectSize * pool->Capacity + objectsOffset, PageSize) / PageSize;
+    size_t newPageCount = RoundUp(objectSize * (pool->Capacity + minimumExtraObjects) + objectsOffset, PageSize) / PageSize;
 
     ASSERT(newPageCount > oldPageCount
         , "New page count (%us) should be larger than the old page count (%us) "
@@ -258,9 +294,9 @@ Handle Memory::EnlargePoolInKernelHeap(size_t objectSize
     //  Nothing was allocated.
 
     obj_ind_t const oldObjectCount = pool->Capacity;
-    obj_ind_t const newObjectCount = ((curPageCount * PageSize) - headerSize) / objectSize;
+    obj_ind_t const newObjectCount = ((curPageCount * PageSize) - objectsOffset) / objectSize;
 
-    uintptr_t cursor = (uintptr_t)pool + headerSize + oldObjectCount * objectSize;
+    uintptr_t cursor = (uintptr_t)pool + objectsOffset + oldObjectCount * objectSize;
     FreeObject * last = nullptr;
 
     if (pool->FreeCount > 0)
@@ -305,7 +341,7 @@ Handle Memory::ReleasePoolFromKernelHeap(size_t objectSize
     bool decrementedHeapCursor = true;
     //  Initial value is for simplifying the algorithm below.
 
-    size_t const pageCount = RoundUp(objectSize * pool->Capacity + headerSize, PageSize) / PageSize;
+    size_t const pageCount = RoundUp(objectSize * pool->Capacity + headerSize + pool->ColourOffset, PageSize) / PageSize;
 
     vaddr_t vaddr = (vaddr_t)pool + (pageCount - 1) * PageSize;
     size_t i = pageCount;
@@ -0,0 +1,174 @@
+/*
+    Copyright (c) 2015 Alexandru-Mihai Maftei. All rights reserved.
+
+
+    Developed by: Alexandru-Mihai Maftei
+    aka Vercas
+    http://vercas.com | https://github.com/vercas/Beelzebub
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal with the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+      * Redistributions of source code must retain the above copyright notice,
+        this list of conditions and the following disclaimers.
+      * Redistributions in binary form must reproduce the above copyright
+        notice, this list of conditions and the following disclaimers in the
+        documentation and/or other materials provided with the distribution.
+      * Neither the names of Alexandru-Mihai Maftei, Vercas, nor the names of
+        its contributors may be used to endorse or promote products derived from
+        this Software without specific prior written permission.
+
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+    WITH THE SOFTWARE.
+
+    ---
+
+    You may also find the text of this license in "LICENSE.md", along with a more
+    thorough explanation regarding other files.
+*/
+
+#include <memory/object_allocator_registry.hpp>
+#include <synchronization/spinlock_uninterruptible.hpp>
+#include <synchronization/lock_guard.hpp>
+#include <string.h>
+
+#include <debug.hpp>
+
+using namespace Beelzebub;
+using namespace Beelzebub::Memory;
+using namespace Beelzebub::Synchronization;
+using namespace Beelzebub::Terminals;
+
+struct RegistryEntry
+{
+    char const * Name;
+    void * Allocator;
+    ObjectAllocatorRegistry::CollectFunc Collect;
+    ObjectAllocatorRegistry::ShrinkFunc Shrink;
+};
+
+static RegistryEntry Entries[ObjectAllocatorRegistry::Capacity];
+static size_t EntryCount = 0;
+static SpinlockUninterruptible<> RegistryLock;
+//  Uninterruptible, because the registry may be dumped by an IRQ handler.
+
+static void CollectEntry(RegistryEntry const & entry, ObjectAllocatorStatistics & stats)
+{
+    entry.Collect(entry.Allocator, stats);
+
+    strncpy(stats.Name, entry.Name, OBJA_STATISTICS_NAME_LENGTH - 1);
+    stats.Name[OBJA_STATISTICS_NAME_LENGTH - 1] = 0;
+}
+
+/***********************************
+    ObjectAllocatorRegistry class
+***********************************/
+
+/*  (Un)registration  */
+
+Handle ObjectAllocatorRegistry::Register(char const * const name, void * const alloc
+    , CollectFunc const collect, ShrinkFunc const shrink)
+{
+    if unlikely(name == nullptr || alloc == nullptr || collect == nullptr)
+        return HandleResult::ArgumentNull;
+
+    withLock (RegistryLock)
+    {
+        if unlikely(EntryCount == Capacity)
+            return HandleResult::OutOfMemory;
+
+        for (size_t i = 0; i < EntryCount; ++i)
+            if unlikely(Entries[i].Allocator == alloc)
+                return HandleResult::CardinalityViolation;
+
+        Entries[EntryCount++] = { name, alloc, collect, shrink };
+    }
+
+    return HandleResult::Okay;
+}
+
+Handle ObjectAllocatorRegistry::Unregister(void const * const alloc)
+{
+    withLock (RegistryLock)
+        for (size_t i = 0; i < EntryCount; ++i)
+            if (Entries[i].Allocator == alloc)
+            {
+                Entries[i] = Entries[--EntryCount];
+                //  Order is irrelevant, so the last entry takes its place.
+
+                return HandleResult::Okay;
+            }
+
+    return HandleResult::NotFound;
+}
+
+/*  Statistics  */
+
+size_t ObjectAllocatorRegistry::GetCount()
+{
+    return EntryCount;
+}
+
+Handle ObjectAllocatorRegistry::Collect(size_t const index, ObjectAllocatorStatistics & stats)
+{
+    withLock (RegistryLock)
+    {
+        if unlikely(index >= EntryCount)
+            return HandleResult::ArgumentOutOfRange;
+
+        CollectEntry(Entries[index], stats);
+    }
+
+    return HandleResult::Okay;
+}
+
+void ObjectAllocatorRegistry::Dump(TerminalBase * const term)
+{
+    term->WriteLine("Name\t\tObjSize\tCapac.\tFree\tPools\tBusy\tPeak"
+                    "\tAllocs\tFrees\tP.Acq.\tP.Rel.\tL.Spin\tP.Spin");
+    //  Separated by tabs, because the terminal cannot pad formatted values.
+
+    ObjectAllocatorStatistics stats;
+
+    for (size_t i = 0; Collect(i, stats).IsOkayResult(); ++i)
+        term->WriteFormat("%s\t%s%us\t%us\t%us\t%us\t%us\t%us"
+                          "\t%u8\t%u8\t%u8\t%u8\t%u8\t%u8%n"
+            , stats.Name, strlen(stats.Name) < 8 ? "\t" : ""
+            , stats.ObjectSize, stats.Capacity, stats.FreeCount
+            , stats.PoolCount, stats.BusyCount, stats.PeakBusyCount
+            , stats.Allocations, stats.Deallocations
+            , stats.PoolAcquisitions, stats.PoolReleases
+            , stats.LinkageSpinCycles, stats.PropertiesSpinCycles);
+    //  The lock is not held while writing to the terminal.
+}
+
+/*  Memory Pressure  */
+
+size_t ObjectAllocatorRegistry::Shrink(size_t const bytesWanted)
+{
+    size_t released = 0;
+    SpinlockUninterruptible<>::Cookie cookie;
+
+    if (!RegistryLock.TryAcquire(cookie))
+        return 0;
+    //  This CPU may have faulted or run out of pages while holding the lock,
+    //  e.g. during a registration or a collection, so it is never awaited.
+
+    for (size_t i = 0; i < EntryCount && released < bytesWanted; ++i)
+        if (Entries[i].Shrink != nullptr)
+            released += Entries[i].Shrink(Entries[i].Allocator);
+
+    RegistryLock.Release(cookie);
+
+    return released;
+}
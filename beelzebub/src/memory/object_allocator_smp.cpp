@@ -42,7 +42,10 @@
 //  support.
 
     #include <memory/object_allocator_smp.hpp>
+    #include <system/cpu.hpp>
+    #include <system/cpu_instructions.hpp>
     #include <system/interrupts.hpp>
+    #include <kernel.hpp>
 
     #include <math.h>
     #include <debug.hpp>
@@ -50,9 +53,13 @@
     using namespace Beelzebub;
     using namespace Beelzebub::Memory;
 
-    #define OBJA_LOCK_TYPE Beelzebub::Synchronization::SpinlockUninterruptible<>
+    #define OBJA_LOCK_TYPE Beelzebub::Synchronization::HotSpinlock<>
     #define OBJA_COOK_TYPE Beelzebub::System::int_cookie_t
 
+    #define OBJA_STATISTICS_SHARD (CpuDataSetUp \
+        ? Beelzebub::System::Cpu::GetData()->Index % StatisticsShardCount : 0)
+    #define OBJA_TIMESTAMP() Beelzebub::System::CpuInstructions::Rdtsc()
+
     #define OBJA_POOL_TYPE      ObjectPoolSmp
     #define OBJA_ALOC_TYPE      ObjectAllocatorSmp
     #define OBJA_MULTICONSUMER  true
@@ -63,6 +70,8 @@
     #undef OBJA_ALOC_TYPE
     #undef OBJA_POOL_TYPE
 
+    #undef OBJA_TIMESTAMP
+
     #undef OBJA_COOK_TYPE
     #undef OBJA_LOCK_TYPE
 
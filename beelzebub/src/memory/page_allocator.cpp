@@ -38,6 +38,7 @@
 */
 
 #include <memory/page_allocator.hpp>
+#include <synchronization/rcu.hpp>
 
 #include <math.h>
 #include <debug.hpp>
@@ -91,6 +92,8 @@ PageAllocationSpace::PageAllocationSpace()
     , ReservedPageCount(0)
     , Map(nullptr)
     , Locker()
+    , StatisticsSequence()
+    , OwnerFreePageCount(nullptr)
 
     //  Links
     , Next(nullptr)
@@ -116,6 +119,8 @@ PageAllocationSpace::PageAllocationSpace(const paddr_t phys_start, const paddr_t
     , ReservedPageCount(0)
     , Map((PageDescriptor *)phys_start)
     , Locker()
+    , StatisticsSequence()
+    , OwnerFreePageCount(nullptr)
 
     //  Links
     , Next(nullptr)
@@ -214,8 +219,15 @@ Handle PageAllocationSpace::ReservePageRange(const pgind_t start, const psize_t
 
             withLock (this->Locker)
             {
+                this->StatisticsSequence.BeginWrite();
+
                 this->PopPage(start + i);
 
+                ++this->ReservedPageCount;
+                this->ReservedSize += this->PageSize;
+
+                this->StatisticsSequence.EndWrite();
+
                 page->Reserve();
             }
         }
@@ -223,7 +235,16 @@ Handle PageAllocationSpace::ReservePageRange(const pgind_t start, const psize_t
         {
             if (inclInUse)
                 withLock (this->Locker)
+                {
+                    this->StatisticsSequence.BeginWrite();
+
+                    ++this->ReservedPageCount;
+                    this->ReservedSize += this->PageSize;
+
+                    this->StatisticsSequence.EndWrite();
+
                     page->Reserve();
+                }
             else
                 return HandleResult::PageInUse;
 
@@ -235,12 +256,6 @@ Handle PageAllocationSpace::ReservePageRange(const pgind_t start, const psize_t
             return HandleResult::PageReserved;
     }
 
-    this->FreePageCount -= count;
-    this->ReservedPageCount += count;
-
-    this->FreeSize = this->FreePageCount * this->PageSize;
-    this->ReservedSize = this->ReservedPageCount * this->PageSize;
-
     return HandleResult::Okay;
 }
 
@@ -262,6 +277,16 @@ Handle PageAllocationSpace::FreePageRange(const pgind_t start, const psize_t cou
                 this->Stack[page->StackIndex = ++this->StackFreeTop] = start + i;
 
                 page->Free();
+
+                this->StatisticsSequence.BeginWrite();
+
+                ++this->FreePageCount;
+                this->FreeSize += this->PageSize;
+
+                this->StatisticsSequence.EndWrite();
+
+                if (this->OwnerFreePageCount != nullptr)
+                    this->OwnerFreePageCount->FetchAdd(1, MemoryOrder::Relaxed);
             }
         else
         {
@@ -294,9 +319,16 @@ paddr_t PageAllocationSpace::AllocatePage(PageDescriptor * & desc)
             //  Mark the page as used.
             //  And, of course, return the descriptor.
 
+            this->StatisticsSequence.BeginWrite();
+
             --this->FreePageCount;
             this->FreeSize -= this->PageSize;
             //  Change the info accordingly.
+
+            this->StatisticsSequence.EndWrite();
+
+            if (this->OwnerFreePageCount != nullptr)
+                this->OwnerFreePageCount->FetchSub(1, MemoryOrder::Relaxed);
         }
 
         return this->AllocationStart + i * this->PageSize;
@@ -323,6 +355,23 @@ paddr_t PageAllocationSpace::AllocatePages(const psize_t count)
     return nullpaddr;
 }
 
+/*  Statistics  */
+
+void PageAllocationSpace::GetStatistics(PageAllocationStatistics & stats) const
+{
+    size_t seq;
+
+    do
+    {
+        seq = this->StatisticsSequence.BeginRead();
+
+        stats.FreePageCount     = this->FreePageCount;
+        stats.FreeSize          = this->FreeSize;
+        stats.ReservedPageCount = this->ReservedPageCount;
+        stats.ReservedSize      = this->ReservedSize;
+    } while (this->StatisticsSequence.RetryRead(seq));
+}
+
 /*  Utilitary Methods  */
 
 Handle PageAllocationSpace::PopPage(const pgind_t ind)
@@ -344,6 +393,9 @@ Handle PageAllocationSpace::PopPage(const pgind_t ind)
         this->FreeSize -= this->PageSize;
         //  Change the info accordingly.
 
+        if (this->OwnerFreePageCount != nullptr)
+            this->OwnerFreePageCount->FetchSub(1, MemoryOrder::Relaxed);
+
         return HandleResult::Okay;
     }
 
@@ -400,7 +452,9 @@ Handle PageAllocationSpace::PopPage(const pgind_t ind)
 /*  Constructors  */
 
 PageAllocator::PageAllocator()
-    : ChainLock()
+    : LowWatermark(DefaultLowWatermark)
+    , FreePageCount(0)
+    , ChainLock()
     , FirstSpace(nullptr)
     , LastSpace(nullptr)
 {
@@ -408,7 +462,9 @@ PageAllocator::PageAllocator()
 }
 
 PageAllocator::PageAllocator(PageAllocationSpace * const first)
-    : ChainLock()
+    : LowWatermark(DefaultLowWatermark)
+    , FreePageCount(0)
+    , ChainLock()
     , FirstSpace(first)
     , LastSpace(first)
 {
@@ -428,6 +484,9 @@ PageAllocator::PageAllocator(PageAllocationSpace * const first)
         this->LastSpace = this->LastSpace->Next;
         //  The next will become the last.
     }
+
+    for (PageAllocationSpace * space = first; space != nullptr; space = space->Next)
+        this->Adopt(space);
 }
 
 /*  Page Manipulation  */
@@ -435,16 +494,21 @@ PageAllocator::PageAllocator(PageAllocationSpace * const first)
 Handle PageAllocator::ReserveByteRange(const paddr_t phys_start, const psize_t length, const PageReservationOptions options)
 {
     Handle res;
-    PageAllocationSpace * space = this->FirstSpace;
+    PageAllocationSpace * space;
 
-    while (space != nullptr)
+    withRcuRead
     {
-        res = space->ReserveByteRange(phys_start, length, options);
+        space = Rcu::Dereference(this->FirstSpace);
 
-        if (!res.IsResult(HandleResult::PagesOutOfAllocatorRange))
-            return res;
+        while (space != nullptr)
+        {
+            res = space->ReserveByteRange(phys_start, length, options);
 
-        space = space->Next;
+            if (!res.IsResult(HandleResult::PagesOutOfAllocatorRange))
+                return res;
+
+            space = Rcu::Dereference(space->Next);
+        }
     }
 
     return HandleResult::PagesOutOfAllocatorRange;
@@ -453,16 +517,21 @@ Handle PageAllocator::ReserveByteRange(const paddr_t phys_start, const psize_t l
 Handle PageAllocator::FreeByteRange(const paddr_t phys_start, const psize_t length)
 {
     Handle res;
-    PageAllocationSpace * space = this->FirstSpace;
+    PageAllocationSpace * space;
 
-    while (space != nullptr)
+    withRcuRead
     {
-        res = space->FreeByteRange(phys_start, length);
+        space = Rcu::Dereference(this->FirstSpace);
 
-        if (!res.IsResult(HandleResult::PagesOutOfAllocatorRange))
-            return res;
+        while (space != nullptr)
+        {
+            res = space->FreeByteRange(phys_start, length);
 
-        space = space->Next;
+            if (!res.IsResult(HandleResult::PagesOutOfAllocatorRange))
+                return res;
+
+            space = Rcu::Dereference(space->Next);
+        }
     }
 
     return HandleResult::PagesOutOfAllocatorRange;
@@ -471,16 +540,21 @@ Handle PageAllocator::FreeByteRange(const paddr_t phys_start, const psize_t leng
 Handle PageAllocator::FreePageAtAddress(const paddr_t phys_addr)
 {
     Handle res;
-    PageAllocationSpace * space = this->FirstSpace;
+    PageAllocationSpace * space;
 
-    while (space != nullptr)
+    withRcuRead
     {
-        res = space->FreePageAtAddress(phys_addr);
+        space = Rcu::Dereference(this->FirstSpace);
+
+        while (space != nullptr)
+        {
+            res = space->FreePageAtAddress(phys_addr);
 
-        if (!res.IsResult(HandleResult::PagesOutOfAllocatorRange))
-            return res;
+            if (!res.IsResult(HandleResult::PagesOutOfAllocatorRange))
+                return res;
 
-        space = space->Next;
+            space = Rcu::Dereference(space->Next);
+        }
     }
 
     return HandleResult::PagesOutOfAllocatorRange;
@@ -491,43 +565,46 @@ paddr_t PageAllocator::AllocatePage(const PageAllocationOptions options, PageDes
     paddr_t ret = nullpaddr;
     PageAllocationSpace * space;
 
-    if (0 != (options & PageAllocationOptions::ThirtyTwoBit))
+    withRcuRead
     {
-        space = this->LastSpace;
-
-        while (space != nullptr)
+        if (0 != (options & PageAllocationOptions::ThirtyTwoBit))
         {
-            if ((uint64_t)space->GetAllocationEnd() <= (1ULL << 32))
+            space = Rcu::Dereference(this->LastSpace);
+
+            while (space != nullptr)
             {
-                //  The condition checks that the allocation space ends
-                //  at a 32-bit address. (all the other addresses are less,
-                //  thus have to be 32-bit if the end is)
+                if ((uint64_t)space->GetAllocationEnd() <= (1ULL << 32))
+                {
+                    //  The condition checks that the allocation space ends
+                    //  at a 32-bit address. (all the other addresses are less,
+                    //  thus have to be 32-bit if the end is)
 
-                ret = space->AllocatePage(desc);
+                    ret = space->AllocatePage(desc);
 
-                if (ret != nullpaddr)
-                    return ret;
-            }
+                    if (ret != nullpaddr)
+                        return ret;
+                }
 
-            space = space->Previous;
+                space = Rcu::Dereference(space->Previous);
+            }
         }
-    }
-    else
-    {
-        space = this->FirstSpace;
-
-        while (space != nullptr)
+        else
         {
-            ret = space->AllocatePage(desc);
+            space = Rcu::Dereference(this->FirstSpace);
 
-            if (ret != nullpaddr)
-                return ret;
+            while (space != nullptr)
+            {
+                ret = space->AllocatePage(desc);
 
-            space = space->Next;
+                if (ret != nullpaddr)
+                    return ret;
+
+                space = Rcu::Dereference(space->Next);
+            }
         }
-    }
 
-    desc = nullptr;
+        desc = nullptr;
+    }
 
     return nullpaddr;
 }
@@ -537,39 +614,42 @@ paddr_t PageAllocator::AllocatePages(const psize_t count, const PageAllocationOp
     paddr_t ret = nullpaddr;
     PageAllocationSpace * space;
 
-    if (0 != (options & PageAllocationOptions::ThirtyTwoBit))
+    withRcuRead
     {
-        space = this->LastSpace;
-
-        while (space != nullptr)
+        if (0 != (options & PageAllocationOptions::ThirtyTwoBit))
         {
-            if ((uint64_t)space->GetAllocationEnd() <= (1ULL << 32))
+            space = Rcu::Dereference(this->LastSpace);
+
+            while (space != nullptr)
             {
-                //  The condition checks that the allocation space ends
-                //  at a 32-bit address. (all the other addresses are less,
-                //  thus have to be 32-bit if the end is)
+                if ((uint64_t)space->GetAllocationEnd() <= (1ULL << 32))
+                {
+                    //  The condition checks that the allocation space ends
+                    //  at a 32-bit address. (all the other addresses are less,
+                    //  thus have to be 32-bit if the end is)
 
-                ret = space->AllocatePages(count);
+                    ret = space->AllocatePages(count);
 
-                if (ret != nullpaddr)
-                    return ret;
-            }
+                    if (ret != nullpaddr)
+                        return ret;
+                }
 
-            space = space->Previous;
+                space = Rcu::Dereference(space->Previous);
+            }
         }
-    }
-    else
-    {
-        space = this->FirstSpace;
-
-        while (space != nullptr)
+        else
         {
-            ret = space->AllocatePages(count);
+            space = Rcu::Dereference(this->FirstSpace);
 
-            if (ret != nullpaddr)
-                return ret;
+            while (space != nullptr)
+            {
+                ret = space->AllocatePages(count);
 
-            space = space->Next;
+                if (ret != nullpaddr)
+                    return ret;
+
+                space = Rcu::Dereference(space->Next);
+            }
         }
     }
 
@@ -578,29 +658,41 @@ paddr_t PageAllocator::AllocatePages(const psize_t count, const PageAllocationOp
 
 PageAllocationSpace * PageAllocator::GetSpaceContainingAddress(const paddr_t address)
 {
-    PageAllocationSpace * space = this->FirstSpace;
+    PageAllocationSpace * space;
 
-    while (space != nullptr)
+    withRcuRead
     {
-        if (space->ContainsRange(address, 1))
-            return space;
+        space = Rcu::Dereference(this->FirstSpace);
 
-        space = space->Next;
+        while (space != nullptr)
+        {
+            if (space->ContainsRange(address, 1))
+                return space;
+
+            space = Rcu::Dereference(space->Next);
+        }
     }
 
     return nullptr;
+    //  Allocation spaces are never freed, so the result remains valid after
+    //  the critical section.
 }
 
 bool PageAllocator::ContainsRange(const paddr_t phys_start, const psize_t length)
 {
-    const PageAllocationSpace * space = this->FirstSpace;
+    const PageAllocationSpace * space;
 
-    while (space != nullptr)
+    withRcuRead
     {
-        if (space->ContainsRange(phys_start, length))
-            return true;
+        space = Rcu::Dereference(this->FirstSpace);
+
+        while (space != nullptr)
+        {
+            if (space->ContainsRange(phys_start, length))
+                return true;
 
-        space = space->Next;
+            space = Rcu::Dereference(space->Next);
+        }
     }
 
     return false;
@@ -608,38 +700,78 @@ bool PageAllocator::ContainsRange(const paddr_t phys_start, const psize_t length
 
 bool PageAllocator::TryGetPageDescriptor(const paddr_t paddr, PageDescriptor * & res)
 {
-    PageAllocationSpace * space = this->FirstSpace;
+    PageAllocationSpace * space;
 
-    while (space != nullptr)
+    withRcuRead
     {
-        if (space->TryGetPageDescriptor(paddr, res))
-            return true;
+        space = Rcu::Dereference(this->FirstSpace);
+
+        while (space != nullptr)
+        {
+            if (space->TryGetPageDescriptor(paddr, res))
+                return true;
 
-        space = space->Next;
+            space = Rcu::Dereference(space->Next);
+        }
     }
 
     return false;
 }
 
+/*  Memory Pressure  */
+
+void PageAllocator::GetStatistics(PageAllocationStatistics & stats) const
+{
+    stats = {};
+
+    withRcuRead
+    {
+        PageAllocationSpace const * space = Rcu::Dereference(this->FirstSpace);
+
+        while (space != nullptr)
+        {
+            PageAllocationStatistics spaceStats;
+
+            space->GetStatistics(spaceStats);
+
+            stats.FreePageCount     += spaceStats.FreePageCount;
+            stats.FreeSize          += spaceStats.FreeSize;
+            stats.ReservedPageCount += spaceStats.ReservedPageCount;
+            stats.ReservedSize      += spaceStats.ReservedSize;
+
+            space = Rcu::Dereference(space->Next);
+        }
+    }
+}
+
 /*  Space Chaining  */
 
 void PageAllocator::PreppendAllocationSpace(PageAllocationSpace * const space)
 {
+    this->Adopt(space);
+
     withLock (this->ChainLock)
     {
-        this->FirstSpace->Previous = space;
+        space->Previous = nullptr;
         space->Next = this->FirstSpace;
-        this->FirstSpace = space;
+        //  The new space must be linked before it is published.
+
+        Rcu::Assign(this->FirstSpace->Previous, space);
+        Rcu::Assign(this->FirstSpace, space);
     }
 }
 
 void PageAllocator::AppendAllocationSpace(PageAllocationSpace * const space)
 {
+    this->Adopt(space);
+
     withLock (this->ChainLock)
     {
-        this->LastSpace->Next = space;
+        space->Next = nullptr;
         space->Previous = this->LastSpace;
-        this->LastSpace = space;
+
+        Rcu::Assign(this->LastSpace->Next, space);
+        Rcu::Assign(this->LastSpace, space);
     }
 }
 
@@ -675,4 +807,16 @@ void PageAllocator::RemapLinks(const vaddr_t oldAddr, const vaddr_t newAddr)
             cur = cur->Previous;
         }
     }
+
+    Rcu::Synchronize();
+    //  Readers may still be walking the old addresses.
+}
+
+void PageAllocator::Adopt(PageAllocationSpace * const space)
+{
+    space->OwnerFreePageCount = &(this->FreePageCount);
+
+    this->FreePageCount.FetchAdd(space->GetFreePageCount(), MemoryOrder::Relaxed);
+    //  The space is not reachable through this allocator yet, so its count
+    //  cannot change in between.
 }
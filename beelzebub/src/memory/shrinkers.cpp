@@ -0,0 +1,141 @@
+/*
+    Copyright (c) 2015 Alexandru-Mihai Maftei. All rights reserved.
+
+
+    Developed by: Alexandru-Mihai Maftei
+    aka Vercas
+    http://vercas.com | https://github.com/vercas/Beelzebub
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal with the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+      * Redistributions of source code must retain the above copyright notice,
+        this list of conditions and the following disclaimers.
+      * Redistributions in binary form must reproduce the above copyright
+        notice, this list of conditions and the following disclaimers in the
+        documentation and/or other materials provided with the distribution.
+      * Neither the names of Alexandru-Mihai Maftei, Vercas, nor the names of
+        its contributors may be used to endorse or promote products derived from
+        this Software without specific prior written permission.
+
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+    WITH THE SOFTWARE.
+
+    ---
+
+    You may also find the text of this license in "LICENSE.md", along with a more
+    thorough explanation regarding other files.
+*/
+
+#include <memory/shrinkers.hpp>
+#include <memory/object_allocator_registry.hpp>
+#include <synchronization/spinlock_uninterruptible.hpp>
+#include <synchronization/lock_guard.hpp>
+#include <synchronization/atomic.hpp>
+
+#include <debug.hpp>
+
+using namespace Beelzebub;
+using namespace Beelzebub::Memory;
+using namespace Beelzebub::Synchronization;
+
+static size_t ShrinkObjectAllocators(void * cookie, size_t pagesWanted)
+{
+    (void)cookie;
+
+    return ObjectAllocatorRegistry::Shrink(pagesWanted * PageSize) / PageSize;
+    //  Pools taken from the kernel heap span whole pages.
+}
+
+struct ShrinkerEntry
+{
+    Shrinkers::ShrinkFunc Function;
+    void * Cookie;
+};
+
+static ShrinkerEntry Entries[Shrinkers::Capacity] = { { &ShrinkObjectAllocators, nullptr } };
+static size_t EntryCount = 1;
+static SpinlockUninterruptible<> ShrinkersLock;
+
+static Atomic<bool> Shrinking {false};
+
+/*********************
+    Shrinkers class
+*********************/
+
+/*  (Un)registration  */
+
+Handle Shrinkers::Register(ShrinkFunc const func, void * const cookie)
+{
+    if unlikely(func == nullptr)
+        return HandleResult::ArgumentNull;
+
+    withLock (ShrinkersLock)
+    {
+        if unlikely(EntryCount == Capacity)
+            return HandleResult::OutOfMemory;
+
+        for (size_t i = 0; i < EntryCount; ++i)
+            if unlikely(Entries[i].Function == func && Entries[i].Cookie == cookie)
+                return HandleResult::CardinalityViolation;
+
+        Entries[EntryCount++] = { func, cookie };
+    }
+
+    return HandleResult::Okay;
+}
+
+Handle Shrinkers::Unregister(ShrinkFunc const func, void * const cookie)
+{
+    withLock (ShrinkersLock)
+        for (size_t i = 0; i < EntryCount; ++i)
+            if (Entries[i].Function == func && Entries[i].Cookie == cookie)
+            {
+                for (++i; i < EntryCount; ++i)
+                    Entries[i - 1] = Entries[i];
+                //  Order matters here, because earlier shrinkers are cheaper.
+
+                --EntryCount;
+
+                return HandleResult::Okay;
+            }
+
+    return HandleResult::NotFound;
+}
+
+/*  Operation  */
+
+size_t Shrinkers::Shrink(size_t const pagesWanted)
+{
+    if (Shrinking.TestSet(MemoryOrder::Acquire))
+        return 0;
+    //  Another CPU is already recovering memory, and shrinking twice would only
+    //  contend on the same locks.
+
+    size_t freed = 0;
+    SpinlockUninterruptible<>::Cookie cookie;
+
+    if (ShrinkersLock.TryAcquire(cookie))
+    {
+        for (size_t i = 0; i < EntryCount && freed < pagesWanted; ++i)
+            freed += Entries[i].Function(Entries[i].Cookie, pagesWanted - freed);
+
+        ShrinkersLock.Release(cookie);
+    }
+    //  This CPU may have faulted or run out of pages while (un)registering a
+    //  shrinker, so waiting for the lock could deadlock.
+
+    Shrinking.Clear(MemoryOrder::Release);
+
+    return freed;
+}
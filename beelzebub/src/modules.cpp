@@ -41,6 +41,7 @@
 #include <execution/elf.kmod.mapper.hpp>
 #include <memory/object_allocator_smp.hpp>
 #include <memory/object_allocator_pools_heap.hpp>
+#include <memory/object_allocator_registry.hpp>
 #include <memory/vmm.hpp>
 
 #include <math.h>
@@ -78,6 +79,8 @@ Handle Modules::Initialize()
     new (&ModulesAllocator) ObjectAllocatorSmp(sizeof(KernelModule), __alignof(KernelModule)
         , &AcquirePoolInKernelHeap, &EnlargePoolInKernelHeap, &ReleasePoolFromKernelHeap);
 
+    ObjectAllocatorRegistry::Register("Kernel Modules", ModulesAllocator);
+
     Modules::Initialized = true;
 
     return HandleResult::Okay;
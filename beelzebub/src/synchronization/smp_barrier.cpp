@@ -0,0 +1,100 @@
+/*
+    Copyright (c) 2015 Alexandru-Mihai Maftei. All rights reserved.
+
+
+    Developed by: Alexandru-Mihai Maftei
+    aka Vercas
+    http://vercas.com | https://github.com/vercas/Beelzebub
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal with the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+      * Redistributions of source code must retain the above copyright notice,
+        this list of conditions and the following disclaimers.
+      * Redistributions in binary form must reproduce the above copyright
+        notice, this list of conditions and the following disclaimers in the
+        documentation and/or other materials provided with the distribution.
+      * Neither the names of Alexandru-Mihai Maftei, Vercas, nor the names of
+        its contributors may be used to endorse or promote products derived from
+        this Software without specific prior written permission.
+
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+    WITH THE SOFTWARE.
+
+    ---
+
+    You may also find the text of this license in "LICENSE.md", along with a more
+    thorough explanation regarding other files.
+*/
+
+#include <synchronization/smp_barrier.hpp>
+#include <memory/vmm.hpp>
+#include <kernel.hpp>
+#include <entry.h>
+
+#include <math.h>
+#include <debug.hpp>
+
+using namespace Beelzebub;
+using namespace Beelzebub::Memory;
+using namespace Beelzebub::Synchronization;
+using namespace Beelzebub::System;
+
+/************************
+    SmpBarrier struct
+************************/
+
+#if !defined(__BEELZEBUB_SETTINGS_NO_SMP)
+
+/*  Operations  */
+
+void SmpBarrier::Reset(size_t const participants) volatile
+{
+    ASSERT(participants > 0, "A barrier needs at least one participant.");
+
+    if (participants > this->NodeCapacity)
+    {
+        size_t const pageCount = RoundUp(participants * sizeof(Node), PageSize) / PageSize;
+        vaddr_t vaddr = nullvaddr;
+
+        Handle res = Vmm::AllocatePages(
+            CpuDataSetUp ? Cpu::GetProcess() : &BootstrapProcess
+            , pageCount
+            , MemoryAllocationOptions::Commit | MemoryAllocationOptions::VirtualKernelHeap
+            , MemoryFlags::Global | MemoryFlags::Writable
+            , MemoryContent::Generic
+            , vaddr);
+
+        ASSERT(res.IsOkayResult()
+            , "Failed to allocate the nodes of a barrier for %us cores: %H."
+            , participants, res);
+
+        this->Nodes = reinterpret_cast<Node *>(vaddr);
+        this->NodeCapacity = pageCount * PageSize / sizeof(Node);
+        //  The previous nodes, if any, are lost, as the VMM cannot free pages
+        //  yet. Barriers are seldom reset with more participants anyway.
+    }
+
+    for (size_t i = 0; i < participants; ++i)
+    {
+        this->Nodes[i].Arrived = 0;
+        this->Nodes[i].WakeSense = false;
+        this->Nodes[i].Sense = false;
+    }
+
+    this->Participants = participants;
+
+    COMPILER_MEMORY_BARRIER();
+}
+
+#endif
@@ -40,6 +40,7 @@
 #include <syscalls.kernel.hpp>
 
 #include <syscalls/memory.h>
+#include <syscalls/statistics.h>
 
 #include <terminals/base.hpp>
 
@@ -112,6 +113,12 @@ Handle Beelzebub::SyscallCommon(SyscallSelection const selector, void * arg1
     case SyscallSelection::MemoryFill:
         return MemoryFill(reinterpret_cast<uintptr_t>(arg1), (uint8_t)arg2, (size_t)arg3);
 
+    case SyscallSelection::ObjaStatistics:
+        return GetObjectAllocatorStatistics(reinterpret_cast<obja_stats_t *>(arg1), (size_t)arg2, reinterpret_cast<size_t *>(arg3));
+
+    case SyscallSelection::PageStatistics:
+        return GetPageAllocationStatistics(reinterpret_cast<page_stats_t *>(arg1));
+
     default:
         return HandleResult::SyscallSelectionInvalid;
     }
@@ -40,6 +40,7 @@
 #include <syscalls/memory.h>
 #include <memory/vmm.hpp>
 #include <system/cpu.hpp>
+#include <execution/preemption.hpp>
 #include <math.h>
 #include <string.h>
 
@@ -47,7 +48,12 @@ using namespace Beelzebub;
 using namespace Beelzebub::Memory;
 using namespace Beelzebub::Syscalls;
 
+#ifdef __BEELZEBUB_SETTINGS_KERNEL_PREEMPTION
+static constexpr size_t const ChunkSize = 256 << 10;    //  256 KiB.
+//  Interrupts are disabled for a whole chunk, so this bounds scheduling latency.
+#else
 static constexpr size_t const ChunkSize = 4 * 1 << 20;  //  4 MiB.
+#endif
 
 handle_t Syscalls::MemoryRequest(uintptr_t addr, size_t size, mem_req_opts_t opts)
 {
@@ -159,6 +165,8 @@ handle_t Syscalls::MemoryCopy(uintptr_t dst, uintptr_t src, size_t len)
         withWriteProtect (false)
             memmove(reinterpret_cast<void *>(dst), reinterpret_cast<void const *>(src), curChunk);
         //  TODO: Exception handling, maybe?
+
+        Execution::Preemption::Point();
     }
 
     return HandleResult::Okay;
@@ -202,6 +210,8 @@ handle_t Syscalls::MemoryFill(uintptr_t dst, uint8_t val, size_t len)
         withWriteProtect (false)
             memset(reinterpret_cast<void *>(dst), val, curChunk);
         //  TODO: Exception handling, maybe?
+
+        Execution::Preemption::Point();
     }
 
     return HandleResult::Okay;
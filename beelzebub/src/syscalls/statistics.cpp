@@ -0,0 +1,110 @@
+/*
+    Copyright (c) 2015 Alexandru-Mihai Maftei. All rights reserved.
+
+
+    Developed by: Alexandru-Mihai Maftei
+    aka Vercas
+    http://vercas.com | https://github.com/vercas/Beelzebub
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal with the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+      * Redistributions of source code must retain the above copyright notice,
+        this list of conditions and the following disclaimers.
+      * Redistributions in binary form must reproduce the above copyright
+        notice, this list of conditions and the following disclaimers in the
+        documentation and/or other materials provided with the distribution.
+      * Neither the names of Alexandru-Mihai Maftei, Vercas, nor the names of
+        its contributors may be used to endorse or promote products derived from
+        this Software without specific prior written permission.
+
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+    WITH THE SOFTWARE.
+
+    ---
+
+    You may also find the text of this license in "LICENSE.md", along with a more
+    thorough explanation regarding other files.
+*/
+
+#include <syscalls/statistics.h>
+#include <memory/object_allocator_registry.hpp>
+#include <memory/vmm.hpp>
+#include <system/cpu.hpp>
+#include <string.h>
+
+using namespace Beelzebub;
+using namespace Beelzebub::Memory;
+using namespace Beelzebub::Syscalls;
+using namespace Beelzebub::System;
+
+handle_t Syscalls::GetObjectAllocatorStatistics(obja_stats_t * table, size_t capacity, size_t * count)
+{
+    uintptr_t const tableAddr = reinterpret_cast<uintptr_t>(table);
+    size_t const tableSize = capacity * sizeof(obja_stats_t);
+
+    if unlikely(capacity > ObjectAllocatorRegistry::Capacity
+        || tableAddr + tableSize < tableAddr)
+        return HandleResult::ArgumentOutOfRange;
+
+    if unlikely(0 != (reinterpret_cast<uintptr_t>(count) % sizeof(size_t)))
+        return HandleResult::AlignmentFailure;
+
+    Handle res = Vmm::CheckMemoryRegion(nullptr, reinterpret_cast<uintptr_t>(count)
+        , sizeof(size_t), MemoryCheckType::Userland | MemoryCheckType::Writable);
+
+    if unlikely(!res.IsOkayResult())
+        return res;
+
+    if (capacity > 0)
+    {
+        res = Vmm::CheckMemoryRegion(nullptr, tableAddr, tableSize
+            , MemoryCheckType::Userland | MemoryCheckType::Writable);
+
+        if unlikely(!res.IsOkayResult())
+            return res;
+    }
+
+    ObjectAllocatorStatistics row;
+    size_t i;
+
+    for (i = 0; i < capacity && ObjectAllocatorRegistry::Collect(i, row).IsOkayResult(); ++i)
+        memcpy(table + i, &row, sizeof(row));
+    //  Rows are gathered on the kernel stack so no registry lock is held while
+    //  touching userland memory.
+
+    *count = i;
+
+    return HandleResult::Okay;
+}
+
+handle_t Syscalls::GetPageAllocationStatistics(page_stats_t * stats)
+{
+    if unlikely(0 != (reinterpret_cast<uintptr_t>(stats) % sizeof(psize_t)))
+        return HandleResult::AlignmentFailure;
+
+    Handle res = Vmm::CheckMemoryRegion(nullptr, reinterpret_cast<uintptr_t>(stats)
+        , sizeof(page_stats_t), MemoryCheckType::Userland | MemoryCheckType::Writable);
+
+    if unlikely(!res.IsOkayResult())
+        return res;
+
+    PageAllocationStatistics snapshot;
+
+    Cpu::GetData()->DomainDescriptor->PhysicalAllocator->GetStatistics(snapshot);
+    //  Lock-free, so polling this does not contend with page allocations.
+
+    memcpy(stats, &snapshot, sizeof(snapshot));
+
+    return HandleResult::Okay;
+}
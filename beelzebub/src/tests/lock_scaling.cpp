@@ -0,0 +1,132 @@
+/*
+    Copyright (c) 2015 Alexandru-Mihai Maftei. All rights reserved.
+
+
+    Developed by: Alexandru-Mihai Maftei
+    aka Vercas
+    http://vercas.com | https://github.com/vercas/Beelzebub
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal with the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+      * Redistributions of source code must retain the above copyright notice,
+        this list of conditions and the following disclaimers.
+      * Redistributions in binary form must reproduce the above copyright
+        notice, this list of conditions and the following disclaimers in the
+        documentation and/or other materials provided with the distribution.
+      * Neither the names of Alexandru-Mihai Maftei, Vercas, nor the names of
+        its contributors may be used to endorse or promote products derived from
+        this Software without specific prior written permission.
+
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+    WITH THE SOFTWARE.
+
+    ---
+
+    You may also find the text of this license in "LICENSE.md", along with a more
+    thorough explanation regarding other files.
+*/
+
+#if     defined(__BEELZEBUB__TEST_LOCK_SCALING) && defined(__BEELZEBUB_SETTINGS_SMP)
+
+#include <tests/lock_scaling.hpp>
+#include <synchronization/queued_spinlock.hpp>
+#include <system/cpu.hpp>
+#include <system/interrupts.hpp>
+
+#include <debug.hpp>
+
+#define LOCK_SCALING_ITERATIONS ((size_t)100000)
+
+using namespace Beelzebub;
+using namespace Beelzebub::Synchronization;
+using namespace Beelzebub::System;
+
+SmpBarrier LockScalingTestBarrier {};
+
+static Spinlock<> TicketLock {};
+static QueuedSpinlock<> QueuedLock {};
+
+static size_t volatile SharedCounter;
+static Atomic<uint64_t> SlowestCycles {0};
+
+template<typename TLock>
+static uint64_t Contend(TLock & lock, size_t const cores)
+{
+    bool const participating = Cpu::GetData()->Index < cores;
+
+    LockScalingTestBarrier.Reach();
+
+    if (participating)
+    {
+        InterruptGuard<> intGuard;
+        //  A preempted holder (or waiter) would stall everybody else.
+
+        uint64_t const start = CpuInstructions::Rdtsc();
+
+        for (size_t i = LOCK_SCALING_ITERATIONS; i > 0; --i)
+        {
+            lock.Acquire();
+            SharedCounter = SharedCounter + 1;
+            lock.Release();
+        }
+
+        uint64_t const cycles = CpuInstructions::Rdtsc() - start;
+        uint64_t slowest = SlowestCycles.Load();
+
+        while (cycles > slowest && !SlowestCycles.CmpXchgWeak(slowest, cycles))
+            ;   //  `slowest` is refreshed by every failed exchange.
+    }
+
+    LockScalingTestBarrier.Reach();
+
+    uint64_t const slowest = SlowestCycles.Load();
+
+    ASSERT_EQ("%us", cores * LOCK_SCALING_ITERATIONS, (size_t)SharedCounter);
+    //  Lost increments mean broken mutual exclusion.
+
+    LockScalingTestBarrier.Reach();
+
+    if (Cpu::GetData()->Index == 0)
+    {
+        SharedCounter = 0;
+        SlowestCycles.Store(0);
+    }
+
+    return slowest / LOCK_SCALING_ITERATIONS;
+}
+
+void TestLockScaling(bool bsp)
+{
+
+    if (bsp)
+        SharedCounter = 0;
+
+    LockScalingTestBarrier.Reach();
+
+    size_t const coreCount = Cpu::Count.Load();
+
+    for (size_t cores = 1; cores <= coreCount; ++cores)
+    {
+        uint64_t const ticket = Contend(TicketLock, cores);
+        uint64_t const queued = Contend(QueuedLock, cores);
+
+        if (bsp)
+            MSG_("Lock scaling with %us core(s): %u8 cycles/acquisition ticket,"
+                " %u8 cycles/acquisition queued.%n", cores, ticket, queued);
+    }
+
+    LockScalingTestBarrier.Reach();
+}
+
+#endif
@@ -0,0 +1,116 @@
+/*
+    Copyright (c) 2015 Alexandru-Mihai Maftei. All rights reserved.
+
+
+    Developed by: Alexandru-Mihai Maftei
+    aka Vercas
+    http://vercas.com | https://github.com/vercas/Beelzebub
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal with the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+      * Redistributions of source code must retain the above copyright notice,
+        this list of conditions and the following disclaimers.
+      * Redistributions in binary form must reproduce the above copyright
+        notice, this list of conditions and the following disclaimers in the
+        documentation and/or other materials provided with the distribution.
+      * Neither the names of Alexandru-Mihai Maftei, Vercas, nor the names of
+        its contributors may be used to endorse or promote products derived from
+        this Software without specific prior written permission.
+
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+    WITH THE SOFTWARE.
+
+    ---
+
+    You may also find the text of this license in "LICENSE.md", along with a more
+    thorough explanation regarding other files.
+*/
+
+#if     defined(__BEELZEBUB__TEST_MUTEX) && defined(__BEELZEBUB_SETTINGS_SMP)
+
+#include <tests/mutex.hpp>
+#include <synchronization/condition_variable.hpp>
+#include <synchronization/semaphore.hpp>
+#include <system/cpu.hpp>
+
+#include <debug.hpp>
+
+#define MUTEX_ITERATIONS        ((size_t)10000)
+#define SEMAPHORE_UNITS         ((size_t)2)
+
+using namespace Beelzebub;
+using namespace Beelzebub::Synchronization;
+using namespace Beelzebub::System;
+
+SmpBarrier MutexTestBarrier {};
+
+static Mutex TestMutexInstance {};
+static Semaphore TestSemaphore {SEMAPHORE_UNITS};
+static ConditionVariable TestCondition {};
+
+static size_t volatile SharedCounter = 0;
+static size_t volatile Turn = 0;
+static Atomic<size_t> Holders {0};
+
+void TestMutex(bool bsp)
+{
+    size_t const index = Cpu::GetData()->Index;
+    size_t const count = Cpu::Count.Load();
+
+    //  First, mutual exclusion.
+
+    for (size_t i = MUTEX_ITERATIONS; i > 0; --i)
+        withLock (TestMutexInstance)
+            SharedCounter = SharedCounter + 1;
+
+    MutexTestBarrier.Reach();
+
+    ASSERT_EQ("%us", count * MUTEX_ITERATIONS, (size_t)SharedCounter);
+    ASSERT(TestMutexInstance.Check(), "Mutex is still held!");
+
+    //  Then, the semaphore must never let more holders in than it has units.
+
+    for (size_t i = MUTEX_ITERATIONS; i > 0; --i)
+    {
+        TestSemaphore.Acquire();
+
+        size_t const holders = ++Holders;
+
+        ASSERT(holders <= SEMAPHORE_UNITS, "Semaphore has %us holders!", holders);
+
+        --Holders;
+
+        TestSemaphore.Release();
+    }
+
+    MutexTestBarrier.Reach();
+
+    ASSERT_EQ("%us", SEMAPHORE_UNITS, TestSemaphore.GetCount());
+
+    //  Finally, the cores take turns in order of their index.
+
+    withLock (TestMutexInstance)
+    {
+        while (Turn != index)
+            TestCondition.Wait(TestMutexInstance);
+
+        Turn = Turn + 1;
+
+        TestCondition.Broadcast();
+    }
+
+    (void)bsp;
+}
+
+#endif
@@ -41,6 +41,8 @@
 
 #include <tests/object_allocator.hpp>
 #include <memory/object_allocator_smp.hpp>
+#include <memory/object_allocator_numa.hpp>
+#include <memory/object_allocator_pools_heap.hpp>
 #include <memory/page_allocator.hpp>
 #include <memory/vmm.hpp>
 #include <kernel.hpp>
@@ -60,9 +62,7 @@ using namespace Beelzebub::Memory;
 using namespace Beelzebub::Synchronization;
 using namespace Beelzebub::System;
 
-SmpBarrier ObjectAllocatorTestBarrier1 {};
-SmpBarrier ObjectAllocatorTestBarrier2 {};
-SmpBarrier ObjectAllocatorTestBarrier3 {};
+SmpBarrier ObjectAllocatorTestBarrier {};
 
 struct TestStructure
 {
@@ -445,14 +445,13 @@ __startup Handle ObjectAllocatorSpamTest()
 {
     Handle res;
 
-    ObjectAllocatorTestBarrier1.Reach();
+    ObjectAllocatorTestBarrier.Reach();
 
     size_t volatile freeCount1 = testAllocator.GetFreeCount();
     size_t volatile capacity1 = testAllocator.GetCapacity();
     size_t volatile busyCount1 = testAllocator.GetBusyCount();
 
-    ObjectAllocatorTestBarrier2.Reach();
-    ObjectAllocatorTestBarrier1.Reset(); //  Prepare the first barrier for re-use.
+    ObjectAllocatorTestBarrier.Reach();
 
 #ifdef __BEELZEBUB__PROFILE
     uint64_t perfAcc = 0;
@@ -537,8 +536,7 @@ __startup Handle ObjectAllocatorSpamTest()
         , perfAcc, REPETITION_COUNT_3, perfAcc / REPETITION_COUNT_3);
 #endif
 
-    ObjectAllocatorTestBarrier3.Reach();
-    ObjectAllocatorTestBarrier2.Reset(); //  Prepare the second barrier for re-use.
+    ObjectAllocatorTestBarrier.Reach();
 
     ASSERT(capacity1 - freeCount1 == testAllocator.GetCapacity() - testAllocator.GetFreeCount()
         , "Allocator's deduced busy object count has a shady value: %us (%us - %us)"
@@ -551,8 +549,7 @@ __startup Handle ObjectAllocatorSpamTest()
         , "Allocator's busy object count has a shady value: %us, expected %us."
         , busyCount1, testAllocator.GetBusyCount());
 
-    ObjectAllocatorTestBarrier1.Reach();
-    ObjectAllocatorTestBarrier3.Reset(); //  Prepare the third barrier for re-use.
+    ObjectAllocatorTestBarrier.Reach();
 
     return HandleResult::Okay;
 }
@@ -762,6 +759,372 @@ __startup Handle ThreePoolTest()
     return HandleResult::Okay;
 }
 
+__startup Handle BatchTest()
+{
+    Handle res;
+
+    size_t const objCount = 3 * PageSize / sizeof(TestStructure);
+    //  Large enough to need a multi-page pool.
+
+    TestStructure * objs[objCount];
+    size_t done = 0;
+
+    bool const couldEnlarge = canEnlarge;
+    canEnlarge = false;
+    askedToAcquire = askedToRemove = false;
+
+    res = testAllocator.AllocateObjects(reinterpret_cast<void * *>(objs), objCount, done);
+
+    ASSERT(res.IsOkayResult() && done == objCount
+        , "Failed to allocate a batch of %us objects (got %us): %H%n"
+        , objCount, done, res);
+
+    ASSERT(askedToAcquire
+        , "The allocator wasn't asked to acquire a pool for a batch allocation..?");
+
+    ASSERT(testAllocator.GetBusyCount() == objCount
+        , "Test allocator should have %us busy objects, not %us.%n"
+        , objCount, testAllocator.GetBusyCount());
+
+    for (size_t i = 0; i < objCount; ++i)
+    {
+        ASSERT(0 != (objs[i]->Qwords[0] & 1)
+            , "Batch-allocated object #%us (%Xp) has busy bit clear!%n"
+            , i, objs[i]);
+
+        for (size_t j = 0; j < i; ++j)
+            ASSERT(objs[i] != objs[j]
+                , "Batch-allocated objects #%us and #%us are both %Xp!%n"
+                , i, j, objs[i]);
+    }
+
+    res = testAllocator.DeallocateObjects(reinterpret_cast<void * const *>(objs), objCount / 2, done);
+
+    ASSERT(res.IsOkayResult() && done == objCount / 2
+        , "Failed to deallocate the first half of the batch (%us freed): %H%n"
+        , done, res);
+
+    res = testAllocator.DeallocateObjects(reinterpret_cast<void * const *>(objs), 1, done);
+
+    ASSERT(res.IsResult(HandleResult::ObjaAlreadyFree) && done == 0
+        , "Batch deallocation of a free object should've returned "
+          "\"already freed\" (%us freed): %H%n"
+        , done, res);
+
+    res = testAllocator.DeallocateObjects(reinterpret_cast<void * const *>(objs + objCount / 2)
+        , objCount - objCount / 2, done);
+
+    ASSERT(res.IsOkayResult() && done == objCount - objCount / 2
+        , "Failed to deallocate the second half of the batch (%us freed): %H%n"
+        , done, res);
+
+    ASSERT(askedToRemove
+        , "The allocator should have asked to remove the pools emptied by the batch!");
+
+    ASSERT(testAllocator.PoolCount == 0 && testAllocator.GetCapacity() == 0
+            && testAllocator.GetBusyCount() == 0
+        , "Test allocator should be empty after the batch, not %us pools, "
+          "%us capacity and %us busy objects.%n"
+        , testAllocator.PoolCount.Load(), testAllocator.GetCapacity()
+        , testAllocator.GetBusyCount());
+
+    canEnlarge = couldEnlarge;
+
+    return HandleResult::Okay;
+}
+
+#define COLOURING_POOL_COUNT  ((size_t)256)
+#define COLOURING_CHASE_COUNT ((size_t)1000)
+#define COLOURING_SET_COUNT   (PageSize / CacheLineSize)
+//  Sets of a cache whose ways span a page, like the L1 data cache.
+
+struct ColouringStructure
+{
+    uint8_t Bytes[1000 - sizeof(void *)];
+    ColouringStructure * Next;
+};
+//  Large enough to leave many cache lines of slack in a one-page pool, so its
+//  pools can take many colours.
+
+static __startup Handle RefuseToEnlargePool(size_t, size_t, size_t, ObjectPoolBase *)
+{
+    return HandleResult::UnsupportedOperation;
+    //  Every pool stays one page long, so every page has its own first object.
+}
+
+__startup Handle ChaseFirstObjects(AcquirePoolFunc const acquirer
+                                 , uint64_t & cycles, size_t & conflicts)
+{
+    Handle res;
+
+    ObjectAllocatorSmp alloc {sizeof(ColouringStructure), __alignof(ColouringStructure)
+        , acquirer, &RefuseToEnlargePool, &ReleasePoolFromKernelHeap};
+
+    ColouringStructure * firsts = nullptr, * others = nullptr;
+
+    while (alloc.PoolCount.Load() < COLOURING_POOL_COUNT)
+    {
+        size_t const poolCount = alloc.PoolCount.Load();
+        ColouringStructure * obj = nullptr;
+
+        res = alloc.AllocateObject(obj);
+
+        ASSERT(res.IsOkayResult()
+            , "Failed to allocate object for pool #%us of the colouring benchmark: %H."
+            , poolCount, res);
+
+        if (alloc.PoolCount.Load() != poolCount)
+        {
+            obj->Next = firsts;
+            firsts = obj;
+        }
+        else
+        {
+            obj->Next = others;
+            others = obj;
+        }
+    }
+
+    //  The first object of every pool is at the same offset within its page,
+    //  unless the pools are coloured.
+
+    size_t setUsers[COLOURING_SET_COUNT] = {};
+    conflicts = 0;
+
+    for (ColouringStructure const * cur = firsts; cur != nullptr; cur = cur->Next)
+    {
+        size_t const users = ++setUsers[((uintptr_t)cur / CacheLineSize) % COLOURING_SET_COUNT];
+
+        if (users > conflicts)
+            conflicts = users;
+    }
+
+    uint64_t const start = CpuInstructions::Rdtsc();
+
+    for (size_t i = COLOURING_CHASE_COUNT; i > 0; --i)
+        for (ColouringStructure const volatile * cur = firsts; cur != nullptr; cur = cur->Next)
+            ;
+
+    cycles = CpuInstructions::Rdtsc() - start;
+
+    ColouringStructure * lists[2] = { firsts, others };
+
+    for (size_t i = 0; i < 2; ++i)
+        for (ColouringStructure * cur = lists[i], * next; cur != nullptr; cur = next)
+        {
+            next = cur->Next;
+
+            res = alloc.DeallocateObject(cur);
+
+            ASSERT(res.IsOkayResult()
+                , "Failed to deallocate object %Xp of the colouring benchmark: %H."
+                , cur, res);
+        }
+
+    ASSERT(alloc.PoolCount.Load() == 0
+        , "Colouring benchmark allocator should have released all its pools, "
+          "not kept %us.", alloc.PoolCount.Load());
+
+    alloc.Dispose();
+
+    return HandleResult::Okay;
+}
+
+__startup Handle ColouringBenchmark()
+{
+    uint64_t plainCycles, colouredCycles;
+    size_t plainConflicts, colouredConflicts;
+
+    Handle res = ChaseFirstObjects(&AcquireUncolouredPoolInKernelHeap
+        , plainCycles, plainConflicts);
+
+    if (!res.IsOkayResult())
+        return res;
+
+    res = ChaseFirstObjects(&AcquirePoolInKernelHeap
+        , colouredCycles, colouredConflicts);
+
+    if (!res.IsOkayResult())
+        return res;
+
+    MSG_("Chasing %us pool heads %us times: %u8 cycles plain, %u8 cycles coloured.%n"
+        , COLOURING_POOL_COUNT, COLOURING_CHASE_COUNT, plainCycles, colouredCycles);
+
+    ASSERT(plainConflicts == COLOURING_POOL_COUNT
+        , "Uncoloured pools should all put their first object in the same cache "
+          "set, not at most %us of %us.", plainConflicts, COLOURING_POOL_COUNT);
+
+    ASSERT(colouredConflicts < plainConflicts
+        , "Coloured pools should spread their first objects over more cache sets: "
+          "%us share a set, %us without colouring."
+        , colouredConflicts, plainConflicts);
+
+    return HandleResult::Okay;
+}
+
+__startup Handle ShrinkTest()
+{
+    Handle res;
+
+    ObjectAllocatorSmp alloc {sizeof(TestStructure), __alignof(TestStructure)
+        , &AcquirePoolTest, &RefuseToEnlargePool, &ReleasePoolTest
+        , PoolReleaseOptions::NoRelease};
+
+    TestStructure * objs = nullptr;
+
+    while (alloc.PoolCount.Load() < 3 || alloc.GetFreeCount() > 0)
+    {
+        TestStructure * obj = nullptr;
+
+        res = alloc.AllocateObject(obj);
+
+        ASSERT(res.IsOkayResult()
+            , "Failed to allocate object for the shrink test: %H.", res);
+
+        obj->Next = objs;
+        objs = obj;
+    }
+
+    for (TestStructure * cur = objs, * next; cur != nullptr; cur = next)
+    {
+        next = cur->Next;
+
+        res = alloc.DeallocateObject(cur);
+
+        ASSERT(res.IsOkayResult()
+            , "Failed to deallocate object %Xp of the shrink test: %H."
+            , cur, res);
+    }
+
+    ASSERT(alloc.PoolCount.Load() == 3
+        , "Shrink test allocator should have kept its 3 pools, not %us."
+        , alloc.PoolCount.Load());
+
+    size_t const released = alloc.Shrink();
+
+    ASSERT(released > 0 && alloc.PoolCount.Load() == 0 && alloc.GetCapacity() == 0
+        , "Shrinking should have released all pools, but %us remain with "
+          "capacity %us after releasing %us bytes."
+        , alloc.PoolCount.Load(), alloc.GetCapacity(), released);
+
+    alloc.Dispose();
+
+    return HandleResult::Okay;
+}
+
+#define NUMA_QUOTA ((size_t)64)
+
+static ObjectAllocatorNuma numaAllocator;
+
+static __startup TestStructure * NumaAllocate(Domain * const domain, size_t const count)
+{
+    CpuData * const data = Cpu::GetData();
+    Domain * const home = data->DomainDescriptor;
+    TestStructure * objs = nullptr;
+
+    data->DomainDescriptor = domain;
+    //  Interrupts are disabled, so nothing else runs on this CPU meanwhile.
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        TestStructure * obj = nullptr;
+
+        Handle res = numaAllocator.AllocateObject(obj);
+
+        ASSERT(res.IsOkayResult()
+            , "Failed to allocate NUMA test object #%us in domain %us: %H."
+            , i, domain->Index, res);
+
+        obj->Next = objs;
+        objs = obj;
+    }
+
+    data->DomainDescriptor = home;
+
+    return objs;
+}
+
+static __startup void NumaDeallocate(TestStructure * objs)
+{
+    for (TestStructure * next; objs != nullptr; objs = next)
+    {
+        next = objs->Next;
+
+        Handle res = numaAllocator.DeallocateObject(objs);
+
+        ASSERT(res.IsOkayResult()
+            , "Failed to deallocate NUMA test object %Xp: %H.", objs, res);
+    }
+}
+
+__startup Handle NumaTest()
+{
+    InterruptGuard<false> ig;
+
+    Domain * const local = Cpu::GetData()->DomainDescriptor;
+    Domain remote;
+
+    remote.Index = local->Index + 1;
+    remote.PhysicalAllocator = local->PhysicalAllocator;
+    //  A second domain which shares the memory of the first one.
+
+    new (&numaAllocator) ObjectAllocatorNuma(sizeof(TestStructure), __alignof(TestStructure)
+        , &AcquirePoolInKernelHeap, &EnlargePoolInKernelHeap, &ReleasePoolFromKernelHeap
+        , PoolReleaseOptions::ReleaseAll, SIZE_MAX, NUMA_QUOTA);
+
+    //  Objects go back to the chain of the domain they came from, whichever
+    //  domain frees them.
+
+    TestStructure * remoteObjs = NumaAllocate(&remote, NUMA_QUOTA / 2);
+
+    ASSERT(numaAllocator.GetChain(remote.Index).GetBusyCount() == NUMA_QUOTA / 2
+        && numaAllocator.GetChain(local->Index).GetBusyCount() == 0
+        , "Objects allocated in domain %us should all be in its chain."
+        , remote.Index);
+
+    NumaDeallocate(remoteObjs);
+
+    ASSERT(numaAllocator.GetChain(remote.Index).GetBusyCount() == 0
+        && numaAllocator.GetBusyCount() == 0
+        , "Objects freed from domain %us should have returned to domain %us."
+        , local->Index, remote.Index);
+
+    //  The peak is that of the whole allocator, not the sum of the chains'.
+
+    TestStructure * localObjs = NumaAllocate(local, NUMA_QUOTA / 2);
+    NumaDeallocate(localObjs);
+
+    ObjectAllocatorStatistics stats;
+    numaAllocator.GetStatistics(stats);
+
+    ASSERT(stats.PeakBusyCount == NUMA_QUOTA / 2
+        , "NUMA allocator peaked at %us busy objects, not %us."
+        , stats.PeakBusyCount, NUMA_QUOTA / 2);
+
+    //  The quota spans all domains.
+
+    localObjs = NumaAllocate(local, NUMA_QUOTA / 2);
+    remoteObjs = NumaAllocate(&remote, NUMA_QUOTA / 2);
+
+    TestStructure * extra = nullptr;
+    Handle res = numaAllocator.AllocateObject(extra);
+
+    ASSERT(res.IsResult(HandleResult::ObjaMaximumCapacity)
+        , "NUMA allocator exceeded its quota of %us objects across domains: %H."
+        , NUMA_QUOTA, res);
+
+    NumaDeallocate(localObjs);
+    NumaDeallocate(remoteObjs);
+
+    ASSERT(numaAllocator.GetBusyCount() == 0
+        , "NUMA allocator should have no busy objects left, not %us."
+        , numaAllocator.GetBusyCount());
+
+    numaAllocator.Dispose();
+
+    return HandleResult::Okay;
+}
+
 __startup Handle ObjectAllocatorParallelAcquireTest()
 {
     Handle res;
@@ -769,14 +1132,12 @@ __startup Handle ObjectAllocatorParallelAcquireTest()
     size_t const objCount = 2 * PageSize / sizeof(TestStructure);
     //  Should make 3 merry pools.
 
-    ObjectAllocatorTestBarrier2.Reach();
-    ObjectAllocatorTestBarrier1.Reset(); //  Prepare the first barrier for re-use.
+    ObjectAllocatorTestBarrier.Reach();
 
     /*msg_("Core #%us: Gunna allocate %us objects.%n"
         , System::Cpu::GetData()->Index, objCount);//*/
 
-    ObjectAllocatorTestBarrier3.Reach();
-    ObjectAllocatorTestBarrier2.Reset(); //  Prepare the second barrier for re-use.
+    ObjectAllocatorTestBarrier.Reach();
 
     TestStructure * tOx = nullptr, * tOy = nullptr;
 
@@ -802,16 +1163,14 @@ __startup Handle ObjectAllocatorParallelAcquireTest()
         tOx->Next = tOy;
     }
 
-    ObjectAllocatorTestBarrier1.Reach();
-    ObjectAllocatorTestBarrier3.Reset(); //  Prepare the third barrier for re-use.
+    ObjectAllocatorTestBarrier.Reach();
 
     ASSERT((testAllocator.GetCapacity() - testAllocator.GetFreeCount()) % objCount == 0
         , "Busy object count should be a multiple of %us, but %us (%% %us) is not.%n"
         , objCount, testAllocator.GetCapacity() - testAllocator.GetFreeCount()
         , (testAllocator.GetCapacity() - testAllocator.GetFreeCount()) % objCount);
 
-    ObjectAllocatorTestBarrier2.Reach();
-    ObjectAllocatorTestBarrier1.Reset(); //  Prepare the first barrier for re-use.
+    ObjectAllocatorTestBarrier.Reach();
 
     while (tOx != nullptr)
     {
@@ -823,8 +1182,7 @@ __startup Handle ObjectAllocatorParallelAcquireTest()
         tOx = next;
     }
 
-    ObjectAllocatorTestBarrier3.Reach();
-    ObjectAllocatorTestBarrier2.Reset(); //  Prepare the second barrier for re-use.
+    ObjectAllocatorTestBarrier.Reach();
 
     return HandleResult::Okay;
 }
@@ -1088,6 +1446,34 @@ Handle TestObjectAllocator(bool const bsp)
 
         res = ThreePoolTest();
 
+        if (!res.IsOkayResult())
+            return res;
+
+        //  Batches should span pools and release them when emptied.
+
+        res = BatchTest();
+
+        if (!res.IsOkayResult())
+            return res;
+
+        //  Cache colouring should make chasing through pool heads cheaper.
+
+        res = ColouringBenchmark();
+
+        if (!res.IsOkayResult())
+            return res;
+
+        //  Shrinking should release empty pools which would otherwise be kept.
+
+        res = ShrinkTest();
+
+        if (!res.IsOkayResult())
+            return res;
+
+        //  NUMA allocators should keep objects in their home domain's chain.
+
+        res = NumaTest();
+
         if (!res.IsOkayResult())
             return res;
 
@@ -0,0 +1,299 @@
+/*
+    Copyright (c) 2015 Alexandru-Mihai Maftei. All rights reserved.
+
+
+    Developed by: Alexandru-Mihai Maftei
+    aka Vercas
+    http://vercas.com | https://github.com/vercas/Beelzebub
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal with the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+      * Redistributions of source code must retain the above copyright notice,
+        this list of conditions and the following disclaimers.
+      * Redistributions in binary form must reproduce the above copyright
+        notice, this list of conditions and the following disclaimers in the
+        documentation and/or other materials provided with the distribution.
+      * Neither the names of Alexandru-Mihai Maftei, Vercas, nor the names of
+        its contributors may be used to endorse or promote products derived from
+        this Software without specific prior written permission.
+
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+    WITH THE SOFTWARE.
+
+    ---
+
+    You may also find the text of this license in "LICENSE.md", along with a more
+    thorough explanation regarding other files.
+*/
+
+#include <synchronization/spsc_ring.hpp>
+#include <synchronization/mpsc_ring.hpp>
+#include <synchronization/mpsc_queue.hpp>
+#include <utils/unit_tests.hpp>
+
+#include <debug.hpp>
+
+using namespace Beelzebub;
+using namespace Beelzebub::Synchronization;
+using namespace Beelzebub::Utils;
+
+/*****************
+    Unit Tests
+*****************/
+
+DEFINE_TEST(Queues, SPSC Ring)
+{
+    SpscRing<size_t, 8> ring;
+    size_t item;
+
+    REQUIRE(!ring.TryPop(item), "Popped an item off an empty SPSC ring.%n");
+
+    for (size_t lap = 0; lap < 3; ++lap)
+    {
+        for (size_t i = 0; i < 8; ++i)
+            REQUIRE(ring.TryPush(lap * 8 + i), "Failed to push item %us onto an SPSC ring.%n", i);
+
+        REQUIRE(!ring.TryPush(0), "Pushed an item onto a full SPSC ring.%n");
+        REQUIRE(ring.GetCount() == 8, "SPSC ring should have 8 items, not %us.%n", ring.GetCount());
+
+        for (size_t i = 0; i < 8; ++i)
+        {
+            REQUIRE(ring.TryPop(item), "Failed to pop item %us off an SPSC ring.%n", i);
+            REQUIRE(item == lap * 8 + i, "SPSC ring gave item %us instead of %us.%n", item, lap * 8 + i);
+        }
+
+        REQUIRE(!ring.TryPop(item), "Popped an item off an emptied SPSC ring.%n");
+    }
+}
+
+DEFINE_TEST(Queues, MPSC Ring)
+{
+    MpscRing<size_t, 8> ring;
+    size_t item;
+
+    REQUIRE(!ring.TryPop(item), "Popped an item off an empty MPSC ring.%n");
+
+    for (size_t lap = 0; lap < 3; ++lap)
+    {
+        for (size_t i = 0; i < 8; ++i)
+            REQUIRE(ring.TryPush(lap * 8 + i), "Failed to push item %us onto an MPSC ring.%n", i);
+
+        REQUIRE(!ring.TryPush(0), "Pushed an item onto a full MPSC ring.%n");
+
+        for (size_t i = 0; i < 8; ++i)
+        {
+            REQUIRE(ring.TryPop(item), "Failed to pop item %us off an MPSC ring.%n", i);
+            REQUIRE(item == lap * 8 + i, "MPSC ring gave item %us instead of %us.%n", item, lap * 8 + i);
+        }
+
+        REQUIRE(!ring.TryPop(item), "Popped an item off an emptied MPSC ring.%n");
+    }
+}
+
+DEFINE_TEST(Queues, MPSC Queue)
+{
+    MpscQueue queue;
+    MpscQueueNode nodes[5];
+
+    REQUIRE(queue.IsEmpty(), "New MPSC queue is not empty.%n");
+    REQUIRE(queue.Pop() == nullptr, "Popped a node off an empty MPSC queue.%n");
+
+    for (size_t i = 0; i < 5; ++i)
+        queue.Push(nodes + i);
+
+    for (size_t i = 0; i < 5; ++i)
+    {
+        MpscQueueNode * const node = queue.Pop();
+
+        REQUIRE(node == nodes + i, "MPSC queue gave node %Xp instead of %Xp.%n", node, nodes + i);
+    }
+
+    REQUIRE(queue.Pop() == nullptr, "Popped a node off an emptied MPSC queue.%n");
+    REQUIRE(queue.IsEmpty(), "Emptied MPSC queue is not empty.%n");
+
+    queue.Push(nodes);
+    REQUIRE(queue.Pop() == nodes, "MPSC queue lost a node pushed after it was emptied.%n");
+}
+
+/****************
+    Benchmark
+****************/
+
+#if     defined(__BEELZEBUB__TEST_QUEUES) && defined(__BEELZEBUB_SETTINGS_SMP)
+
+#include <tests/queues.hpp>
+#include <system/cpu.hpp>
+#include <system/interrupts.hpp>
+
+#define QUEUES_ITEMS        ((size_t)1 << 18)
+#define QUEUES_PRODUCERS    ((size_t)16)
+#define QUEUES_NODES        ((size_t)4096)
+
+using namespace Beelzebub::System;
+
+SmpBarrier QueuesTestBarrier {};
+
+static SpscRing<size_t, 256> TestSpscRing {};
+static MpscRing<size_t, 256> TestMpscRing {};
+static MpscQueue TestMpscQueue {};
+
+struct TestNode
+{
+    MpscQueueNode Link;
+    size_t Producer;
+    size_t Index;
+};
+
+static TestNode TestNodes[QUEUES_PRODUCERS][QUEUES_NODES];
+
+static void BenchmarkSpscRing(size_t const index)
+{
+    QueuesTestBarrier.Reach();
+
+    uint64_t const start = CpuInstructions::Rdtsc();
+
+    if (index == 1)
+    {
+        for (size_t i = 0; i < QUEUES_ITEMS; ++i)
+            while (!TestSpscRing.TryPush(i))
+                CpuInstructions::DoNothing();
+    }
+    else if (index == 0)
+    {
+        size_t item;
+
+        for (size_t i = 0; i < QUEUES_ITEMS; ++i)
+        {
+            while (!TestSpscRing.TryPop(item))
+                CpuInstructions::DoNothing();
+
+            ASSERT_EQ("%us", i, item);
+        }
+
+        MSG_("SPSC ring: %u8 cycles/item.%n"
+            , (CpuInstructions::Rdtsc() - start) / QUEUES_ITEMS);
+    }
+
+    QueuesTestBarrier.Reach();
+}
+
+static void BenchmarkMpscRing(size_t const index, size_t const producers)
+{
+    size_t const perProducer = QUEUES_ITEMS / producers;
+
+    QueuesTestBarrier.Reach();
+
+    uint64_t const start = CpuInstructions::Rdtsc();
+
+    if (index != 0 && index <= producers)
+    {
+        for (size_t i = 0; i < perProducer; ++i)
+            while (!TestMpscRing.TryPush(index * QUEUES_ITEMS + i))
+                CpuInstructions::DoNothing();
+    }
+    else if (index == 0)
+    {
+        size_t expected[QUEUES_PRODUCERS + 1] = {};
+        size_t item;
+
+        for (size_t i = perProducer * producers; i > 0; --i)
+        {
+            while (!TestMpscRing.TryPop(item))
+                CpuInstructions::DoNothing();
+
+            size_t const producer = item / QUEUES_ITEMS;
+
+            ASSERT(producer >= 1 && producer <= producers, "Invalid producer %us.", producer);
+            ASSERT_EQ("%us", expected[producer], item % QUEUES_ITEMS);
+            //  Items of the same producer must arrive in order.
+
+            ++expected[producer];
+        }
+
+        MSG_("MPSC ring with %us producers: %u8 cycles/item.%n"
+            , producers, (CpuInstructions::Rdtsc() - start) / (perProducer * producers));
+    }
+
+    QueuesTestBarrier.Reach();
+}
+
+static void BenchmarkMpscQueue(size_t const index, size_t const producers)
+{
+    QueuesTestBarrier.Reach();
+
+    uint64_t const start = CpuInstructions::Rdtsc();
+
+    if (index != 0 && index <= producers)
+    {
+        TestNode * const nodes = TestNodes[index - 1];
+
+        for (size_t i = 0; i < QUEUES_NODES; ++i)
+        {
+            nodes[i].Producer = index;
+            nodes[i].Index = i;
+
+            TestMpscQueue.Push(&(nodes[i].Link));
+        }
+    }
+    else if (index == 0)
+    {
+        size_t expected[QUEUES_PRODUCERS + 1] = {};
+
+        for (size_t i = QUEUES_NODES * producers; i > 0; --i)
+        {
+            MpscQueueNode * link;
+
+            while ((link = TestMpscQueue.Pop()) == nullptr)
+                CpuInstructions::DoNothing();
+
+            TestNode * const node = reinterpret_cast<TestNode *>(link);
+
+            ASSERT_EQ("%us", expected[node->Producer], node->Index);
+
+            ++expected[node->Producer];
+        }
+
+        ASSERT(TestMpscQueue.IsEmpty(), "MPSC queue should be empty.");
+
+        MSG_("MPSC queue with %us producers: %u8 cycles/item.%n"
+            , producers, (CpuInstructions::Rdtsc() - start) / (QUEUES_NODES * producers));
+    }
+
+    QueuesTestBarrier.Reach();
+}
+
+void TestQueues(bool bsp)
+{
+    size_t const index = Cpu::GetData()->Index;
+    size_t producers = Cpu::Count.Load() - 1;
+
+    if (producers > QUEUES_PRODUCERS)
+        producers = QUEUES_PRODUCERS;
+
+    QueuesTestBarrier.Reach();
+
+    if (producers == 0)
+        return;
+
+    InterruptGuard<> intGuard;
+    //  A preempted producer would stall the consumer.
+
+    BenchmarkSpscRing(index);
+    BenchmarkMpscRing(index, producers);
+    BenchmarkMpscQueue(index, producers);
+
+    (void)bsp;
+}
+
+#endif
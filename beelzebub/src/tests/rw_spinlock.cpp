@@ -41,7 +41,9 @@
 
 #include <tests/rw_spinlock.hpp>
 #include <synchronization/rw_spinlock.hpp>
+#include <synchronization/big_reader_rw_spinlock.hpp>
 #include <system/cpu.hpp>
+#include <system/interrupts.hpp>
 
 #include <debug.hpp>
 
@@ -50,37 +52,37 @@ using namespace Beelzebub::Synchronization;
 using namespace Beelzebub::System;
 using namespace Beelzebub::Terminals;
 
-SmpBarrier RwSpinlockTestBarrier1 {};
-SmpBarrier RwSpinlockTestBarrier2 {};
-SmpBarrier RwSpinlockTestBarrier3 {};
+SmpBarrier RwSpinlockTestBarrier {};
 
-RwSpinlock tLock {};
+#define RW_SPINLOCK_BENCHMARK_ITERATIONS ((size_t)100000)
 
-void TestRwSpinlock(bool bsp)
+RwSpinlock tSharedLock {};
+BigReaderRwSpinlock tBrLock {};
+
+static Atomic<uint64_t> SlowestCycles {0};
+
+template<typename TLock>
+static void TestLock(TLock & tLock, bool bsp)
 {
-    RwSpinlockTestBarrier1.Reach();
+    RwSpinlockTestBarrier.Reach();
 
     if (bsp) tLock.Reset();
 
-    RwSpinlockTestBarrier2.Reach();
-    RwSpinlockTestBarrier1.Reset();
+    RwSpinlockTestBarrier.Reach();
 
     ASSERT(!tLock.HasWriter());
     ASSERT_EQ("%us", 0UL, tLock.GetReaderCount());
 
-    RwSpinlockTestBarrier3.Reach();
-    RwSpinlockTestBarrier2.Reset();
+    RwSpinlockTestBarrier.Reach();
 
     if (bsp) tLock.AcquireAsWriter();
 
-    RwSpinlockTestBarrier1.Reach();
-    RwSpinlockTestBarrier3.Reset();
+    RwSpinlockTestBarrier.Reach();
 
     ASSERT(tLock.HasWriter());
     ASSERT_EQ("%us", 0UL, tLock.GetReaderCount());
 
-    RwSpinlockTestBarrier2.Reach();
-    RwSpinlockTestBarrier1.Reset();
+    RwSpinlockTestBarrier.Reach();
 
     if (bsp)
     {
@@ -101,14 +103,12 @@ void TestRwSpinlock(bool bsp)
         MSG("READER");
     }
 
-    RwSpinlockTestBarrier3.Reach();
-    RwSpinlockTestBarrier2.Reset();
+    RwSpinlockTestBarrier.Reach();
 
     ASSERT(!tLock.HasWriter());
     ASSERT_EQ("%us", Cpu::Count.Load() - 1UL, tLock.GetReaderCount());
 
-    RwSpinlockTestBarrier1.Reach();
-    RwSpinlockTestBarrier3.Reset();
+    RwSpinlockTestBarrier.Reach();
 
     if (Cpu::GetData()->Index == 1)
     {
@@ -122,20 +122,17 @@ void TestRwSpinlock(bool bsp)
         //  Allow the upgrade to occur.
     }
 
-    RwSpinlockTestBarrier2.Reach();
-    RwSpinlockTestBarrier1.Reset();
+    RwSpinlockTestBarrier.Reach();
 
     ASSERT(tLock.HasWriter());
     ASSERT_EQ("%us", 0UL, tLock.GetReaderCount());
 
-    RwSpinlockTestBarrier3.Reach();
-    RwSpinlockTestBarrier2.Reset();
+    RwSpinlockTestBarrier.Reach();
 
     ASSERT(!tLock.TryAcquireAsReader());
     //  All must fail, including the writer.
 
-    RwSpinlockTestBarrier1.Reach();
-    RwSpinlockTestBarrier3.Reset();
+    RwSpinlockTestBarrier.Reach();
 
     if (Cpu::GetData()->Index == 1)
     {
@@ -147,27 +144,23 @@ void TestRwSpinlock(bool bsp)
         ASSERT(!tLock.TryAcquireAsWriter());
     }
 
-    RwSpinlockTestBarrier2.Reach();
-    RwSpinlockTestBarrier1.Reset();
+    RwSpinlockTestBarrier.Reach();
 
     ASSERT(!tLock.HasWriter());
 
-    RwSpinlockTestBarrier3.Reach();
-    RwSpinlockTestBarrier2.Reset();
+    RwSpinlockTestBarrier.Reach();
 
     if (Cpu::GetData()->Index == 1)
     {
         tLock.ReleaseAsReader();
     }
 
-    RwSpinlockTestBarrier1.Reach();
-    RwSpinlockTestBarrier3.Reset();
+    RwSpinlockTestBarrier.Reach();
 
     ASSERT(!tLock.HasWriter());
     ASSERT_EQ("%us", 0UL, tLock.GetReaderCount());
 
-    RwSpinlockTestBarrier2.Reach();
-    RwSpinlockTestBarrier1.Reset();
+    RwSpinlockTestBarrier.Reach();
 
     ASSERT_EQ("%us", 0UL, tLock.GetReaderCount());
 
@@ -185,23 +178,70 @@ void TestRwSpinlock(bool bsp)
 
     ASSERT_EQ("%us", 0UL, tLock.GetReaderCount());
 
-    RwSpinlockTestBarrier3.Reach();
-    RwSpinlockTestBarrier2.Reset();
+    RwSpinlockTestBarrier.Reach();
+}
+
+template<typename TLock>
+static uint64_t ReadConcurrently(TLock & tLock, size_t const cores)
+{
+    bool const participating = Cpu::GetData()->Index < cores;
+
+    RwSpinlockTestBarrier.Reach();
 
-    // RwSpinlockTestBarrier1.Reach();
-    // RwSpinlockTestBarrier3.Reset();
+    if (participating)
+    {
+        InterruptGuard<> intGuard;
+
+        uint64_t const start = CpuInstructions::Rdtsc();
 
-    // RwSpinlockTestBarrier2.Reach();
-    // RwSpinlockTestBarrier1.Reset();
+        for (size_t i = RW_SPINLOCK_BENCHMARK_ITERATIONS; i > 0; --i)
+        {
+            tLock.AcquireAsReader();
+            tLock.ReleaseAsReader();
+        }
 
-    // RwSpinlockTestBarrier3.Reach();
-    // RwSpinlockTestBarrier2.Reset();
+        uint64_t const cycles = CpuInstructions::Rdtsc() - start;
+        uint64_t slowest = SlowestCycles.Load();
+
+        while (cycles > slowest && !SlowestCycles.CmpXchgWeak(slowest, cycles))
+            ;   //  `slowest` is refreshed by every failed exchange.
+    }
 
-    // RwSpinlockTestBarrier1.Reach();
-    // RwSpinlockTestBarrier3.Reset();
+    RwSpinlockTestBarrier.Reach();
+
+    uint64_t const slowest = SlowestCycles.Load();
+
+    ASSERT_EQ("%us", 0UL, tLock.GetReaderCount());
+
+    RwSpinlockTestBarrier.Reach();
+
+    if (Cpu::GetData()->Index == 0)
+        SlowestCycles.Store(0);
+
+    return slowest / RW_SPINLOCK_BENCHMARK_ITERATIONS;
+}
+
+void TestRwSpinlock(bool bsp)
+{
+    TestLock(tSharedLock, bsp);
+    TestLock(tBrLock, bsp);
+
+    //  Now see how readers scale on both.
+
+    size_t const coreCount = Cpu::Count.Load();
+
+    for (size_t cores = 1; cores <= coreCount; ++cores)
+    {
+        uint64_t const shared = ReadConcurrently(tSharedLock, cores);
+        uint64_t const bigReader = ReadConcurrently(tBrLock, cores);
+
+        if (bsp)
+            MSG_("R/W spinlock readers on %us core(s): %u8 cycles/acquisition "
+                "shared, %u8 cycles/acquisition big-reader.%n"
+                , cores, shared, bigReader);
+    }
 
-    // RwSpinlockTestBarrier2.Reach();
-    // RwSpinlockTestBarrier1.Reset();
+    RwSpinlockTestBarrier.Reach();
 }
 
 #endif
@@ -0,0 +1,188 @@
+/*
+    Copyright (c) 2015 Alexandru-Mihai Maftei. All rights reserved.
+
+
+    Developed by: Alexandru-Mihai Maftei
+    aka Vercas
+    http://vercas.com | https://github.com/vercas/Beelzebub
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal with the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+      * Redistributions of source code must retain the above copyright notice,
+        this list of conditions and the following disclaimers.
+      * Redistributions in binary form must reproduce the above copyright
+        notice, this list of conditions and the following disclaimers in the
+        documentation and/or other materials provided with the distribution.
+      * Neither the names of Alexandru-Mihai Maftei, Vercas, nor the names of
+        its contributors may be used to endorse or promote products derived from
+        this Software without specific prior written permission.
+
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+    WITH THE SOFTWARE.
+
+    ---
+
+    You may also find the text of this license in "LICENSE.md", along with a more
+    thorough explanation regarding other files.
+*/
+
+#if     defined(__BEELZEBUB__TEST_SEQLOCK) && defined(__BEELZEBUB_SETTINGS_SMP)
+
+#include <tests/seqlock.hpp>
+#include <synchronization/seqlock.hpp>
+#include <memory/page_allocator.hpp>
+#include <system/cpu.hpp>
+
+#include <debug.hpp>
+
+#define SEQLOCK_WRITES          ((size_t)100000)
+#define SEQLOCK_PAGES           ((size_t)10000)
+
+using namespace Beelzebub;
+using namespace Beelzebub::Memory;
+using namespace Beelzebub::Synchronization;
+using namespace Beelzebub::System;
+
+SmpBarrier SeqLockTestBarrier {};
+
+static SeqLock TestSequence {};
+static uint64_t volatile TestFirst = 0, TestSecond = 0;
+static Atomic<bool> WriterDone {false};
+
+static void WritePair()
+{
+    TestSequence.BeginWrite();
+
+    TestFirst = TestFirst + 1;
+    TestSecond = TestSecond + 1;
+
+    TestSequence.EndWrite();
+}
+
+static bool ReadPair(uint64_t & first, uint64_t & second)
+{
+    size_t const seq = TestSequence.BeginRead();
+
+    first = TestFirst;
+    second = TestSecond;
+
+    return TestSequence.RetryRead(seq);
+}
+
+void TestSeqLock(bool bsp)
+{
+    size_t const index = Cpu::GetData()->Index;
+    uint64_t first, second;
+
+    //  First, a read which overlaps a write must be retried.
+    //  The writer also overlaps its own read, so this works on a single core.
+
+    size_t const seq = TestSequence.BeginRead();
+    first = TestFirst;
+
+    SeqLockTestBarrier.Reach();
+
+    if (index == 0)
+        WritePair();
+
+    SeqLockTestBarrier.Reach();
+
+    second = TestSecond;
+
+    ASSERT(TestSequence.RetryRead(seq)
+        , "Core %us read %u8 and %u8 across a write without being asked to retry."
+        , index, first, second);
+
+    while (ReadPair(first, second)) { }
+
+    ASSERT_EQ("%u8", first, second);
+
+    SeqLockTestBarrier.Reach();
+
+    //  Then, readers must never accept a torn pair from a busy writer.
+
+    if (index == 0)
+    {
+        for (size_t i = SEQLOCK_WRITES; i > 0; --i)
+            WritePair();
+
+        WriterDone.Store(true);
+    }
+    else
+    {
+        size_t reads = 0, retries = 0;
+
+        while (!WriterDone.Load())
+        {
+            while (ReadPair(first, second))
+                ++retries;
+
+            ASSERT_EQ("%u8", first, second);
+
+            ++reads;
+        }
+
+        MSG_("Core %us: %us sequence lock reads, %us retries.%n"
+            , index, reads, retries);
+    }
+
+    SeqLockTestBarrier.Reach();
+
+    //  Finally, the page allocator's statistics must stay consistent while
+    //  pages are being allocated and freed.
+
+    PageAllocator * const alloc = Cpu::GetData()->DomainDescriptor->PhysicalAllocator;
+    PageAllocationStatistics stats;
+
+    if (index == 0)
+    {
+        WriterDone.Store(false);
+
+        SeqLockTestBarrier.Reach();
+
+        for (size_t i = SEQLOCK_PAGES; i > 0; --i)
+        {
+            PageDescriptor * desc = nullptr;
+            paddr_t const paddr = alloc->AllocatePage(desc);
+
+            ASSERT(paddr != nullpaddr && desc != nullptr
+                , "Unable to allocate physical page #%us!", SEQLOCK_PAGES - i);
+
+            Handle res = alloc->FreePageAtAddress(paddr);
+
+            ASSERT(res.IsOkayResult()
+                , "Failed to free physical page %XP: %H", paddr, res);
+        }
+
+        WriterDone.Store(true);
+    }
+    else
+    {
+        SeqLockTestBarrier.Reach();
+
+        while (!WriterDone.Load())
+        {
+            alloc->GetStatistics(stats);
+
+            ASSERT_EQ("%u8", (uint64_t)stats.FreePageCount * PageSize, (uint64_t)stats.FreeSize);
+            ASSERT_EQ("%u8", (uint64_t)stats.ReservedPageCount * PageSize, (uint64_t)stats.ReservedSize);
+        }
+    }
+
+    SeqLockTestBarrier.Reach();
+
+    (void)bsp;
+}
+
+#endif
@@ -43,6 +43,7 @@
 #include <memory/vmm.hpp>
 #include <execution/thread.hpp>
 #include <execution/thread_init.hpp>
+#include <execution/scheduler.hpp>
 #include <exceptions.hpp>
 
 #include <kernel.hpp>
@@ -121,8 +122,7 @@ void TestVas()
 
     InitializeThreadState(&testThread);
 
-    withInterrupts (false)
-        BootstrapThread.IntroduceNext(&testThread);
+    Scheduler::Enqueue(&testThread);
 }
 
 void * TestThreadCode(void *)
@@ -122,6 +122,10 @@ namespace Beelzebub
 
         MONIKER(Thread) * ActiveThread;
         MONIKER(Process) * ActiveProcess;
+
+        size_t PreemptCount;
+        bool NeedReschedule;
+        //  Used by kernel preemption, from code which cannot see the rest.
     };
 }
 
@@ -40,6 +40,7 @@
 #pragma once
 
 #include <beel/handles.h>
+#include <memory/object_allocator_statistics.h>
 
 namespace Beelzebub { namespace Memory
 {
@@ -76,6 +77,8 @@ namespace Beelzebub { namespace Memory
         obj_ind_t LastFreeObject;       //  Used for enlarging, mainly.
         //  These should be creating an alignment of up to 16 if needed.
 
+        obj_ind_t ColourOffset; //  Bytes between the header and the first object.
+
         ObjectPoolBase * Next;
         //ObjectPoolBase * Previous;
 
@@ -86,6 +89,7 @@ namespace Beelzebub { namespace Memory
             , Capacity(0)
             , FirstFreeObject(obj_ind_invalid)
             , LastFreeObject(obj_ind_invalid)
+            , ColourOffset(0)
             , Next(nullptr)
         {
 
@@ -97,15 +101,20 @@ namespace Beelzebub { namespace Memory
 
         /*  Methods  */
 
+        inline uintptr_t GetObjectsStart(const size_t headerSize) const
+        {
+            return ((uintptr_t)this) + headerSize + this->ColourOffset;
+        }
+
         inline bool Contains(const uintptr_t object, const size_t objectSize, const size_t headerSize) const
         {
-            uintptr_t start = ((uintptr_t)this) + headerSize;
+            uintptr_t start = this->GetObjectsStart(headerSize);
             return object >= start && object <= (start + (this->Capacity - 1) * objectSize);
         }
 
         inline bool Contains(const uintptr_t object, obj_ind_t & ind, const size_t objectSize, const size_t headerSize) const
         {
-            uintptr_t const start = ((uintptr_t)this) + headerSize;
+            uintptr_t const start = this->GetObjectsStart(headerSize);
 
             if likely(object >= start)
             {
@@ -124,16 +133,16 @@ namespace Beelzebub { namespace Memory
 
         inline obj_ind_t IndexOf(const uintptr_t object, const size_t objectSize, const size_t headerSize) const
         {
-            return (obj_ind_t)((object - headerSize - ((uintptr_t)this)) / objectSize);
+            return (obj_ind_t)((object - this->GetObjectsStart(headerSize)) / objectSize);
         }
 
         inline FreeObject * GetFirstFreeObject(const size_t objectSize, const size_t headerSize) const
         {
-            return (FreeObject *)(uintptr_t)((uintptr_t)this + headerSize + this->FirstFreeObject * objectSize);
+            return (FreeObject *)(uintptr_t)(this->GetObjectsStart(headerSize) + this->FirstFreeObject * objectSize);
         }
         inline FreeObject * GetLastFreeObject(const size_t objectSize, const size_t headerSize) const
         {
-            return (FreeObject *)(uintptr_t)((uintptr_t)this + headerSize + this->LastFreeObject * objectSize);
+            return (FreeObject *)(uintptr_t)(this->GetObjectsStart(headerSize) + this->LastFreeObject * objectSize);
         }
     };
 
@@ -146,6 +155,16 @@ namespace Beelzebub { namespace Memory
 
     //  Why so many parameters? So the provider can make the best decisions! :)
 
+    /**
+     *  <summary>Number of statistics shards in a multi-consumer allocator.</summary>
+     *  <remarks>
+     *  These are not per-CPU counters: a CPU updates shard `index % shards`,
+     *  so CPUs whose indexes differ by a multiple of the shard count share a
+     *  shard, and its counters are atomic.
+     *  </remarks>
+     */
+    static size_t const ObjectAllocatorStatisticsShards = 8;
+
     /// <summary>Options for controlling the way empty pools are released</summary>
     enum class PoolReleaseOptions
     {
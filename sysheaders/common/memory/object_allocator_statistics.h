@@ -0,0 +1,76 @@
+/*
+    Copyright (c) 2015 Alexandru-Mihai Maftei. All rights reserved.
+
+
+    Developed by: Alexandru-Mihai Maftei
+    aka Vercas
+    http://vercas.com | https://github.com/vercas/Beelzebub
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal with the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+      * Redistributions of source code must retain the above copyright notice,
+        this list of conditions and the following disclaimers.
+      * Redistributions in binary form must reproduce the above copyright
+        notice, this list of conditions and the following disclaimers in the
+        documentation and/or other materials provided with the distribution.
+      * Neither the names of Alexandru-Mihai Maftei, Vercas, nor the names of
+        its contributors may be used to endorse or promote products derived from
+        this Software without specific prior written permission.
+
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+    WITH THE SOFTWARE.
+
+    ---
+
+    You may also find the text of this license in "LICENSE.md", along with a more
+    thorough explanation regarding other files.
+*/
+
+#pragma once
+
+#include <metaprogramming.h>
+
+/***************************************
+    Object Allocator Statistics Table
+***************************************/
+
+#define OBJA_STATISTICS_NAME_LENGTH 32
+
+/**
+ *  <summary>One row of the object allocator statistics table.</summary>
+ */
+typedef struct
+#ifdef __cplusplus
+ObjectAllocatorStatistics
+#else
+OBJA_STATISTICS
+#endif
+{
+    char Name[OBJA_STATISTICS_NAME_LENGTH];
+
+    size_t ObjectSize;
+    size_t Capacity;
+    size_t FreeCount;
+    size_t PoolCount;
+    size_t BusyCount;
+    size_t PeakBusyCount;
+
+    uint64_t Allocations;
+    uint64_t Deallocations;
+    uint64_t PoolAcquisitions;
+    uint64_t PoolReleases;
+
+    uint64_t LinkageSpinCycles;
+    uint64_t PropertiesSpinCycles;
+} obja_stats_t;
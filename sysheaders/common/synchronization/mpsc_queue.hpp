@@ -0,0 +1,156 @@
+/*
+    Copyright (c) 2015 Alexandru-Mihai Maftei. All rights reserved.
+
+
+    Developed by: Alexandru-Mihai Maftei
+    aka Vercas
+    http://vercas.com | https://github.com/vercas/Beelzebub
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal with the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+      * Redistributions of source code must retain the above copyright notice,
+        this list of conditions and the following disclaimers.
+      * Redistributions in binary form must reproduce the above copyright
+        notice, this list of conditions and the following disclaimers in the
+        documentation and/or other materials provided with the distribution.
+      * Neither the names of Alexandru-Mihai Maftei, Vercas, nor the names of
+        its contributors may be used to endorse or promote products derived from
+        this Software without specific prior written permission.
+
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+    WITH THE SOFTWARE.
+
+    ---
+
+    You may also find the text of this license in "LICENSE.md", along with a more
+    thorough explanation regarding other files.
+*/
+
+#pragma once
+
+#include <synchronization/atomic.hpp>
+
+namespace Beelzebub { namespace Synchronization
+{
+    /**
+     *  Link embedded in the objects which go through an MPSC queue.
+     */
+    struct MpscQueueNode
+    {
+        MpscQueueNode * volatile Next;
+    };
+
+    /**
+     *  Unbounded intrusive lock-free queue with many producers and one
+     *  consumer, after Dmitry Vyukov's design. Pushing is a single exchange
+     *  and never fails or waits, so producers may be in interrupt handlers.
+     *  A producer interrupted mid-push hides the items pushed after its own
+     *  until it resumes.
+     */
+    struct MpscQueue
+    {
+    public:
+
+        /*  Constructor(s)  */
+
+        inline MpscQueue()
+            : Head(&(this->Stub))
+            , Tail(&(this->Stub))
+            , Stub({nullptr})
+        {
+
+        }
+
+        MpscQueue(MpscQueue const &) = delete;
+        MpscQueue & operator =(MpscQueue const &) = delete;
+
+        /*  Producers  */
+
+        /**
+         *  Appends the given node.
+         */
+        inline void Push(MpscQueueNode * const node)
+        {
+            __atomic_store_n(&(node->Next), nullptr, __ATOMIC_RELAXED);
+
+            MpscQueueNode * const prev = __atomic_exchange_n(&(this->Head), node, __ATOMIC_ACQ_REL);
+
+            __atomic_store_n(&(prev->Next), node, __ATOMIC_RELEASE);
+        }
+
+        /*  Consumer  */
+
+        /**
+         *  Removes the oldest node, or returns null if there is none or it
+         *  is not completely linked yet.
+         */
+        inline MpscQueueNode * Pop()
+        {
+            MpscQueueNode * tail = this->Tail;
+            MpscQueueNode * next = __atomic_load_n(&(tail->Next), __ATOMIC_ACQUIRE);
+
+            if (tail == &(this->Stub))
+            {
+                if (next == nullptr)
+                    return nullptr;
+
+                this->Tail = tail = next;
+                next = __atomic_load_n(&(next->Next), __ATOMIC_ACQUIRE);
+            }
+            //  The stub is skipped.
+
+            if (next != nullptr)
+            {
+                this->Tail = next;
+
+                return tail;
+            }
+
+            if (tail != __atomic_load_n(&(this->Head), __ATOMIC_ACQUIRE))
+                return nullptr;
+            //  A producer has exchanged the head but not linked its node yet.
+
+            this->Push(&(this->Stub));
+            //  The last node can only be taken once something follows it.
+
+            next = __atomic_load_n(&(tail->Next), __ATOMIC_ACQUIRE);
+
+            if (next != nullptr)
+            {
+                this->Tail = next;
+
+                return tail;
+            }
+
+            return nullptr;
+        }
+
+        /*  Properties  */
+
+        inline bool IsEmpty() const
+        {
+            return this->Tail == &(this->Stub)
+                && __atomic_load_n(&(this->Stub.Next), __ATOMIC_ACQUIRE) == nullptr;
+        }
+
+    private:
+
+        /*  Fields  */
+
+        MpscQueueNode * volatile Head __aligned(CacheLineSize);
+        MpscQueueNode * Tail __aligned(CacheLineSize);
+
+        MpscQueueNode Stub;
+    };
+}}
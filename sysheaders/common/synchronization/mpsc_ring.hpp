@@ -0,0 +1,154 @@
+/*
+    Copyright (c) 2015 Alexandru-Mihai Maftei. All rights reserved.
+
+
+    Developed by: Alexandru-Mihai Maftei
+    aka Vercas
+    http://vercas.com | https://github.com/vercas/Beelzebub
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal with the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+      * Redistributions of source code must retain the above copyright notice,
+        this list of conditions and the following disclaimers.
+      * Redistributions in binary form must reproduce the above copyright
+        notice, this list of conditions and the following disclaimers in the
+        documentation and/or other materials provided with the distribution.
+      * Neither the names of Alexandru-Mihai Maftei, Vercas, nor the names of
+        its contributors may be used to endorse or promote products derived from
+        this Software without specific prior written permission.
+
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+    WITH THE SOFTWARE.
+
+    ---
+
+    You may also find the text of this license in "LICENSE.md", along with a more
+    thorough explanation regarding other files.
+*/
+
+#pragma once
+
+#include <synchronization/atomic.hpp>
+
+namespace Beelzebub { namespace Synchronization
+{
+    /**
+     *  Bounded lock-free ring buffer with many producers and one consumer.
+     *  Every slot carries a sequence number which tells whether it is free,
+     *  so producers only contend on claiming slots. Nobody ever waits, so it
+     *  may be used in interrupt handlers.
+     */
+    template<typename T, size_t TCapacity>
+    struct MpscRing
+    {
+        static_assert(TCapacity > 0 && (TCapacity & (TCapacity - 1)) == 0
+            , "The capacity of a ring must be a power of two.");
+
+    public:
+
+        /*  Statics  */
+
+        static size_t const Capacity = TCapacity;
+        static size_t const Mask = TCapacity - 1;
+
+        /*  Constructor(s)  */
+
+        inline MpscRing()
+            : Tail(0)
+            , Head(0)
+        {
+            for (size_t i = 0; i < Capacity; ++i)
+                this->Cells[i].Sequence.Store(i, MemoryOrder::Relaxed);
+        }
+
+        MpscRing(MpscRing const &) = delete;
+        MpscRing & operator =(MpscRing const &) = delete;
+
+        /*  Producers  */
+
+        /**
+         *  Appends an item, unless the ring is full.
+         */
+        inline __must_check bool TryPush(T const & item)
+        {
+            size_t pos = this->Tail.Load(MemoryOrder::Relaxed);
+            Cell * cell;
+
+            while (true)
+            {
+                cell = this->Cells + (pos & Mask);
+
+                intptr_t const diff = (intptr_t)cell->Sequence.Load(MemoryOrder::Acquire) - (intptr_t)pos;
+
+                if (diff == 0)
+                {
+                    if (this->Tail.CmpXchgWeak(pos, pos + 1, MemoryOrder::Relaxed))
+                        break;
+                    //  `pos` is refreshed by every failed exchange.
+                }
+                else if (diff < 0)
+                    return false;
+                //  The slot still holds an item from the previous lap.
+                else
+                    pos = this->Tail.Load(MemoryOrder::Relaxed);
+                //  Another producer claimed this slot.
+            }
+
+            cell->Item = item;
+            cell->Sequence.Store(pos + 1, MemoryOrder::Release);
+
+            return true;
+        }
+
+        /*  Consumer  */
+
+        /**
+         *  Removes the oldest item, unless the ring is empty or the oldest
+         *  item is still being written.
+         */
+        inline __must_check bool TryPop(T & item)
+        {
+            size_t const pos = this->Head;
+            Cell * const cell = this->Cells + (pos & Mask);
+
+            if (cell->Sequence.Load(MemoryOrder::Acquire) != pos + 1)
+                return false;
+
+            item = cell->Item;
+            cell->Sequence.Store(pos + Capacity, MemoryOrder::Release);
+            //  Ready for the next lap.
+
+            this->Head = pos + 1;
+
+            return true;
+        }
+
+    private:
+
+        /*  Types  */
+
+        struct Cell
+        {
+            Atomic<size_t> Sequence;
+            T Item;
+        };
+
+        /*  Fields  */
+
+        Atomic<size_t> Tail __aligned(CacheLineSize);
+        size_t Head __aligned(CacheLineSize);
+
+        Cell Cells[TCapacity] __aligned(CacheLineSize);
+    };
+}}
@@ -0,0 +1,155 @@
+/*
+    Copyright (c) 2015 Alexandru-Mihai Maftei. All rights reserved.
+
+
+    Developed by: Alexandru-Mihai Maftei
+    aka Vercas
+    http://vercas.com | https://github.com/vercas/Beelzebub
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal with the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+      * Redistributions of source code must retain the above copyright notice,
+        this list of conditions and the following disclaimers.
+      * Redistributions in binary form must reproduce the above copyright
+        notice, this list of conditions and the following disclaimers in the
+        documentation and/or other materials provided with the distribution.
+      * Neither the names of Alexandru-Mihai Maftei, Vercas, nor the names of
+        its contributors may be used to endorse or promote products derived from
+        this Software without specific prior written permission.
+
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+    WITH THE SOFTWARE.
+
+    ---
+
+    You may also find the text of this license in "LICENSE.md", along with a more
+    thorough explanation regarding other files.
+*/
+
+#pragma once
+
+#include <synchronization/atomic.hpp>
+
+namespace Beelzebub { namespace Synchronization
+{
+    /**
+     *  Bounded lock-free ring buffer with one producer and one consumer, which
+     *  may be on different CPUs. Neither side ever waits, so both may run in
+     *  interrupt handlers, as long as each side is only used by one context
+     *  at a time.
+     */
+    template<typename T, size_t TCapacity>
+    struct SpscRing
+    {
+        static_assert(TCapacity > 0 && (TCapacity & (TCapacity - 1)) == 0
+            , "The capacity of a ring must be a power of two.");
+
+    public:
+
+        /*  Statics  */
+
+        static size_t const Capacity = TCapacity;
+        static size_t const Mask = TCapacity - 1;
+
+        /*  Constructor(s)  */
+
+        inline SpscRing()
+            : Head(0)
+            , CachedTail(0)
+            , Tail(0)
+            , CachedHead(0)
+            , Items()
+        {
+
+        }
+
+        SpscRing(SpscRing const &) = delete;
+        SpscRing & operator =(SpscRing const &) = delete;
+
+        /*  Producer  */
+
+        /**
+         *  Appends an item, unless the ring is full.
+         */
+        inline __must_check bool TryPush(T const & item)
+        {
+            size_t const tail = this->Tail.Load(MemoryOrder::Relaxed);
+
+            if unlikely(tail - this->CachedHead == Capacity)
+            {
+                this->CachedHead = this->Head.Load(MemoryOrder::Acquire);
+
+                if (tail - this->CachedHead == Capacity)
+                    return false;
+            }
+            //  The consumer's index is only read when the cached copy says
+            //  the ring is full, which keeps its cache line where it is.
+
+            this->Items[tail & Mask] = item;
+
+            this->Tail.Store(tail + 1, MemoryOrder::Release);
+
+            return true;
+        }
+
+        /*  Consumer  */
+
+        /**
+         *  Removes the oldest item, unless the ring is empty.
+         */
+        inline __must_check bool TryPop(T & item)
+        {
+            size_t const head = this->Head.Load(MemoryOrder::Relaxed);
+
+            if unlikely(head == this->CachedTail)
+            {
+                this->CachedTail = this->Tail.Load(MemoryOrder::Acquire);
+
+                if (head == this->CachedTail)
+                    return false;
+            }
+
+            item = this->Items[head & Mask];
+
+            this->Head.Store(head + 1, MemoryOrder::Release);
+
+            return true;
+        }
+
+        /*  Properties  */
+
+        /**
+         *  Gets the number of items in the ring; it may be outdated already.
+         */
+        inline size_t GetCount() const
+        {
+            return this->Tail.Load(MemoryOrder::Acquire) - this->Head.Load(MemoryOrder::Acquire);
+        }
+
+    private:
+
+        /*  Fields  */
+
+        //  Each side's index shares a cache line with its private copy of the
+        //  other side's index, and nothing else.
+
+        Atomic<size_t> Head __aligned(CacheLineSize);
+        size_t CachedTail;
+
+        Atomic<size_t> Tail __aligned(CacheLineSize);
+        size_t CachedHead;
+
+        T Items[TCapacity] __aligned(CacheLineSize);
+    };
+}}
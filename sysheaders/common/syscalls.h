@@ -51,7 +51,11 @@
     /*  Copies a chunk of memory to the target address. */ \
     ENUMINST(MemoryCopy   , SYSCALL_MEMORY_COPY   , 102, "Memory Copy"   ) \
     /*  Fills a chunk of memory with a specific byte value. */ \
-    ENUMINST(MemoryFill   , SYSCALL_MEMORY_COPY   , 103, "Memory Fill"   )
+    ENUMINST(MemoryFill   , SYSCALL_MEMORY_COPY   , 103, "Memory Fill"   ) \
+    /*  Fills a table with statistics of the kernel's object allocators. */ \
+    ENUMINST(ObjaStatistics, SYSCALL_OBJA_STATISTICS, 200, "Obja Statistics") \
+    /*  Retrieves the statistics of the physical page allocator. */ \
+    ENUMINST(PageStatistics, SYSCALL_PAGE_STATISTICS, 201, "Page Statistics")
 
 typedef
 #ifdef __cplusplus
@@ -153,6 +153,16 @@ local availableTests = List {
     "RW_SPINLOCK",
     "VAS",
     "INTERRUPT_LATENCY",
+    "LOCK_SCALING",
+    "MUTEX",
+    "QUEUES",
+    "SEQLOCK",
+    "PREEMPTION",
+    "SCHEDULER",
+    "TIMERS",
+    "CROSS_CPU",
+    "DEFERRED_WORK",
+    "TOPOLOGY",
 }
 
 for i = 1, #availableTests do availableTests[availableTests[i]] = true end
@@ -160,6 +170,7 @@ for i = 1, #availableTests do availableTests[availableTests[i]] = true end
 
 local testOptions, specialOptions = List { }, List { }
 local settSmp, settInlineSpinlocks, settUnitTests = true, true, true
+local settLockProfiling, settKernelPreemption = false, false
 local settMakeDeps = true
 
 CmdOpt "tests" "t" {
@@ -208,6 +219,22 @@ CmdOpt "inline-spinlocks" {
     Handler = function(_, val) settInlineSpinlocks = val end,
 }
 
+CmdOpt "lock-profiling" {
+    Description = "Specifies whether spinlocks record contention statistics by acquisition site; defaults to no.",
+
+    Type = "boolean",
+
+    Handler = function(_, val) settLockProfiling = val end,
+}
+
+CmdOpt "kernel-preemption" {
+    Description = "Specifies whether threads running kernel code can be preempted outside of critical sections; defaults to no.",
+
+    Type = "boolean",
+
+    Handler = function(_, val) settKernelPreemption = val end,
+}
+
 CmdOpt "unit-tests" {
     Description = "Specifies whether kernel unit tests are included in the kernel or not, or if they will be quieted; defaults to yes (included but not quieted).",
 
@@ -497,6 +524,14 @@ Project "Beelzebub" {
                 and "-D__BEELZEBUB_SETTINGS_INLINE_SPINLOCKS"
                 or "-D__BEELZEBUB_SETTINGS_NO_INLINE_SPINLOCKS")
 
+            if settLockProfiling then
+                res:Append("-D__BEELZEBUB_SETTINGS_LOCK_PROFILING")
+            end
+
+            if settKernelPreemption then
+                res:Append("-D__BEELZEBUB_SETTINGS_KERNEL_PREEMPTION")
+            end
+
             res:Append(settUnitTests
                 and "-D__BEELZEBUB_SETTINGS_UNIT_TESTS"
                 or "-D__BEELZEBUB_SETTINGS_NO_UNIT_TESTS")